@@ -0,0 +1,83 @@
+/*
+ * clockUtils
+ * Copyright (2015) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __CLOCKUTILS_BENCHMARKS_BENCHMARK_H__
+#define __CLOCKUTILS_BENCHMARKS_BENCHMARK_H__
+
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+
+namespace clockUtils {
+namespace benchmarks {
+
+	typedef std::function<void()> BenchmarkFunction;
+
+	/**
+	 * \brief all benchmarks registered in this executable, sorted by name
+	 */
+	inline std::map<std::string, BenchmarkFunction> & registry() {
+		static std::map<std::string, BenchmarkFunction> benchmarks;
+		return benchmarks;
+	}
+
+	struct Registrar {
+		Registrar(const std::string & name, const BenchmarkFunction & func) {
+			registry()[name] = func;
+		}
+	};
+
+	/**
+	 * \brief runs all benchmarks or only those whose name contains one of the arguments
+	 */
+	inline int runBenchmarks(int argc, char ** argv) {
+		for (auto & p : registry()) {
+			bool selected = argc < 2;
+			for (int i = 1; i < argc; i++) {
+				selected |= p.first.find(argv[i]) != std::string::npos;
+			}
+			if (selected) {
+				std::cout << "[ " << p.first << " ]" << std::endl;
+				p.second();
+			}
+		}
+		return 0;
+	}
+
+	/**
+	 * \brief measures the wall clock time of func in seconds
+	 */
+	inline double measure(const std::function<void()> & func) {
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		func();
+		return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+} /* namespace benchmarks */
+} /* namespace clockUtils */
+
+#define CLOCKUTILS_BENCHMARK(name) \
+	static void benchmark_##name(); \
+	static clockUtils::benchmarks::Registrar registrar_##name(#name, &benchmark_##name); \
+	static void benchmark_##name()
+
+#endif /* __CLOCKUTILS_BENCHMARKS_BENCHMARK_H__ */
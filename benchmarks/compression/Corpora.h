@@ -0,0 +1,239 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __CLOCKUTILS_BENCHMARKS_COMPRESSION_CORPORA_H__
+#define __CLOCKUTILS_BENCHMARKS_COMPRESSION_CORPORA_H__
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace clockUtils {
+namespace benchmarks {
+
+	/**
+	 * \brief file the results of the compression benchmark are written to as JSON, empty if no file was given
+	 */
+	inline std::string & jsonFile() {
+		static std::string file;
+		return file;
+	}
+
+	/**
+	 * \brief generated test data, the generators only use the raw output of std::mt19937 which is defined by the standard, so the data is the same on every platform
+	 */
+	struct Corpus {
+		std::string name;
+
+		/**
+		 * \brief the strings that are compressed one by one
+		 */
+		std::vector<std::string> inputs;
+
+		/**
+		 * \brief other data of the same kind, e.g. to train a HuffmanTable
+		 */
+		std::string sample;
+	};
+
+	namespace corpora {
+
+		/**
+		 * \brief random number in [0, n)
+		 */
+		inline uint32_t next(std::mt19937 & generator, uint32_t n) {
+			return uint32_t(generator() % n);
+		}
+
+		/**
+		 * \brief words with a frequency following Zipf's law, like natural language
+		 */
+		inline std::string english(size_t length, uint32_t seed) {
+			static const char * words[] = { "the", "of", "and", "to", "a", "in", "is", "it", "you", "that", "he", "was", "for", "on", "are", "with", "as", "his", "they", "be", "at", "one", "have", "this", "from", "or", "had", "by", "not", "word", "but", "what", "some", "we", "can", "out", "other", "were", "all", "there", "when", "up", "use", "your", "how", "said", "an", "each", "she", "which", "do", "their", "time", "if", "will", "way", "about", "many", "then", "them", "write", "would", "like", "so", "these", "her", "long", "make", "thing", "see", "him", "two", "has", "look", "more", "day", "could", "go", "come", "did", "number", "sound", "no", "most", "people", "my", "over", "know", "water", "than", "call", "first", "who", "may", "down", "side", "been", "now", "find", "compression", "library", "software", "license", "distributed" };
+			const uint32_t count = uint32_t(sizeof(words) / sizeof(words[0]));
+			std::vector<uint32_t> cumulative(count);
+			uint32_t total = 0;
+			for (uint32_t i = 0; i < count; i++) {
+				total += 100000 / (i + 1);
+				cumulative[i] = total;
+			}
+			std::mt19937 generator(seed);
+			std::string text;
+			size_t lineLength = 0;
+			bool capital = true;
+			while (text.length() < length) {
+				const uint32_t r = next(generator, total);
+				uint32_t word = 0;
+				while (cumulative[word] <= r) {
+					word++;
+				}
+				std::string w = words[word];
+				if (capital) {
+					w[0] = char(w[0] - 'a' + 'A');
+					capital = false;
+				}
+				text += w;
+				lineLength += w.length();
+				const uint32_t punctuation = next(generator, 100);
+				if (punctuation < 8) {
+					text += '.';
+					capital = true;
+				} else if (punctuation < 14) {
+					text += ',';
+				}
+				if (lineLength > 70) {
+					text += '\n';
+					lineLength = 0;
+				} else {
+					text += ' ';
+					lineLength++;
+				}
+			}
+			text.resize(length);
+			return text;
+		}
+
+		/**
+		 * \brief one JSON object of the records below
+		 */
+		inline std::string jsonRecord(std::mt19937 & generator) {
+			static const char * names[] = { "alice", "bob", "carol", "dave", "eve", "mallory", "trent", "peggy" };
+			static const char * tags[] = { "admin", "beta", "premium", "trial", "mobile", "desktop" };
+			std::string record = "{\"id\":" + std::to_string(next(generator, 1000000)) + ",\"name\":\"" + names[next(generator, 8)] + "_" + std::to_string(next(generator, 10000)) + "\",\"active\":" + (next(generator, 2) ? "true" : "false") + ",\"score\":" + std::to_string(next(generator, 1000)) + "." + std::to_string(next(generator, 10)) + ",\"tags\":[";
+			const uint32_t tagCount = next(generator, 4);
+			for (uint32_t i = 0; i < tagCount; i++) {
+				record += std::string(i ? "," : "") + "\"" + tags[next(generator, 6)] + "\"";
+			}
+			return record + "]}";
+		}
+
+		/**
+		 * \brief an array of JSON records
+		 */
+		inline std::string json(size_t length, uint32_t seed) {
+			std::mt19937 generator(seed);
+			std::string text = "[\n";
+			while (text.length() < length) {
+				text += "\t" + jsonRecord(generator) + ",\n";
+			}
+			text.resize(length);
+			return text;
+		}
+
+		/**
+		 * \brief uniformly distributed bytes that can't be compressed
+		 */
+		inline std::string random(size_t length, uint32_t seed) {
+			std::mt19937 generator(seed);
+			std::string data(length, '\0');
+			for (char & c : data) {
+				c = char(generator() & 0xFF);
+			}
+			return data;
+		}
+
+		/**
+		 * \brief slowly changing 32 bit little endian values like sensor readings or counters, most bytes are equal to their predecessors
+		 */
+		inline std::string binary(size_t length, uint32_t seed) {
+			std::mt19937 generator(seed);
+			std::string data;
+			uint32_t value = 100000;
+			while (data.length() < length) {
+				value += next(generator, 7) - 3;
+				// some gaps without data
+				const uint32_t v = (next(generator, 50) == 0) ? 0 : value;
+				for (int i = 0; i < 4; i++) {
+					data += char((v >> (8 * i)) & 0xFF);
+				}
+			}
+			data.resize(length);
+			return data;
+		}
+
+		/**
+		 * \brief short log and JSON messages between about 40 and 400 bytes like they are sent over the network
+		 */
+		inline std::vector<std::string> messages(size_t count, uint32_t seed) {
+			static const char * levels[] = { "INFO", "WARN", "ERROR", "DEBUG" };
+			std::mt19937 generator(seed);
+			std::vector<std::string> result;
+			for (size_t i = 0; i < count; i++) {
+				if (next(generator, 2)) {
+					std::string message = std::string(levels[next(generator, 4)]) + " worker-" + std::to_string(next(generator, 16)) + " handled request " + std::to_string(next(generator, 100000)) + " in " + std::to_string(next(generator, 1000)) + "ms";
+					const uint32_t details = next(generator, 4);
+					for (uint32_t j = 0; j < details; j++) {
+						message += " key" + std::to_string(j) + "=" + std::to_string(generator());
+					}
+					result.push_back(message);
+				} else {
+					std::string message = "{\"type\":\"update\",\"records\":[";
+					const uint32_t records = 1 + next(generator, 3);
+					for (uint32_t j = 0; j < records; j++) {
+						message += (j ? "," : "") + jsonRecord(generator);
+					}
+					result.push_back(message + "]}");
+				}
+			}
+			return result;
+		}
+
+		/**
+		 * \brief all corpora, the large ones have length bytes, the messages corpus has the same size in total
+		 */
+		inline std::vector<Corpus> all(size_t length) {
+			std::vector<Corpus> result;
+			Corpus corpus;
+			corpus.name = "english";
+			corpus.inputs.assign(1, english(length, 1));
+			corpus.sample = english(length, 2);
+			result.push_back(corpus);
+
+			corpus.name = "json";
+			corpus.inputs.assign(1, json(length, 1));
+			corpus.sample = json(length, 2);
+			result.push_back(corpus);
+
+			corpus.name = "random";
+			corpus.inputs.assign(1, random(length, 1));
+			corpus.sample = random(length, 2);
+			result.push_back(corpus);
+
+			corpus.name = "binary";
+			corpus.inputs.assign(1, binary(length, 1));
+			corpus.sample = binary(length, 2);
+			result.push_back(corpus);
+
+			corpus.name = "messages";
+			corpus.inputs = messages(length / 200, 1);
+			corpus.sample.clear();
+			for (const std::string & message : messages(length / 200, 2)) {
+				corpus.sample += message;
+			}
+			result.push_back(corpus);
+			return result;
+		}
+
+	} /* namespace corpora */
+
+} /* namespace benchmarks */
+} /* namespace clockUtils */
+
+#endif /* __CLOCKUTILS_BENCHMARKS_COMPRESSION_CORPORA_H__ */
@@ -0,0 +1,268 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <vector>
+
+#include "clockUtils/errors.h"
+#include "clockUtils/compression/algorithm/FSE.h"
+#include "clockUtils/compression/algorithm/HuffmanCanonical.h"
+#include "clockUtils/compression/algorithm/HuffmanContext.h"
+#include "clockUtils/compression/algorithm/HuffmanFixed.h"
+#include "clockUtils/compression/algorithm/HuffmanGeneric.h"
+#include "clockUtils/compression/algorithm/HuffmanInterleaved.h"
+#include "clockUtils/compression/algorithm/HuffmanPreset.h"
+#include "clockUtils/compression/algorithm/HuffmanTable.h"
+#include "clockUtils/compression/algorithm/HuffmanTrained.h"
+#include "clockUtils/compression/algorithm/LZ77.h"
+#include "clockUtils/compression/algorithm/LZ77Huffman.h"
+
+#include "Benchmark.h"
+#include "Corpora.h"
+
+using namespace clockUtils::compression::algorithm;
+
+namespace {
+
+	/**
+	 * \brief size of every corpus
+	 */
+	const size_t CORPUS_SIZE = 1024 * 1024;
+
+	/**
+	 * \brief every measurement is repeated until it took at least this long
+	 */
+	const double MIN_TIME = 0.2;
+
+	typedef std::function<clockUtils::ClockError(const std::string & input, char * compressed, size_t capacity, size_t & compressedLength)> CompressFunction;
+	typedef std::function<clockUtils::ClockError(const char * compressed, size_t length, char * decompressed, size_t capacity, size_t & decompressedLength)> DecompressFunction;
+
+	struct Codec {
+		std::string name;
+		std::function<size_t(size_t)> maxCompressedSize;
+		CompressFunction compress;
+		DecompressFunction decompress;
+	};
+
+	struct Timing {
+		double mbPerSecond;
+		double meanLatency;
+		double p99Latency;
+	};
+
+	struct Result {
+		std::string algorithm;
+		std::string corpus;
+		size_t inputs;
+		uint64_t inputBytes;
+		uint64_t compressedBytes;
+		bool failed;
+		Timing compress;
+		Timing decompress;
+	};
+
+	template<typename Algorithm>
+	Codec createCodec(const std::string & name) {
+		Codec codec;
+		codec.name = name;
+		codec.maxCompressedSize = &Algorithm::maxCompressedSize;
+		codec.compress = [](const std::string & input, char * compressed, size_t capacity, size_t & compressedLength) {
+			return Algorithm::compress(input.data(), input.length(), compressed, capacity, compressedLength);
+		};
+		codec.decompress = [](const char * compressed, size_t length, char * decompressed, size_t capacity, size_t & decompressedLength) {
+			return Algorithm::decompress(compressed, length, decompressed, capacity, decompressedLength);
+		};
+		return codec;
+	}
+
+	Codec createLZ77Huffman(int level) {
+		Codec codec = createCodec<LZ77Huffman>("LZ77Huffman-" + std::to_string(level));
+		codec.compress = [level](const std::string & input, char * compressed, size_t capacity, size_t & compressedLength) {
+			return LZ77Huffman::compress(input.data(), input.length(), compressed, capacity, compressedLength, level);
+		};
+		return codec;
+	}
+
+	/**
+	 * \brief HuffmanTrained with a table trained on the sample of the corpus
+	 */
+	Codec createHuffmanTrained(const std::shared_ptr<HuffmanTable> & table) {
+		Codec codec;
+		codec.name = "HuffmanTrained";
+		codec.maxCompressedSize = &HuffmanTrained::maxCompressedSize;
+		codec.compress = [table](const std::string & input, char * compressed, size_t capacity, size_t & compressedLength) {
+			return HuffmanTrained::compress(input.data(), input.length(), compressed, capacity, compressedLength, *table);
+		};
+		codec.decompress = [table](const char * compressed, size_t length, char * decompressed, size_t capacity, size_t & decompressedLength) {
+			return HuffmanTrained::decompress(compressed, length, decompressed, capacity, decompressedLength, *table);
+		};
+		return codec;
+	}
+
+	/**
+	 * \brief calls func(i) for every input until MIN_TIME passed and measures every call
+	 * returns false if a call failed
+	 */
+	bool measureCalls(size_t inputs, uint64_t bytes, const std::function<bool(size_t)> & func, Timing & timing) {
+		std::vector<double> latencies;
+		double total = 0.0;
+		size_t passes = 0;
+		while (total < MIN_TIME) {
+			for (size_t i = 0; i < inputs; i++) {
+				bool success = true;
+				const double seconds = clockUtils::benchmarks::measure([&]() {
+					success = func(i);
+				});
+				if (!success) {
+					return false;
+				}
+				latencies.push_back(seconds);
+				total += seconds;
+			}
+			passes++;
+		}
+		std::sort(latencies.begin(), latencies.end());
+		timing.mbPerSecond = double(bytes) * double(passes) / total / (1024.0 * 1024.0);
+		timing.meanLatency = total / double(latencies.size()) * 1e6;
+		timing.p99Latency = latencies[std::min(latencies.size() - 1, latencies.size() * 99 / 100)] * 1e6;
+		return true;
+	}
+
+	Result run(const Codec & codec, const clockUtils::benchmarks::Corpus & corpus) {
+		Result result;
+		result.algorithm = codec.name;
+		result.corpus = corpus.name;
+		result.inputs = corpus.inputs.size();
+		result.inputBytes = 0;
+		result.compressedBytes = 0;
+		result.failed = false;
+		result.compress = Timing();
+		result.decompress = Timing();
+
+		std::vector<std::string> compressed(corpus.inputs.size());
+		std::vector<size_t> compressedLengths(corpus.inputs.size());
+		std::vector<std::string> decompressed(corpus.inputs.size());
+		for (size_t i = 0; i < corpus.inputs.size(); i++) {
+			result.inputBytes += corpus.inputs[i].length();
+			compressed[i].resize(codec.maxCompressedSize(corpus.inputs[i].length()));
+			decompressed[i].resize(corpus.inputs[i].length() + 1);
+		}
+
+		result.failed = !measureCalls(corpus.inputs.size(), result.inputBytes, [&](size_t i) {
+			return codec.compress(corpus.inputs[i], &compressed[i][0], compressed[i].length(), compressedLengths[i]) == clockUtils::ClockError::SUCCESS;
+		}, result.compress);
+		if (result.failed) {
+			return result;
+		}
+		for (size_t length : compressedLengths) {
+			result.compressedBytes += length;
+		}
+
+		result.failed = !measureCalls(corpus.inputs.size(), result.inputBytes, [&](size_t i) {
+			size_t length = 0;
+			return codec.decompress(compressed[i].data(), compressedLengths[i], &decompressed[i][0], decompressed[i].length(), length) == clockUtils::ClockError::SUCCESS && length == corpus.inputs[i].length();
+		}, result.decompress);
+		for (size_t i = 0; i < corpus.inputs.size() && !result.failed; i++) {
+			result.failed = memcmp(decompressed[i].data(), corpus.inputs[i].data(), corpus.inputs[i].length()) != 0;
+		}
+		return result;
+	}
+
+	void printResult(const Result & result) {
+		std::cout << std::setw(22) << std::left << result.algorithm << std::setw(10) << result.corpus;
+		if (result.failed) {
+			std::cout << "failed" << std::endl;
+			return;
+		}
+		std::cout << std::right << std::fixed << std::setprecision(3) << std::setw(8) << double(result.compressedBytes) / double(result.inputBytes);
+		std::cout << std::setprecision(1) << std::setw(11) << result.compress.mbPerSecond << std::setw(11) << result.decompress.mbPerSecond;
+		std::cout << std::setprecision(2) << std::setw(12) << result.compress.meanLatency << std::setw(12) << result.compress.p99Latency << std::setw(12) << result.decompress.meanLatency << std::setw(12) << result.decompress.p99Latency << std::endl;
+	}
+
+	void writeTiming(std::ostream & out, const char * name, const Timing & timing) {
+		out << ", \"" << name << "MBps\": " << timing.mbPerSecond << ", \"" << name << "LatencyUs\": " << timing.meanLatency << ", \"" << name << "LatencyP99Us\": " << timing.p99Latency;
+	}
+
+	/**
+	 * \brief writes all results as JSON, the ratios are exact and only change if the output of an algorithm changes
+	 */
+	void writeJson(const std::string & file, const std::vector<Result> & results) {
+		std::ofstream out(file);
+		out << std::fixed << std::setprecision(3);
+		out << "{" << std::endl;
+		out << "\t\"benchmark\": \"compression\"," << std::endl;
+		out << "\t\"corpusSize\": " << CORPUS_SIZE << "," << std::endl;
+		out << "\t\"results\": [" << std::endl;
+		for (size_t i = 0; i < results.size(); i++) {
+			const Result & result = results[i];
+			out << "\t\t{ \"algorithm\": \"" << result.algorithm << "\", \"corpus\": \"" << result.corpus << "\", \"inputs\": " << result.inputs << ", \"inputBytes\": " << result.inputBytes << ", \"failed\": " << (result.failed ? "true" : "false");
+			if (!result.failed) {
+				out << ", \"compressedBytes\": " << result.compressedBytes << ", \"ratio\": " << std::setprecision(6) << double(result.compressedBytes) / double(result.inputBytes) << std::setprecision(3);
+				writeTiming(out, "compress", result.compress);
+				writeTiming(out, "decompress", result.decompress);
+			}
+			out << " }" << ((i + 1 < results.size()) ? "," : "") << std::endl;
+		}
+		out << "\t]" << std::endl;
+		out << "}" << std::endl;
+		if (!out.good()) {
+			std::cerr << "can't write " << file << std::endl;
+		}
+	}
+
+} /* namespace */
+
+// ratio, throughput in MB/s and latency per call in microseconds of every algorithm for every corpus
+CLOCKUTILS_BENCHMARK(Compression) {
+	const std::vector<clockUtils::benchmarks::Corpus> corpora = clockUtils::benchmarks::corpora::all(CORPUS_SIZE);
+
+	std::cout << std::setw(22) << std::left << "algorithm" << std::setw(10) << "corpus" << std::right << std::setw(8) << "ratio" << std::setw(11) << "comp MB/s" << std::setw(11) << "dec MB/s" << std::setw(12) << "comp us" << std::setw(12) << "comp p99" << std::setw(12) << "dec us" << std::setw(12) << "dec p99" << std::endl;
+	std::vector<Result> results;
+	for (const clockUtils::benchmarks::Corpus & corpus : corpora) {
+		std::shared_ptr<HuffmanTable> table = std::make_shared<HuffmanTable>();
+		table->addSample(corpus.sample);
+		table->train();
+
+		std::vector<Codec> codecs;
+		codecs.push_back(createCodec<FSE>("FSE"));
+		codecs.push_back(createCodec<HuffmanCanonical>("HuffmanCanonical"));
+		codecs.push_back(createCodec<HuffmanContext>("HuffmanContext"));
+		codecs.push_back(createCodec<HuffmanFixed>("HuffmanFixed"));
+		codecs.push_back(createCodec<HuffmanGeneric>("HuffmanGeneric"));
+		codecs.push_back(createCodec<HuffmanInterleaved>("HuffmanInterleaved"));
+		codecs.push_back(createCodec<HuffmanPreset>("HuffmanPreset"));
+		codecs.push_back(createHuffmanTrained(table));
+		codecs.push_back(createCodec<LZ77>("LZ77"));
+		codecs.push_back(createLZ77Huffman(LZ77Huffman::MIN_LEVEL));
+		codecs.push_back(createLZ77Huffman(LZ77Huffman::DEFAULT_LEVEL));
+		codecs.push_back(createLZ77Huffman(LZ77Huffman::MAX_LEVEL));
+
+		for (const Codec & codec : codecs) {
+			results.push_back(run(codec, corpus));
+			printResult(results.back());
+		}
+	}
+	if (!clockUtils::benchmarks::jsonFile().empty()) {
+		writeJson(clockUtils::benchmarks::jsonFile(), results);
+	}
+}
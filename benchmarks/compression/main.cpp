@@ -0,0 +1,37 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cstring>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Corpora.h"
+
+int main(int argc, char ** argv) {
+	// --json file writes the results to file, all other arguments select the benchmarks
+	std::vector<char *> arguments;
+	for (int i = 0; i < argc; i++) {
+		if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+			clockUtils::benchmarks::jsonFile() = argv[++i];
+		} else {
+			arguments.push_back(argv[i]);
+		}
+	}
+	return clockUtils::benchmarks::runBenchmarks(int(arguments.size()), arguments.data());
+}
@@ -0,0 +1,124 @@
+/*
+ * clockUtils
+ * Copyright (2015) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <iomanip>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "clockUtils/container/ConcurrentPriorityQueue.h"
+
+#include "Benchmark.h"
+
+using namespace clockUtils::container;
+
+namespace {
+
+	const int OPERATIONS = 1 << 20;
+	const int PREFILL = 1 << 16;
+
+	/**
+	 * \brief the usual approach to compare with, a heap behind a mutex
+	 */
+	class MutexHeap {
+	public:
+		void push(uint64_t value) {
+			std::lock_guard<std::mutex> lg(_mutex);
+			_queue.push(value);
+		}
+		bool tryPopMin(uint64_t & value) {
+			std::lock_guard<std::mutex> lg(_mutex);
+			if (_queue.empty()) {
+				return false;
+			}
+			value = _queue.top();
+			_queue.pop();
+			return true;
+		}
+
+	private:
+		std::mutex _mutex;
+		std::priority_queue<uint64_t, std::vector<uint64_t>, std::greater<uint64_t>> _queue;
+	};
+
+	bool tryPopMin(MutexHeap & queue, uint64_t & value) {
+		return queue.tryPopMin(value);
+	}
+
+	bool tryPopMin(ConcurrentPriorityQueue<uint64_t> & queue, uint64_t & value) {
+		return queue.tryPopMin(value) == clockUtils::ClockError::SUCCESS;
+	}
+
+	template<typename Queue>
+	void worker(Queue * queue, int amount, unsigned int seed) {
+		std::mt19937_64 generator(seed);
+		uint64_t value;
+		for (int i = 0; i < amount; i++) {
+			queue->push(generator());
+			tryPopMin(*queue, value);
+		}
+	}
+
+	template<typename Queue>
+	void run(Queue & queue, int threads) {
+		std::mt19937_64 generator(42);
+		for (int i = 0; i < PREFILL; i++) {
+			queue.push(generator());
+		}
+		double seconds = clockUtils::benchmarks::measure([&]() {
+			std::vector<std::thread> v;
+			for (int i = 0; i < threads; i++) {
+				v.push_back(std::thread(worker<Queue>, &queue, OPERATIONS / threads, unsigned(i)));
+			}
+			for (std::thread & t : v) {
+				t.join();
+			}
+		});
+		std::cout << std::setw(10) << std::right << std::fixed << std::setprecision(2) << (2.0 * OPERATIONS / seconds / 1e6);
+	}
+
+} /* namespace */
+
+// push + tryPopMin pairs on a prefilled queue, result in million operations per second for 1 to 32 threads
+CLOCKUTILS_BENCHMARK(ConcurrentPriorityQueue) {
+	std::cout << std::setw(28) << std::left << "Mops/s";
+	for (int threads = 1; threads <= 32; threads *= 2) {
+		std::cout << std::setw(10) << std::right << threads;
+	}
+	std::cout << std::endl;
+
+	std::cout << std::setw(28) << std::left << "std::priority_queue+mutex";
+	for (int threads = 1; threads <= 32; threads *= 2) {
+		MutexHeap queue;
+		run(queue, threads);
+	}
+	std::cout << std::endl;
+
+	const size_t relaxations[] = { 1, 2, 4 };
+	for (size_t relaxation : relaxations) {
+		std::cout << std::setw(28) << std::left << ("MultiQueue c=" + std::to_string(relaxation));
+		for (int threads = 1; threads <= 32; threads *= 2) {
+			ConcurrentPriorityQueue<uint64_t> queue(relaxation, size_t(threads));
+			run(queue, threads);
+		}
+		std::cout << std::endl;
+	}
+}
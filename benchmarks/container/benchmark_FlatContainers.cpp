@@ -0,0 +1,149 @@
+/*
+ * clockUtils
+ * Copyright (2015) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <iomanip>
+#include <map>
+#include <random>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "clockUtils/container/FlatHashMap.h"
+#include "clockUtils/container/FlatHashSet.h"
+#include "clockUtils/container/FlatMap.h"
+
+#include "Benchmark.h"
+
+using namespace clockUtils::container;
+
+namespace {
+
+	const size_t LOOKUPS = 1 << 20;
+
+	/**
+	 * \brief random keys, the first half is inserted, the second half is used for failing lookups
+	 */
+	std::vector<uint64_t> createKeys(size_t amount) {
+		std::mt19937_64 generator(42);
+		std::vector<uint64_t> keys(amount * 2);
+		for (uint64_t & key : keys) {
+			key = generator();
+		}
+		return keys;
+	}
+
+	template<typename Map>
+	void fill(Map & map, const std::vector<uint64_t> & keys, size_t amount) {
+		for (size_t i = 0; i < amount; i++) {
+			map.insert(typename Map::value_type(keys[i], keys[i]));
+		}
+	}
+
+	void fill(FlatMap<uint64_t, uint64_t> & map, const std::vector<uint64_t> & keys, size_t amount) {
+		// inserting one by one is quadratic, flat maps are built in bulk
+		std::vector<std::pair<uint64_t, uint64_t>> values;
+		values.reserve(amount);
+		for (size_t i = 0; i < amount; i++) {
+			values.push_back(std::make_pair(keys[i], keys[i]));
+		}
+		map = FlatMap<uint64_t, uint64_t>(std::move(values));
+	}
+
+	template<typename Set>
+	void fillSet(Set & set, const std::vector<uint64_t> & keys, size_t amount) {
+		for (size_t i = 0; i < amount; i++) {
+			set.insert(keys[i]);
+		}
+	}
+
+	void printHeader(const char * title) {
+		std::cout << std::setw(24) << std::left << title << std::setw(10) << std::right << "n" << std::setw(12) << "insert" << std::setw(12) << "hit" << std::setw(12) << "miss" << std::setw(12) << "iterate" << std::endl;
+	}
+
+	/**
+	 * \brief prints nanoseconds per insert, successful lookup, failing lookup and per element when iterating
+	 */
+	template<typename Container, typename FillFunc>
+	void run(const char * name, size_t amount, const std::vector<uint64_t> & keys, FillFunc fillFunc) {
+		Container container;
+		const double insert = clockUtils::benchmarks::measure([&]() {
+			fillFunc(container, keys, amount);
+		});
+		std::mt19937_64 generator(23);
+		std::uniform_int_distribution<size_t> dist(0, amount - 1);
+		std::vector<uint64_t> hits(LOOKUPS);
+		std::vector<uint64_t> misses(LOOKUPS);
+		for (size_t i = 0; i < LOOKUPS; i++) {
+			hits[i] = keys[dist(generator)];
+			misses[i] = keys[amount + dist(generator)];
+		}
+		size_t found = 0;
+		const double hit = clockUtils::benchmarks::measure([&]() {
+			for (uint64_t key : hits) {
+				found += container.count(key);
+			}
+		});
+		const double miss = clockUtils::benchmarks::measure([&]() {
+			for (uint64_t key : misses) {
+				found += container.count(key);
+			}
+		});
+		size_t elements = 0;
+		const double iterate = clockUtils::benchmarks::measure([&]() {
+			for (const auto & value : container) {
+				(void) value;
+				elements++;
+			}
+		});
+		if (found != LOOKUPS || elements != container.size()) {
+			std::cout << "unexpected result" << std::endl;
+		}
+		std::cout << std::setw(24) << std::left << name << std::setw(10) << std::right << amount << std::fixed << std::setprecision(1);
+		std::cout << std::setw(12) << (insert * 1e9 / double(amount)) << std::setw(12) << (hit * 1e9 / LOOKUPS) << std::setw(12) << (miss * 1e9 / LOOKUPS) << std::setw(12) << (iterate * 1e9 / double(amount)) << std::endl;
+	}
+
+} /* namespace */
+
+// nanoseconds per operation for maps with 1K up to 10M uint64_t keys
+CLOCKUTILS_BENCHMARK(FlatMaps) {
+	printHeader("map ns/op");
+	for (size_t amount = 1000; amount <= 10000000; amount *= 10) {
+		const std::vector<uint64_t> keys = createKeys(amount);
+		typedef void (*MapFill)(std::map<uint64_t, uint64_t> &, const std::vector<uint64_t> &, size_t);
+		typedef void (*UnorderedFill)(std::unordered_map<uint64_t, uint64_t> &, const std::vector<uint64_t> &, size_t);
+		typedef void (*FlatFill)(FlatMap<uint64_t, uint64_t> &, const std::vector<uint64_t> &, size_t);
+		typedef void (*FlatHashFill)(FlatHashMap<uint64_t, uint64_t> &, const std::vector<uint64_t> &, size_t);
+		run<std::map<uint64_t, uint64_t>>("std::map", amount, keys, static_cast<MapFill>(fill));
+		run<FlatMap<uint64_t, uint64_t>>("FlatMap", amount, keys, static_cast<FlatFill>(fill));
+		run<std::unordered_map<uint64_t, uint64_t>>("std::unordered_map", amount, keys, static_cast<UnorderedFill>(fill));
+		run<FlatHashMap<uint64_t, uint64_t>>("FlatHashMap", amount, keys, static_cast<FlatHashFill>(fill));
+	}
+}
+
+// nanoseconds per operation for sets with 1K up to 10M uint64_t keys
+CLOCKUTILS_BENCHMARK(FlatSets) {
+	printHeader("set ns/op");
+	for (size_t amount = 1000; amount <= 10000000; amount *= 10) {
+		const std::vector<uint64_t> keys = createKeys(amount);
+		run<std::set<uint64_t>>("std::set", amount, keys, fillSet<std::set<uint64_t>>);
+		run<std::unordered_set<uint64_t>>("std::unordered_set", amount, keys, fillSet<std::unordered_set<uint64_t>>);
+		run<FlatHashSet<uint64_t>>("FlatHashSet", amount, keys, fillSet<FlatHashSet<uint64_t>>);
+	}
+}
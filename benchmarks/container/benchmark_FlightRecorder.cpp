@@ -0,0 +1,74 @@
+/*
+ * clockUtils
+ * Copyright (2015) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <iomanip>
+#include <thread>
+#include <vector>
+
+#include "clockUtils/container/FlightRecorder.h"
+
+#include "Benchmark.h"
+
+using namespace clockUtils::container;
+
+namespace {
+
+	const uint64_t EVENTS = 1 << 22;
+
+	struct Event {
+		uint64_t timestamp;
+		uint32_t thread;
+		uint32_t id;
+	};
+
+	typedef FlightRecorder<Event, 4096> Recorder;
+
+	void worker(Recorder * recorder, uint32_t thread, uint64_t amount) {
+		for (uint64_t i = 0; i < amount; i++) {
+			Event e = { i, thread, 42 };
+			recorder->record(e);
+		}
+	}
+
+} /* namespace */
+
+// nanoseconds per record() call with 1 to 8 threads recording into the same ring
+CLOCKUTILS_BENCHMARK(FlightRecorder) {
+	std::cout << std::setw(28) << std::left << "ns/record";
+	for (uint32_t threads = 1; threads <= 8; threads *= 2) {
+		std::cout << std::setw(10) << std::right << threads;
+	}
+	std::cout << std::endl;
+	std::cout << std::setw(28) << std::left << "FlightRecorder<16 byte>";
+	for (uint32_t threads = 1; threads <= 8; threads *= 2) {
+		Recorder recorder;
+		double seconds = clockUtils::benchmarks::measure([&]() {
+			std::vector<std::thread> v;
+			for (uint32_t i = 0; i < threads; i++) {
+				v.push_back(std::thread(worker, &recorder, i, EVENTS / threads));
+			}
+			for (std::thread & t : v) {
+				t.join();
+			}
+		});
+		// time per call seen by a single thread
+		std::cout << std::setw(10) << std::right << std::fixed << std::setprecision(2) << (seconds * 1e9 * threads / double(EVENTS));
+	}
+	std::cout << std::endl;
+}
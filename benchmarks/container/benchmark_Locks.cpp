@@ -0,0 +1,77 @@
+/*
+ * clockUtils
+ * Copyright (2015) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <iomanip>
+#include <thread>
+#include <vector>
+
+#include "clockUtils/container/DoubleBufferQueue.h"
+#include "clockUtils/container/Locks.h"
+
+#include "Benchmark.h"
+
+using namespace clockUtils::container;
+
+namespace {
+
+	const int OPERATIONS = 1 << 20;
+
+	template<typename Lock>
+	void pushPoll(DoubleBufferQueue<int, true, true, Lock> * queue, int amount) {
+		int value;
+		for (int i = 0; i < amount; i++) {
+			queue->push(i);
+			queue->poll(value);
+		}
+	}
+
+	template<typename Lock>
+	void runQueue(const std::string & name) {
+		std::cout << std::setw(16) << std::left << name;
+		for (int threads = 1; threads <= 32; threads *= 2) {
+			DoubleBufferQueue<int, true, true, Lock> queue;
+			double seconds = clockUtils::benchmarks::measure([&]() {
+				std::vector<std::thread> v;
+				for (int i = 0; i < threads; i++) {
+					v.push_back(std::thread(pushPoll<Lock>, &queue, OPERATIONS / threads));
+				}
+				for (std::thread & t : v) {
+					t.join();
+				}
+			});
+			std::cout << std::setw(10) << std::right << std::fixed << std::setprecision(2) << (2.0 * OPERATIONS / seconds / 1e6);
+		}
+		std::cout << std::endl;
+	}
+
+} /* namespace */
+
+// push + poll pairs on a DoubleBufferQueue, result in million operations per second for 1 to 32 threads
+CLOCKUTILS_BENCHMARK(DoubleBufferQueueLocks) {
+	std::cout << std::setw(16) << std::left << "Mops/s";
+	for (int threads = 1; threads <= 32; threads *= 2) {
+		std::cout << std::setw(10) << std::right << threads;
+	}
+	std::cout << std::endl;
+	runQueue<std::mutex>("std::mutex");
+	runQueue<SpinLock>("SpinLock");
+	runQueue<TicketLock>("TicketLock");
+	runQueue<MCSLock>("MCSLock");
+	runQueue<AdaptiveLock<>>("AdaptiveLock");
+}
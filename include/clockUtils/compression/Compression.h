@@ -25,7 +25,9 @@
 #ifndef __CLOCKUTILS_COMPRESSION_COMPRESSION_H__
 #define __CLOCKUTILS_COMPRESSION_COMPRESSION_H__
 
+#include <cstddef>
 #include <string>
+#include <utility>
 
 namespace clockUtils {
 
@@ -46,12 +48,53 @@ namespace compression {
 			return Algorithm::compress(uncompressed, compressed);
 		}
 
+		/**
+		 * \brief compresses the given string with additional parameters of the algorithm (e.g. the level of LZ77Huffman) and returns result
+		 */
+		template<typename Arg, typename... Args>
+		ClockError compress(const std::string & uncompressed, std::string & compressed, Arg && arg, Args &&... args) const {
+			return Algorithm::compress(uncompressed, compressed, std::forward<Arg>(arg), std::forward<Args>(args)...);
+		}
+
 		/**
 		 * \brief decompresses the given string and returns result
 		 */
 		ClockError decompress(const std::string & compressed, std::string & decompressed) const {
 			return Algorithm::decompress(compressed, decompressed);
 		}
+
+		/**
+		 * \brief decompresses the given string with additional parameters of the algorithm (e.g. the table of HuffmanTrained) and returns result
+		 */
+		template<typename Arg, typename... Args>
+		ClockError decompress(const std::string & compressed, std::string & decompressed, Arg && arg, Args &&... args) const {
+			return Algorithm::decompress(compressed, decompressed, std::forward<Arg>(arg), std::forward<Args>(args)...);
+		}
+
+		/**
+		 * \brief returns the maximum size of the compressed string of length bytes, a buffer of this size is always large enough for compress
+		 */
+		static size_t maxCompressedSize(size_t length) {
+			return Algorithm::maxCompressedSize(length);
+		}
+
+		/**
+		 * \brief compresses length bytes of uncompressed directly into the buffer compressed that can hold capacity bytes, additional parameters are passed to the algorithm
+		 * compressedLength is the size of the result afterwards, returns ClockError::OUT_OF_MEMORY if capacity is too small, compressedLength is the required size in this case
+		 */
+		template<typename... Args>
+		ClockError compress(const void * uncompressed, size_t length, void * compressed, size_t capacity, size_t & compressedLength, Args &&... args) const {
+			return Algorithm::compress(uncompressed, length, compressed, capacity, compressedLength, std::forward<Args>(args)...);
+		}
+
+		/**
+		 * \brief decompresses length bytes of compressed directly into the buffer decompressed that can hold capacity bytes, additional parameters are passed to the algorithm
+		 * decompressedLength is the size of the result afterwards, returns ClockError::OUT_OF_MEMORY if capacity is too small, decompressedLength is the required size in this case
+		 */
+		template<typename... Args>
+		ClockError decompress(const void * compressed, size_t length, void * decompressed, size_t capacity, size_t & decompressedLength, Args &&... args) const {
+			return Algorithm::decompress(compressed, length, decompressed, capacity, decompressedLength, std::forward<Args>(args)...);
+		}
 	};
 
 } /* namespace compression */
@@ -0,0 +1,253 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * \addtogroup compression
+ * @{
+ */
+
+#ifndef __CLOCKUTILS_COMPRESSION_FILECOMPRESSION_H__
+#define __CLOCKUTILS_COMPRESSION_FILECOMPRESSION_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "clockUtils/errors.h"
+#include "clockUtils/compression/MappedFile.h"
+#include "clockUtils/compression/ParallelCompression.h"
+#include "clockUtils/compression/StreamCompression.h"
+
+namespace clockUtils {
+namespace compression {
+
+	/**
+	 * class FileCompression
+	 *
+	 * compresses and decompresses files without reading them into a std::string
+	 * the input file is memory mapped and processed in blocks of blockSize bytes that are passed to Algorithm directly, the output is written sequentially with large writes
+	 * the compressed file uses the format of StreamCompressor, so it can also be decompressed with StreamDecompressor and vice versa
+	 * with several threads a batch of blocks is compressed or decompressed in parallel before it is written, the output doesn't depend on the amount of threads
+	 * additional parameters of the algorithm (e.g. the table of HuffmanTrained) are passed to every block
+	 */
+	template<typename Algorithm>
+	class FileCompression {
+	public:
+		/**
+		 * \brief default size of one block
+		 */
+		static const size_t DEFAULT_BLOCK_SIZE = 256 * 1024;
+
+		/**
+		 * \brief maximum size of one block
+		 */
+		static const size_t MAX_BLOCK_SIZE = StreamCompressor<Algorithm>::MAX_BLOCK_SIZE;
+
+		/**
+		 * \brief amount of blocks every thread gets per batch, the memory usage is about threads * BLOCKS_PER_THREAD * 2 * blockSize
+		 */
+		static const size_t BLOCKS_PER_THREAD = 4;
+
+		/**
+		 * \brief creates a compressor using threads threads, 0 uses one thread per core
+		 * a blockSize of 0 or above MAX_BLOCK_SIZE is clamped to the valid range
+		 */
+		explicit FileCompression(size_t threads = 1, size_t blockSize = DEFAULT_BLOCK_SIZE) : _threads(threads), _blockSize(std::min(std::max(blockSize, size_t(1)), size_t(MAX_BLOCK_SIZE))) {
+			if (_threads == 0) {
+				_threads = std::max(size_t(std::thread::hardware_concurrency()), size_t(1));
+			}
+		}
+
+		/**
+		 * \brief compresses inputFile and writes the result to outputFile
+		 * returns ClockError::FILENOTFOUND if one of the files can't be opened, outputFile is removed if an error occurs
+		 */
+		template<typename... Args>
+		ClockError compress(const std::string & inputFile, const std::string & outputFile, const Args &... args) const {
+			MappedFile input;
+			FileWriter output;
+			ClockError error = open(inputFile, outputFile, input, output);
+			if (error != ClockError::SUCCESS) {
+				return error;
+			}
+			return finish(compressBlocks(input, output, args...), outputFile, output);
+		}
+
+		/**
+		 * \brief decompresses inputFile and writes the result to outputFile
+		 * returns ClockError::FILENOTFOUND if one of the files can't be opened and ClockError::INVALID_ARGUMENT if inputFile isn't a valid compressed file, outputFile is removed if an error occurs
+		 */
+		template<typename... Args>
+		ClockError decompress(const std::string & inputFile, const std::string & outputFile, const Args &... args) const {
+			MappedFile input;
+			FileWriter output;
+			ClockError error = open(inputFile, outputFile, input, output);
+			if (error != ClockError::SUCCESS) {
+				return error;
+			}
+			return finish(decompressBlocks(input, output, args...), outputFile, output);
+		}
+
+	private:
+		size_t _threads;
+		size_t _blockSize;
+
+		static ClockError open(const std::string & inputFile, const std::string & outputFile, MappedFile & input, FileWriter & output) {
+			ClockError error = input.open(inputFile);
+			if (error != ClockError::SUCCESS) {
+				return error;
+			}
+			// truncating the mapped input would destroy it, the paths are compared by the file they refer to to catch other spellings and links
+			if (input.isSameFile(outputFile)) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			return output.open(outputFile);
+		}
+
+		/**
+		 * \brief closes the output file and removes it again if an error occured
+		 */
+		static ClockError finish(ClockError error, const std::string & outputFile, FileWriter & output) {
+			const ClockError closeError = output.close();
+			if (error == ClockError::SUCCESS) {
+				error = closeError;
+			}
+			if (error != ClockError::SUCCESS) {
+				std::remove(outputFile.c_str());
+			}
+			return error;
+		}
+
+		template<typename... Args>
+		ClockError compressBlocks(const MappedFile & input, FileWriter & output, const Args &... args) const {
+			char header[stream::SIZE_BYTES];
+			stream::writeSize(uint32_t(_blockSize), header);
+			ClockError error = output.write(header, stream::SIZE_BYTES);
+
+			const size_t blocks = (input.size() + _blockSize - 1) / _blockSize;
+			const size_t batch = _threads * BLOCKS_PER_THREAD;
+			// every frame is compressed behind its size, so it can be written at once
+			std::vector<std::string> frames(std::min(batch, blocks));
+			for (size_t first = 0; first < blocks && error == ClockError::SUCCESS; first += batch) {
+				const size_t count = std::min(batch, blocks - first);
+				error = parallel::forEachBlock(_threads, count, [&](size_t i) -> ClockError {
+					const size_t begin = (first + i) * _blockSize;
+					const size_t length = std::min(_blockSize, input.size() - begin);
+					const size_t capacity = Algorithm::maxCompressedSize(length);
+					std::string & frame = frames[i];
+					frame.resize(stream::SIZE_BYTES + capacity);
+					size_t size = 0;
+					ClockError result = Algorithm::compress(input.data() + begin, length, &frame[stream::SIZE_BYTES], capacity, size, args...);
+					if (result != ClockError::SUCCESS) {
+						return result;
+					}
+					if (size > stream::maxFrameSize<Algorithm>(_blockSize)) {
+						return ClockError::INVALID_ARGUMENT;
+					}
+					stream::writeSize(uint32_t(size), &frame[0]);
+					frame.resize(stream::SIZE_BYTES + size);
+					return ClockError::SUCCESS;
+				});
+				for (size_t i = 0; i < count && error == ClockError::SUCCESS; i++) {
+					error = output.write(frames[i].c_str(), frames[i].length());
+				}
+			}
+			if (error != ClockError::SUCCESS) {
+				return error;
+			}
+			char end[stream::SIZE_BYTES];
+			stream::writeSize(0, end);
+			return output.write(end, stream::SIZE_BYTES);
+		}
+
+		template<typename... Args>
+		ClockError decompressBlocks(const MappedFile & input, FileWriter & output, const Args &... args) const {
+			const char * data = input.data();
+			const size_t size = input.size();
+			if (size < stream::SIZE_BYTES) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			const size_t blockSize = stream::readSize(data);
+			if (blockSize == 0 || blockSize > MAX_BLOCK_SIZE) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+
+			const size_t batch = _threads * BLOCKS_PER_THREAD;
+			std::vector<size_t> offsets;
+			std::vector<size_t> sizes;
+			std::vector<std::string> blocks(batch);
+			size_t pos = stream::SIZE_BYTES;
+			bool finished = false;
+			while (!finished) {
+				// the frame sizes are read in advance, so the frames of one batch can be decompressed in parallel
+				offsets.clear();
+				sizes.clear();
+				while (offsets.size() < batch) {
+					if (size - pos < stream::SIZE_BYTES) {
+						return ClockError::INVALID_ARGUMENT;
+					}
+					const size_t frameSize = stream::readSize(data + pos);
+					pos += stream::SIZE_BYTES;
+					if (frameSize == 0) {
+						finished = true;
+						break;
+					}
+					if (frameSize > stream::maxFrameSize<Algorithm>(blockSize) || frameSize > size - pos) {
+						return ClockError::INVALID_ARGUMENT;
+					}
+					offsets.push_back(pos);
+					sizes.push_back(frameSize);
+					pos += frameSize;
+				}
+				ClockError error = parallel::forEachBlock(_threads, offsets.size(), [&](size_t i) -> ClockError {
+					std::string & block = blocks[i];
+					block.resize(blockSize);
+					size_t length = 0;
+					ClockError result = Algorithm::decompress(data + offsets[i], sizes[i], &block[0], blockSize, length, args...);
+					if (result == ClockError::OUT_OF_MEMORY || (result == ClockError::SUCCESS && length == 0)) {
+						// the block is larger than the block size of the stream
+						result = ClockError::INVALID_ARGUMENT;
+					}
+					block.resize(length);
+					return result;
+				});
+				for (size_t i = 0; i < offsets.size() && error == ClockError::SUCCESS; i++) {
+					error = output.write(blocks[i].c_str(), blocks[i].length());
+				}
+				if (error != ClockError::SUCCESS) {
+					return error;
+				}
+			}
+			// there must not be data after the end of the stream
+			return (pos == size) ? ClockError::SUCCESS : ClockError::INVALID_ARGUMENT;
+		}
+	};
+
+} /* namespace compression */
+} /* namespace clockUtils */
+
+#endif /* __CLOCKUTILS_COMPRESSION_FILECOMPRESSION_H__ */
+
+/**
+ * @}
+ */
@@ -0,0 +1,165 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * \addtogroup compression
+ * @{
+ */
+
+#ifndef __CLOCKUTILS_COMPRESSION_MAPPEDFILE_H__
+#define __CLOCKUTILS_COMPRESSION_MAPPEDFILE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "clockUtils/compression/compressionParameters.h"
+
+namespace clockUtils {
+
+	enum class ClockError;
+
+namespace compression {
+
+	/**
+	 * class MappedFile
+	 *
+	 * maps a file read-only into memory, so it can be passed to the algorithms without reading it into a std::string
+	 * the kernel is told that the file is read sequentially, so it reads ahead and drops pages that were already processed
+	 */
+	class CLOCK_COMPRESSION_API MappedFile {
+	public:
+		MappedFile();
+
+		/**
+		 * \brief unmaps the file
+		 */
+		~MappedFile();
+
+		/**
+		 * \brief maps file, a previously mapped file is unmapped
+		 * returns ClockError::FILENOTFOUND if the file can't be opened and ClockError::OUT_OF_MEMORY if it can't be mapped
+		 */
+		ClockError open(const std::string & file);
+
+		/**
+		 * \brief unmaps the file
+		 */
+		void close();
+
+		/**
+		 * \brief returns true if file is the mapped file, also if it is reached by another path, a symbolic or a hard link
+		 * returns false if no file is mapped or file doesn't exist
+		 */
+		bool isSameFile(const std::string & file) const;
+
+		/**
+		 * \brief content of the file, nullptr for an empty file
+		 */
+		const char * data() const {
+			return _data;
+		}
+
+		/**
+		 * \brief size of the file in bytes
+		 */
+		size_t size() const {
+			return _size;
+		}
+
+	private:
+		const char * _data;
+		size_t _size;
+
+		/**
+		 * \brief identity of the mapped file, the device and inode on Linux and the volume serial number and file index on Windows
+		 */
+		bool _opened;
+		uint64_t _device;
+		uint64_t _index;
+
+		/**
+		 * \brief handle of the file mapping on Windows, unused on Linux
+		 */
+		void * _mapping;
+
+		/**
+		 * \brief forbidden
+		 */
+		MappedFile(const MappedFile &) = delete;
+		MappedFile & operator=(const MappedFile &) = delete;
+	};
+
+	/**
+	 * class FileWriter
+	 *
+	 * writes a file sequentially using a large buffer, so the data is passed to the system in few large writes
+	 */
+	class CLOCK_COMPRESSION_API FileWriter {
+	public:
+		/**
+		 * \brief size of the write buffer
+		 */
+		static const size_t BUFFER_SIZE = 1024 * 1024;
+
+		FileWriter();
+
+		/**
+		 * \brief closes the file
+		 */
+		~FileWriter();
+
+		/**
+		 * \brief creates or truncates file
+		 * returns ClockError::FILENOTFOUND if the file can't be created
+		 */
+		ClockError open(const std::string & file);
+
+		/**
+		 * \brief appends length bytes of data to the file
+		 * returns ClockError::UNKNOWN if writing failed, e.g. because the disk is full
+		 */
+		ClockError write(const char * data, size_t length);
+
+		/**
+		 * \brief flushes the buffer and closes the file
+		 * returns ClockError::UNKNOWN if the remaining data couldn't be written
+		 */
+		ClockError close();
+
+	private:
+		std::FILE * _file;
+		char * _buffer;
+
+		/**
+		 * \brief forbidden
+		 */
+		FileWriter(const FileWriter &) = delete;
+		FileWriter & operator=(const FileWriter &) = delete;
+	};
+
+} /* namespace compression */
+} /* namespace clockUtils */
+
+#endif /* __CLOCKUTILS_COMPRESSION_MAPPEDFILE_H__ */
+
+/**
+ * @}
+ */
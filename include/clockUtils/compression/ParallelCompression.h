@@ -0,0 +1,280 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * \addtogroup compression
+ * @{
+ */
+
+#ifndef __CLOCKUTILS_COMPRESSION_PARALLELCOMPRESSION_H__
+#define __CLOCKUTILS_COMPRESSION_PARALLELCOMPRESSION_H__
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "clockUtils/errors.h"
+
+namespace clockUtils {
+namespace compression {
+
+	/**
+	 * \brief the engine running the blocks of ParallelCompression, it can be used for other block based formats, too
+	 */
+	namespace parallel {
+
+		/**
+		 * \brief calls func(block) for every block on up to threads threads including the calling one
+		 * returns the error of the first failing block, the remaining blocks are skipped in this case
+		 */
+		template<typename Func>
+		ClockError forEachBlock(size_t threads, size_t blocks, const Func & func) {
+			std::atomic<size_t> next(0);
+			std::atomic<bool> failed(false);
+			std::mutex errorLock;
+			size_t firstFailed = blocks;
+			ClockError error = ClockError::SUCCESS;
+
+			auto worker = [&]() {
+				for (size_t block = next++; block < blocks && !failed.load(std::memory_order_relaxed); block = next++) {
+					ClockError result;
+					try {
+						result = func(block);
+					} catch (std::bad_alloc &) {
+						result = ClockError::OUT_OF_MEMORY;
+					}
+					if (result != ClockError::SUCCESS) {
+						std::lock_guard<std::mutex> lg(errorLock);
+						if (block < firstFailed) {
+							firstFailed = block;
+							error = result;
+						}
+						failed = true;
+					}
+				}
+			};
+
+			const size_t threadCount = std::min(threads, blocks);
+			std::vector<std::thread> workers;
+			try {
+				for (size_t i = 1; i < threadCount; i++) {
+					workers.push_back(std::thread(worker));
+				}
+			} catch (std::exception &) {
+				// continue with the threads that could be started
+			}
+			worker();
+			for (std::thread & t : workers) {
+				t.join();
+			}
+			return error;
+		}
+
+	} /* namespace parallel */
+
+	/**
+	 * class ParallelCompression
+	 *
+	 * compresses large strings on several threads
+	 * the input is split into independent blocks of blockSize bytes that are compressed with Algorithm, every block has its own dictionary
+	 * the output starts with the block size (4 Bytes), the length of the uncompressed string (8 Bytes) and an index containing the compressed size of every block (4 Bytes each), followed by the blocks
+	 * the output only depends on the block size, so it is identical for every amount of threads
+	 * the threads are started for every call and the blocks are handed out to them one after another, so the work stays balanced if some blocks compress faster than others
+	 */
+	template<typename Algorithm>
+	class ParallelCompression {
+	public:
+		/**
+		 * \brief default size of one block
+		 */
+		static const size_t DEFAULT_BLOCK_SIZE = 256 * 1024;
+
+		/**
+		 * \brief maximum size of one block
+		 */
+		static const size_t MAX_BLOCK_SIZE = 16 * 1024 * 1024;
+
+		/**
+		 * \brief creates a compressor using at most threads threads, 0 uses one thread per core
+		 * a blockSize of 0 or above MAX_BLOCK_SIZE is clamped to the valid range
+		 */
+		explicit ParallelCompression(size_t threads = 0, size_t blockSize = DEFAULT_BLOCK_SIZE) : _threads(threads), _blockSize(std::min(std::max(blockSize, size_t(1)), size_t(MAX_BLOCK_SIZE))) {
+			if (_threads == 0) {
+				_threads = std::max(size_t(std::thread::hardware_concurrency()), size_t(1));
+			}
+		}
+
+		/**
+		 * \brief compresses the given string and returns result
+		 */
+		ClockError compress(const std::string & uncompressed, std::string & compressed) const {
+			const size_t blocks = (uncompressed.length() + _blockSize - 1) / _blockSize;
+			std::vector<std::string> results;
+			try {
+				results.resize(blocks);
+			} catch (std::bad_alloc &) {
+				return ClockError::OUT_OF_MEMORY;
+			}
+			ClockError error = run(blocks, [&](size_t block) -> ClockError {
+				// the block is compressed directly from the input into a scratch buffer of the maximum size
+				// only the compressed bytes are kept, so the results don't hold the capacity of the worst case until the output is assembled
+				const size_t begin = block * _blockSize;
+				const size_t length = std::min(_blockSize, uncompressed.length() - begin);
+				std::string scratch(Algorithm::maxCompressedSize(length), '\0');
+				size_t size = 0;
+				ClockError err = Algorithm::compress(uncompressed.data() + begin, length, &scratch[0], scratch.length(), size);
+				if (err == ClockError::SUCCESS) {
+					results[block].assign(scratch, 0, size);
+				}
+				return err;
+			});
+			if (error != ClockError::SUCCESS) {
+				return error;
+			}
+
+			size_t size = HEADER_SIZE + blocks * INDEX_ENTRY_SIZE;
+			for (const std::string & result : results) {
+				if (result.length() > UINT32_MAX) {
+					return ClockError::INVALID_ARGUMENT;
+				}
+				size += result.length();
+			}
+			try {
+				compressed.resize(size);
+			} catch (std::bad_alloc &) {
+				return ClockError::OUT_OF_MEMORY;
+			}
+			char * out = &compressed[0];
+			writeNumber(_blockSize, 4, out);
+			writeNumber(uncompressed.length(), 8, out + 4);
+			out += HEADER_SIZE;
+			for (const std::string & result : results) {
+				writeNumber(result.length(), INDEX_ENTRY_SIZE, out);
+				out += INDEX_ENTRY_SIZE;
+			}
+			for (const std::string & result : results) {
+				memcpy(out, result.c_str(), result.length());
+				out += result.length();
+			}
+			return ClockError::SUCCESS;
+		}
+
+		/**
+		 * \brief decompresses the given string and returns result
+		 * the block size is read from the compressed string, so it doesn't need to match the one of this object
+		 */
+		ClockError decompress(const std::string & compressed, std::string & decompressed) const {
+			if (compressed.length() < HEADER_SIZE) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			const char * in = compressed.c_str();
+			const uint64_t blockSize = readNumber(in, 4);
+			const uint64_t length = readNumber(in + 4, 8);
+			if (blockSize == 0 || blockSize > MAX_BLOCK_SIZE) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			// the index has to fit into the string, this also limits the length to allocate below
+			const uint64_t blocks = length / blockSize + ((length % blockSize) ? 1 : 0);
+			if (blocks > (compressed.length() - HEADER_SIZE) / INDEX_ENTRY_SIZE) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			std::vector<size_t> offsets;
+			try {
+				offsets.resize(size_t(blocks) + 1);
+			} catch (std::bad_alloc &) {
+				return ClockError::OUT_OF_MEMORY;
+			}
+			offsets[0] = HEADER_SIZE + size_t(blocks) * INDEX_ENTRY_SIZE;
+			for (size_t i = 0; i < blocks; i++) {
+				offsets[i + 1] = offsets[i] + size_t(readNumber(in + HEADER_SIZE + i * INDEX_ENTRY_SIZE, INDEX_ENTRY_SIZE));
+				if (offsets[i + 1] > compressed.length()) {
+					return ClockError::INVALID_ARGUMENT;
+				}
+			}
+			if (offsets[size_t(blocks)] != compressed.length()) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			try {
+				decompressed.resize(size_t(length));
+			} catch (std::bad_alloc &) {
+				return ClockError::OUT_OF_MEMORY;
+			}
+
+			char * out = decompressed.empty() ? nullptr : &decompressed[0];
+			return run(size_t(blocks), [&](size_t block) -> ClockError {
+				// every block is decompressed directly into its place in the output
+				const size_t begin = block * size_t(blockSize);
+				const size_t blockLength = std::min(size_t(blockSize), size_t(length) - begin);
+				size_t size = 0;
+				ClockError error = Algorithm::decompress(in + offsets[block], offsets[block + 1] - offsets[block], out + begin, blockLength, size);
+				if (error == ClockError::OUT_OF_MEMORY) {
+					// the block is larger than stated in the header
+					return ClockError::INVALID_ARGUMENT;
+				}
+				if (error != ClockError::SUCCESS) {
+					return error;
+				}
+				return (size == blockLength) ? ClockError::SUCCESS : ClockError::INVALID_ARGUMENT;
+			});
+		}
+
+	private:
+		static const size_t HEADER_SIZE = 12;
+		static const size_t INDEX_ENTRY_SIZE = 4;
+
+		size_t _threads;
+		size_t _blockSize;
+
+		static void writeNumber(uint64_t value, size_t bytes, char * out) {
+			for (size_t i = 0; i < bytes; i++) {
+				out[i] = char(uint8_t(value >> (8 * (bytes - 1 - i))));
+			}
+		}
+
+		static uint64_t readNumber(const char * in, size_t bytes) {
+			uint64_t value = 0;
+			for (size_t i = 0; i < bytes; i++) {
+				value = (value << 8) | uint8_t(in[i]);
+			}
+			return value;
+		}
+
+		/**
+		 * \brief calls func(block) for every block on up to _threads threads
+		 */
+		template<typename Func>
+		ClockError run(size_t blocks, const Func & func) const {
+			return parallel::forEachBlock(_threads, blocks, func);
+		}
+	};
+
+} /* namespace compression */
+} /* namespace clockUtils */
+
+#endif /* __CLOCKUTILS_COMPRESSION_PARALLELCOMPRESSION_H__ */
+
+/**
+ * @}
+ */
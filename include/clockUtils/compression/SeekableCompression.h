@@ -0,0 +1,296 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * \addtogroup compression
+ * @{
+ */
+
+#ifndef __CLOCKUTILS_COMPRESSION_SEEKABLECOMPRESSION_H__
+#define __CLOCKUTILS_COMPRESSION_SEEKABLECOMPRESSION_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "clockUtils/errors.h"
+
+namespace clockUtils {
+namespace compression {
+
+	/**
+	 * class SeekableCompression
+	 *
+	 * compresses strings into independent blocks of blockSize bytes, so a range of the original string can be decompressed without decoding the whole string
+	 * the output starts with the blocks compressed with Algorithm, every block has its own dictionary
+	 * they are followed by an index containing an entry for every block (uncompressed offset (8 Bytes), compressed offset (8 Bytes), compressed size (4 Bytes))
+	 * the last 12 Bytes contain the number of blocks (4 Bytes) and the length of the uncompressed string (8 Bytes)
+	 * additional parameters of the algorithm (e.g. the table of HuffmanTrained) are passed to every block
+	 */
+	template<typename Algorithm>
+	class SeekableCompression {
+	public:
+		/**
+		 * \brief default size of one block
+		 */
+		static const size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+		/**
+		 * \brief maximum size of one block
+		 */
+		static const size_t MAX_BLOCK_SIZE = 16 * 1024 * 1024;
+
+		/**
+		 * \brief creates a compressor splitting the input into blocks of blockSize bytes
+		 * a blockSize of 0 or above MAX_BLOCK_SIZE is clamped to the valid range
+		 */
+		explicit SeekableCompression(size_t blockSize = DEFAULT_BLOCK_SIZE) : _blockSize(std::min(std::max(blockSize, size_t(1)), size_t(MAX_BLOCK_SIZE))) {
+		}
+
+		/**
+		 * \brief compresses the given string and returns result
+		 */
+		template<typename... Args>
+		ClockError compress(const std::string & uncompressed, std::string & compressed, const Args &... args) const {
+			const size_t blocks = (uncompressed.length() + _blockSize - 1) / _blockSize;
+			if (blocks > UINT32_MAX) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			std::vector<uint64_t> offsets;
+			std::vector<size_t> sizes;
+			try {
+				offsets.reserve(blocks);
+				sizes.reserve(blocks);
+				compressed.clear();
+			} catch (std::bad_alloc &) {
+				return ClockError::OUT_OF_MEMORY;
+			}
+			size_t pos = 0;
+			for (size_t block = 0; block < blocks; block++) {
+				const size_t begin = block * _blockSize;
+				const size_t length = std::min(_blockSize, uncompressed.length() - begin);
+				const size_t capacity = Algorithm::maxCompressedSize(length);
+				try {
+					compressed.resize(pos + capacity);
+				} catch (std::bad_alloc &) {
+					return ClockError::OUT_OF_MEMORY;
+				}
+				size_t size = 0;
+				ClockError error = Algorithm::compress(uncompressed.data() + begin, length, &compressed[pos], capacity, size, args...);
+				if (error != ClockError::SUCCESS) {
+					return error;
+				}
+				if (size > UINT32_MAX) {
+					return ClockError::INVALID_ARGUMENT;
+				}
+				offsets.push_back(pos);
+				sizes.push_back(size);
+				pos += size;
+			}
+
+			try {
+				compressed.resize(pos + blocks * INDEX_ENTRY_SIZE + TRAILER_SIZE);
+			} catch (std::bad_alloc &) {
+				return ClockError::OUT_OF_MEMORY;
+			}
+			char * out = &compressed[pos];
+			for (size_t block = 0; block < blocks; block++) {
+				writeNumber(block * _blockSize, 8, out);
+				writeNumber(offsets[block], 8, out + 8);
+				writeNumber(sizes[block], 4, out + 16);
+				out += INDEX_ENTRY_SIZE;
+			}
+			writeNumber(blocks, 4, out);
+			writeNumber(uncompressed.length(), 8, out + 4);
+			return ClockError::SUCCESS;
+		}
+
+		/**
+		 * \brief decompresses the given string and returns result
+		 */
+		template<typename... Args>
+		ClockError decompress(const std::string & compressed, std::string & decompressed, const Args &... args) const {
+			uint64_t length = 0;
+			ClockError error = uncompressedLength(compressed, length);
+			if (error != ClockError::SUCCESS) {
+				return error;
+			}
+			return decompressRange(compressed.data(), compressed.length(), 0, length, decompressed, args...);
+		}
+
+		/**
+		 * \brief decompresses length bytes starting at offset of the original string, only the blocks containing this range are decoded
+		 * returns ClockError::INVALID_ARGUMENT if the range exceeds the original string
+		 */
+		template<typename... Args>
+		ClockError decompressRange(const std::string & compressed, uint64_t offset, uint64_t length, std::string & decompressed, const Args &... args) const {
+			return decompressRange(compressed.data(), compressed.length(), offset, length, decompressed, args...);
+		}
+
+		/**
+		 * \brief decompresses length bytes starting at offset of the original string from the compressedLength bytes at compressed
+		 * only the index at the end and the blocks containing this range are read, so compressed can be e.g. a memory mapped file
+		 */
+		template<typename... Args>
+		ClockError decompressRange(const void * compressed, size_t compressedLength, uint64_t offset, uint64_t length, std::string & decompressed, const Args &... args) const {
+			const char * in = static_cast<const char *>(compressed);
+			uint64_t blocks = 0;
+			uint64_t total = 0;
+			ClockError error = readTrailer(in, compressedLength, blocks, total);
+			if (error != ClockError::SUCCESS) {
+				return error;
+			}
+			if (offset > total || length > total - offset) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			try {
+				decompressed.resize(size_t(length));
+			} catch (std::bad_alloc &) {
+				return ClockError::OUT_OF_MEMORY;
+			}
+			if (length == 0) {
+				return ClockError::SUCCESS;
+			}
+			const size_t indexBegin = compressedLength - TRAILER_SIZE - size_t(blocks) * INDEX_ENTRY_SIZE;
+			const char * index = in + indexBegin;
+
+			// last block starting at or before offset, the uncompressed offsets are increasing
+			size_t first = 0;
+			size_t count = size_t(blocks);
+			while (count > 0) {
+				const size_t half = count / 2;
+				if (readNumber(index + (first + half) * INDEX_ENTRY_SIZE, 8) <= offset) {
+					first += half + 1;
+					count -= half + 1;
+				} else {
+					count = half;
+				}
+			}
+			if (first == 0) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+
+			const uint64_t end = offset + length;
+			char * out = &decompressed[0];
+			std::string buffer;
+			for (size_t block = first - 1; block < blocks; block++) {
+				const char * entry = index + block * INDEX_ENTRY_SIZE;
+				const uint64_t blockBegin = readNumber(entry, 8);
+				if (blockBegin >= end) {
+					break;
+				}
+				const uint64_t blockEnd = (block + 1 < blocks) ? readNumber(entry + INDEX_ENTRY_SIZE, 8) : total;
+				const uint64_t compressedOffset = readNumber(entry + 8, 8);
+				const uint64_t compressedSize = readNumber(entry + 16, 4);
+				if (blockEnd <= blockBegin || blockEnd > total || blockEnd - blockBegin > MAX_BLOCK_SIZE || compressedOffset > indexBegin || compressedSize > indexBegin - compressedOffset) {
+					return ClockError::INVALID_ARGUMENT;
+				}
+				const size_t blockLength = size_t(blockEnd - blockBegin);
+				if (blockBegin >= offset && blockEnd <= end) {
+					// block is part of the range, so it's decompressed directly into the result
+					error = decompressBlock(in + compressedOffset, size_t(compressedSize), out + (blockBegin - offset), blockLength, args...);
+				} else {
+					try {
+						buffer.resize(blockLength);
+					} catch (std::bad_alloc &) {
+						return ClockError::OUT_OF_MEMORY;
+					}
+					error = decompressBlock(in + compressedOffset, size_t(compressedSize), &buffer[0], blockLength, args...);
+					if (error == ClockError::SUCCESS) {
+						const uint64_t copyBegin = std::max(offset, blockBegin);
+						const uint64_t copyEnd = std::min(end, blockEnd);
+						std::copy(buffer.begin() + ptrdiff_t(copyBegin - blockBegin), buffer.begin() + ptrdiff_t(copyEnd - blockBegin), out + (copyBegin - offset));
+					}
+				}
+				if (error != ClockError::SUCCESS) {
+					return error;
+				}
+			}
+			return ClockError::SUCCESS;
+		}
+
+		/**
+		 * \brief reads the length of the original string from the index of compressed
+		 */
+		static ClockError uncompressedLength(const std::string & compressed, uint64_t & length) {
+			uint64_t blocks = 0;
+			return readTrailer(compressed.data(), compressed.length(), blocks, length);
+		}
+
+	private:
+		static const size_t INDEX_ENTRY_SIZE = 20;
+		static const size_t TRAILER_SIZE = 12;
+
+		size_t _blockSize;
+
+		static void writeNumber(uint64_t value, size_t bytes, char * out) {
+			for (size_t i = 0; i < bytes; i++) {
+				out[i] = char(uint8_t(value >> (8 * (bytes - 1 - i))));
+			}
+		}
+
+		static uint64_t readNumber(const char * in, size_t bytes) {
+			uint64_t value = 0;
+			for (size_t i = 0; i < bytes; i++) {
+				value = (value << 8) | uint8_t(in[i]);
+			}
+			return value;
+		}
+
+		/**
+		 * \brief reads the number of blocks and the uncompressed length and checks that the index fits into the string
+		 */
+		static ClockError readTrailer(const char * in, size_t length, uint64_t & blocks, uint64_t & total) {
+			if (length < TRAILER_SIZE) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			blocks = readNumber(in + length - TRAILER_SIZE, 4);
+			total = readNumber(in + length - TRAILER_SIZE + 4, 8);
+			if (blocks > (length - TRAILER_SIZE) / INDEX_ENTRY_SIZE || (blocks == 0) != (total == 0) || total / MAX_BLOCK_SIZE > blocks) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			// the first block has to start at the beginning of the string
+			if (blocks > 0 && readNumber(in + length - TRAILER_SIZE - size_t(blocks) * INDEX_ENTRY_SIZE, 8) != 0) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			return ClockError::SUCCESS;
+		}
+
+		template<typename... Args>
+		static ClockError decompressBlock(const char * in, size_t size, char * out, size_t length, const Args &... args) {
+			size_t decompressedLength = 0;
+			ClockError error = Algorithm::decompress(in, size, out, length, decompressedLength, args...);
+			if (error != ClockError::SUCCESS) {
+				return error;
+			}
+			return (decompressedLength == length) ? ClockError::SUCCESS : ClockError::INVALID_ARGUMENT;
+		}
+	};
+
+} /* namespace compression */
+} /* namespace clockUtils */
+
+#endif /* __CLOCKUTILS_COMPRESSION_SEEKABLECOMPRESSION_H__ */
+
+/**
+ * @}
+ */
@@ -0,0 +1,368 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * \addtogroup compression
+ * @{
+ */
+
+#ifndef __CLOCKUTILS_COMPRESSION_STREAMCOMPRESSION_H__
+#define __CLOCKUTILS_COMPRESSION_STREAMCOMPRESSION_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <string>
+
+#include "clockUtils/errors.h"
+
+namespace clockUtils {
+namespace compression {
+
+	/**
+	 * \brief receives the output of a stream compressor or decompressor
+	 * the sink may be called several times for one block, the data is only valid during the call
+	 */
+	typedef std::function<void(const char * data, size_t length)> StreamSink;
+
+	/**
+	 * \brief helper functions for the framing of compressed streams
+	 * a stream starts with the block size (4 Bytes, big endian) followed by frames
+	 * every frame contains the size of the compressed block (4 Bytes, big endian) followed by the block compressed with Algorithm
+	 * a frame with size 0 marks the end of the stream
+	 */
+	namespace stream {
+
+		static const size_t SIZE_BYTES = 4;
+
+		inline void writeSize(uint32_t size, char * out) {
+			for (size_t i = 0; i < SIZE_BYTES; i++) {
+				out[i] = char(uint8_t(size >> (8 * (SIZE_BYTES - 1 - i))));
+			}
+		}
+
+		inline uint32_t readSize(const char * in) {
+			uint32_t size = 0;
+			for (size_t i = 0; i < SIZE_BYTES; i++) {
+				size = (size << 8) | uint8_t(in[i]);
+			}
+			return size;
+		}
+
+		/**
+		 * \brief upper bound for the size of a compressed block of a stream with the given block size
+		 */
+		template<typename Algorithm>
+		inline size_t maxFrameSize(size_t blockSize) {
+			return Algorithm::maxCompressedSize(blockSize);
+		}
+
+	} /* namespace stream */
+
+	/**
+	 * class StreamCompressor
+	 *
+	 * compresses data that is passed in chunks of arbitrary size
+	 * the input is collected into blocks of blockSize bytes, every full block is compressed with Algorithm and passed to the sink as one frame
+	 * so the memory usage only depends on the block size and not on the size of the whole stream
+	 * after the last chunk finish() has to be called to flush the last block and to terminate the stream
+	 * additional parameters of the algorithm (e.g. the table of HuffmanTrained) are passed to the constructor and used for every block, references have to be wrapped with std::cref
+	 */
+	template<typename Algorithm>
+	class StreamCompressor {
+	public:
+		/**
+		 * \brief default size of one block
+		 */
+		static const size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+		/**
+		 * \brief maximum size of one block
+		 */
+		static const size_t MAX_BLOCK_SIZE = 16 * 1024 * 1024;
+
+		/**
+		 * \brief creates a compressor passing its output to sink
+		 * a blockSize of 0 or above MAX_BLOCK_SIZE is clamped to the valid range
+		 */
+		template<typename... Args>
+		explicit StreamCompressor(const StreamSink & sink, size_t blockSize = DEFAULT_BLOCK_SIZE, const Args &... args) : _sink(sink), _compress([args...](const std::string & uncompressed, std::string & compressed) {
+			return Algorithm::compress(uncompressed, compressed, args...);
+		}), _blockSize(std::min(std::max(blockSize, size_t(1)), size_t(MAX_BLOCK_SIZE))), _block(), _compressed(), _started(false), _error(ClockError::SUCCESS) {
+		}
+
+		/**
+		 * \brief appends length bytes of data to the stream
+		 * returns INVALID_ARGUMENT if the stream was already finished or an error occured before
+		 */
+		ClockError write(const char * data, size_t length) {
+			if (_error != ClockError::SUCCESS) {
+				return _error;
+			}
+			if (!_started) {
+				writeHeader();
+			}
+			try {
+				while (length > 0) {
+					const size_t n = std::min(length, _blockSize - _block.length());
+					_block.append(data, n);
+					data += n;
+					length -= n;
+					if (_block.length() == _blockSize && !flushBlock()) {
+						return _error;
+					}
+				}
+			} catch (std::bad_alloc &) {
+				_error = ClockError::OUT_OF_MEMORY;
+			}
+			return _error;
+		}
+
+		/**
+		 * \brief appends data to the stream
+		 */
+		ClockError write(const std::string & data) {
+			return write(data.c_str(), data.length());
+		}
+
+		/**
+		 * \brief compresses the remaining data and writes the end of the stream
+		 * further calls of write or finish return INVALID_ARGUMENT
+		 */
+		ClockError finish() {
+			if (_error != ClockError::SUCCESS) {
+				return _error;
+			}
+			if (!_started) {
+				writeHeader();
+			}
+			if (!_block.empty() && !flushBlock()) {
+				return _error;
+			}
+			char end[stream::SIZE_BYTES];
+			stream::writeSize(0, end);
+			_sink(end, stream::SIZE_BYTES);
+			// release the buffers, the stream can't be continued anyway
+			std::string().swap(_block);
+			std::string().swap(_compressed);
+			_error = ClockError::INVALID_ARGUMENT;
+			return ClockError::SUCCESS;
+		}
+
+	private:
+		StreamSink _sink;
+
+		/**
+		 * \brief Algorithm::compress with the additional parameters
+		 */
+		std::function<ClockError(const std::string & uncompressed, std::string & compressed)> _compress;
+		size_t _blockSize;
+		std::string _block;
+		std::string _compressed;
+		bool _started;
+
+		/**
+		 * \brief first error that occured, INVALID_ARGUMENT after finish
+		 */
+		ClockError _error;
+
+		void writeHeader() {
+			char header[stream::SIZE_BYTES];
+			stream::writeSize(uint32_t(_blockSize), header);
+			_sink(header, stream::SIZE_BYTES);
+			_started = true;
+		}
+
+		bool flushBlock() {
+			_error = _compress(_block, _compressed);
+			if (_error != ClockError::SUCCESS) {
+				return false;
+			}
+			char size[stream::SIZE_BYTES];
+			stream::writeSize(uint32_t(_compressed.length()), size);
+			_sink(size, stream::SIZE_BYTES);
+			_sink(_compressed.c_str(), _compressed.length());
+			_block.clear();
+			return true;
+		}
+
+		/**
+		 * \brief forbidden
+		 */
+		StreamCompressor(const StreamCompressor &) = delete;
+		StreamCompressor & operator=(const StreamCompressor &) = delete;
+	};
+
+	/**
+	 * class StreamDecompressor
+	 *
+	 * decompresses a stream created by StreamCompressor using the same Algorithm
+	 * the compressed data can be passed in chunks of arbitrary size, every block is passed to the sink as soon as its frame is complete
+	 * at most one frame is buffered and every block is decoded into a buffer of the block size, so the memory usage is bounded by the block size of the stream
+	 * additional parameters of the algorithm are passed to the constructor like for StreamCompressor
+	 */
+	template<typename Algorithm>
+	class StreamDecompressor {
+	public:
+		/**
+		 * \brief creates a decompressor passing its output to sink
+		 * streams with a block size above maxBlockSize are rejected to limit the memory usage
+		 */
+		template<typename... Args>
+		explicit StreamDecompressor(const StreamSink & sink, size_t maxBlockSize = StreamCompressor<Algorithm>::MAX_BLOCK_SIZE, const Args &... args) : _sink(sink), _decompress([args...](const char * compressed, size_t length, char * decompressed, size_t capacity, size_t & decompressedLength) {
+			return Algorithm::decompress(compressed, length, decompressed, capacity, decompressedLength, args...);
+		}), _maxBlockSize(maxBlockSize), _blockSize(0), _state(State::Header), _expected(stream::SIZE_BYTES), _buffer(), _block(), _error(ClockError::SUCCESS) {
+		}
+
+		/**
+		 * \brief passes the next length bytes of the compressed stream
+		 * returns INVALID_ARGUMENT if the data isn't a valid stream or if there is data after the end of the stream
+		 */
+		ClockError write(const char * data, size_t length) {
+			if (_error != ClockError::SUCCESS) {
+				return _error;
+			}
+			try {
+				while (length > 0) {
+					if (_state == State::Finished) {
+						_error = ClockError::INVALID_ARGUMENT;
+						break;
+					}
+					const size_t n = std::min(length, _expected - _buffer.length());
+					_buffer.append(data, n);
+					data += n;
+					length -= n;
+					if (_buffer.length() == _expected && !process()) {
+						break;
+					}
+				}
+			} catch (std::bad_alloc &) {
+				_error = ClockError::OUT_OF_MEMORY;
+			}
+			return _error;
+		}
+
+		/**
+		 * \brief passes the next part of the compressed stream
+		 */
+		ClockError write(const std::string & data) {
+			return write(data.c_str(), data.length());
+		}
+
+		/**
+		 * \brief returns true if the end of the stream was reached
+		 */
+		bool finished() const {
+			return _state == State::Finished;
+		}
+
+	private:
+		enum class State {
+			Header,
+			FrameSize,
+			Frame,
+			Finished
+		};
+
+		StreamSink _sink;
+
+		/**
+		 * \brief Algorithm::decompress with the additional parameters
+		 */
+		std::function<ClockError(const char * compressed, size_t length, char * decompressed, size_t capacity, size_t & decompressedLength)> _decompress;
+		size_t _maxBlockSize;
+		size_t _blockSize;
+		State _state;
+
+		/**
+		 * \brief amount of bytes _buffer has to contain before the next step can be processed
+		 */
+		size_t _expected;
+		std::string _buffer;
+		std::string _block;
+		ClockError _error;
+
+		bool process() {
+			switch (_state) {
+			case State::Header: {
+				_blockSize = stream::readSize(_buffer.c_str());
+				if (_blockSize == 0 || _blockSize > _maxBlockSize) {
+					_error = ClockError::INVALID_ARGUMENT;
+					return false;
+				}
+				_state = State::FrameSize;
+				_expected = stream::SIZE_BYTES;
+				break;
+			}
+			case State::FrameSize: {
+				const size_t size = stream::readSize(_buffer.c_str());
+				if (size == 0) {
+					std::string().swap(_block);
+					_state = State::Finished;
+					_expected = 0;
+				} else if (size > stream::maxFrameSize<Algorithm>(_blockSize)) {
+					_error = ClockError::INVALID_ARGUMENT;
+					return false;
+				} else {
+					_state = State::Frame;
+					_expected = size;
+				}
+				break;
+			}
+			case State::Frame: {
+				// the length stored in the frame isn't trusted, a block larger than the block size of the stream is rejected before it is allocated
+				_block.resize(_blockSize);
+				size_t length = 0;
+				_error = _decompress(_buffer.data(), _buffer.length(), &_block[0], _blockSize, length);
+				if (_error == ClockError::OUT_OF_MEMORY || (_error == ClockError::SUCCESS && length == 0)) {
+					_error = ClockError::INVALID_ARGUMENT;
+				}
+				if (_error != ClockError::SUCCESS) {
+					return false;
+				}
+				_sink(_block.c_str(), length);
+				_state = State::FrameSize;
+				_expected = stream::SIZE_BYTES;
+				break;
+			}
+			default: {
+				break;
+			}
+			}
+			_buffer.clear();
+			return true;
+		}
+
+		/**
+		 * \brief forbidden
+		 */
+		StreamDecompressor(const StreamDecompressor &) = delete;
+		StreamDecompressor & operator=(const StreamDecompressor &) = delete;
+	};
+
+} /* namespace compression */
+} /* namespace clockUtils */
+
+#endif /* __CLOCKUTILS_COMPRESSION_STREAMCOMPRESSION_H__ */
+
+/**
+ * @}
+ */
@@ -0,0 +1,119 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * \addtogroup compression
+ * @{
+ */
+
+#ifndef __CLOCKUTILS_COMPRESSION_ALGORITHM_FSE_H__
+#define __CLOCKUTILS_COMPRESSION_ALGORITHM_FSE_H__
+
+#include "clockUtils/compression/algorithm/HuffmanBase.h"
+#include "clockUtils/compression/algorithm/OutputBuffer.h"
+
+namespace clockUtils {
+namespace compression {
+namespace algorithm {
+
+	/**
+	 * \brief class for entropy coding with tabled asymmetric numeral systems (Finite State Entropy)
+	 * the byte counts are normalized to a table of 2^tableLog states, every byte is encoded with a fractional amount of bits matching its probability
+	 * so strongly skewed strings compress better than with Huffman codes which need at least one bit per byte
+	 * encoding and decoding work with a single table lookup per byte and without branches, two interleaved states hide the latency of the lookups
+	 * the header contains the table size and the normalized counts (usually 20 - 150 Bytes)
+	 */
+	class CLOCK_COMPRESSION_API FSE : public HuffmanBase {
+	public:
+		/**
+		 * \brief smallest table size used for very short strings (as log2)
+		 */
+		static const uint8_t MIN_TABLE_LOG = 5;
+
+		/**
+		 * \brief largest table size (as log2), the decoding table needs 4 Bytes per state
+		 */
+		static const uint8_t MAX_TABLE_LOG = 12;
+
+		/**
+		 * \brief compresses the given string and returns result
+		 */
+		static ClockError compress(const std::string & uncompressed, std::string & compressed);
+
+		/**
+		 * \brief decompresses the given string and returns result
+		 */
+		static ClockError decompress(const std::string & compressed, std::string & decompressed);
+
+		/**
+		 * \brief returns the maximum size of the compressed string of length bytes
+		 */
+		static size_t maxCompressedSize(size_t length);
+
+		/**
+		 * \brief compresses length bytes of uncompressed into the buffer compressed that can hold capacity bytes
+		 * the size of the result isn't known in advance, so capacity should be at least maxCompressedSize(length)
+		 * compressedLength is the size of the result afterwards, returns ClockError::OUT_OF_MEMORY if capacity is too small, compressedLength is the required size in this case
+		 */
+		static ClockError compress(const void * uncompressed, size_t length, void * compressed, size_t capacity, size_t & compressedLength);
+
+		/**
+		 * \brief decompresses length bytes of compressed into the buffer decompressed that can hold capacity bytes
+		 * decompressedLength is the size of the result afterwards, returns ClockError::OUT_OF_MEMORY if capacity is too small, decompressedLength is the required size in this case
+		 */
+		static ClockError decompress(const void * compressed, size_t length, void * decompressed, size_t capacity, size_t & decompressedLength);
+
+	private:
+		static ClockError compress(const uint8_t * data, size_t length, OutputBuffer & out);
+		static ClockError decompress(const uint8_t * data, size_t length, OutputBuffer & out);
+
+		/**
+		 * \brief chooses the table size for a string of length bytes with maxSymbol as the largest byte
+		 */
+		static uint8_t optimalTableLog(len_t length, uint8_t maxSymbol);
+
+		/**
+		 * \brief scales histogram to counts summing up to 2^tableLog, every byte that occurs gets at least 1
+		 * the rounding errors are assigned to the bytes where they cost the fewest bits
+		 */
+		static void normalizeCounts(const std::vector<len_t> & histogram, len_t length, uint8_t tableLog, std::vector<uint16_t> & counts);
+
+		/**
+		 * \brief appends table log, largest used byte and the normalized counts to result
+		 * every count is stored with the amount of bits needed for the part of the table that is still left, so later counts get shorter
+		 * a count of 0 is followed by 2 bit values for further unused bytes (3 means continue) and the last count isn't stored at all
+		 */
+		static void writeCounts(const std::vector<uint16_t> & counts, uint8_t tableLog, std::string & result);
+
+		/**
+		 * \brief reads counts written with writeCounts from the size bytes of data starting at pos, pos points behind them afterwards
+		 * returns ClockError::INVALID_ARGUMENT if the header is malformed or the counts don't fill the table exactly
+		 */
+		static ClockError readCounts(const uint8_t * data, size_t size, size_t & pos, uint8_t & tableLog, std::vector<uint16_t> & counts);
+	};
+
+} /* namespace algorithm */
+} /* namespace compression */
+} /* namespace clockUtils */
+
+#endif /* __CLOCKUTILS_COMPRESSION_ALGORITHM_FSE_H__ */
+
+/**
+ * @}
+ */
@@ -25,12 +25,18 @@
 #ifndef __CLOCKUTILS_COMPRESSION_ALGORITHM_HUFFMANBASE_H__
 #define __CLOCKUTILS_COMPRESSION_ALGORITHM_HUFFMANBASE_H__
 
-#include <memory>
+#include <array>
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <vector>
 
 #include "clockUtils/compression/compressionParameters.h"
 
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
 namespace clockUtils {
 
 	enum class ClockError;
@@ -42,7 +48,7 @@ namespace algorithm {
 	 * \brief base class for Huffman compression
 	 * contains common methods and helper structures
 	 */
-	class HuffmanBase {
+	class CLOCK_COMPRESSION_API HuffmanBase {
 	protected:
 		/**
 		 * \brief type that should be used as the 'length' counter
@@ -51,14 +57,31 @@ namespace algorithm {
 		typedef uint32_t len_t;
 
 		/**
-		 * \brief represents a node in the probability tree
-		 * if left and right are both nullptr this node is a leave and c has a valid value
+		 * \brief the probability tree stored in a flat array, nodes reference each other by their index
+		 * the leaves are created first, so a tree for 256 characters has at most 511 nodes and needs no heap allocation
 		 */
-		struct Node {
-			len_t value;
-			uint8_t c;
-			std::shared_ptr<Node> left = nullptr;
-			std::shared_ptr<Node> right = nullptr;
+		struct Tree {
+			static const uint16_t MAX_NODES = 511;
+			static const uint16_t NONE = 0xFFFF;
+
+			/**
+			 * \brief represents a node in the probability tree
+			 * if left and right are both NONE this node is a leave and c has a valid value
+			 */
+			struct Node {
+				len_t value;
+				uint16_t left;
+				uint16_t right;
+				uint8_t c;
+			};
+
+			std::array<Node, MAX_NODES> nodes;
+			uint16_t size = 0;
+
+			/**
+			 * \brief index of the root node, NONE if the tree is empty
+			 */
+			uint16_t root = NONE;
 		};
 
 		/**
@@ -66,24 +89,310 @@ namespace algorithm {
 		 * header must have size 256 and values have to be between 0 and 255 (unsigned char)
 		 * if a value is zero no node is inserted into the tree and this value isn't accessible
 		 */
-		static std::shared_ptr<Node> buildTree(const std::vector<uint8_t> & header);
+		static void buildTree(const std::vector<uint8_t> & header, Tree & tree);
+
+		/**
+		 * \brief a code of the Huffman tree, stored right aligned in code
+		 */
+		struct Code {
+			uint32_t code;
+			uint8_t length;
+		};
+
+		/**
+		 * \brief lookup table to decode several bits at once
+		 * the first level is indexed with the next tableBits bits of the stream and resolves every code with at most tableBits bits
+		 * longer codes are resolved by a second level table that is referenced by the first level entry
+		 * every entry contains the symbol (or the offset of the second level table) in the upper 24 bits and the code length (or the amount of bits indexing the second level table) in the lower 6 bits
+		 * for alphabets with at most 256 symbols, a first level entry flagged with DUAL contains two symbols in bits 8 - 23, the length of the first code in bits 24 - 29 and the length of both codes in the lower 6 bits
+		 */
+		struct DecodeTable {
+			static const uint8_t TABLE_BITS = 11;
+			static const uint32_t SUBTABLE = 0x80;
+			static const uint32_t DUAL = 0x40;
+			static const uint32_t LENGTH_MASK = 0x3F;
+
+			uint8_t tableBits = 0;
+			uint8_t maxLength = 0;
+
+			/**
+			 * \brief the only symbol if the tree consists of just one leaf (maxLength is 0 in this case)
+			 */
+			uint32_t single = 0;
+			std::vector<uint32_t> entries;
+		};
+
+		/**
+		 * \brief constructs the codes of all leaves, codes has to have size 256
+		 * codes of characters not contained in the tree get length 0
+		 */
+		static void generateCodes(const Tree & tree, std::vector<Code> & codes);
+
+		/**
+		 * \brief writes bit sequences MSB first into a preallocated buffer
+		 * the bits are collected in a 64 bit register that is stored 8 bytes at once
+		 */
+		class BitWriter {
+		public:
+			/**
+			 * \brief out has to have enough space for all bits written
+			 */
+			explicit BitWriter(char * out) : _out(reinterpret_cast<uint8_t *>(out)), _buffer(0), _bits(0) {
+			}
+
+			/**
+			 * \brief appends the lower length bits of code, length has to be between 1 and 32 and the other bits of code have to be 0
+			 */
+			void write(uint32_t code, uint32_t length) {
+				const uint32_t free = 64 - _bits;
+				if (length < free) {
+					_buffer |= uint64_t(code) << (free - length);
+					_bits += length;
+				} else {
+					const uint32_t rest = length - free;
+					_buffer |= uint64_t(code) >> rest;
+					store(_buffer);
+					_buffer = (rest > 0) ? uint64_t(code) << (64 - rest) : 0;
+					_bits = rest;
+				}
+			}
+
+			/**
+			 * \brief writes the remaining bits, the last byte is padded with 0
+			 */
+			void flush() {
+				for (uint32_t i = 0; i < _bits; i += 8) {
+					*_out++ = uint8_t(_buffer >> 56);
+					_buffer <<= 8;
+				}
+				_buffer = 0;
+				_bits = 0;
+			}
+
+		private:
+			uint8_t * _out;
+			uint64_t _buffer;
+			uint32_t _bits;
+
+			void store(uint64_t value) {
+				for (int i = 0; i < 8; i++) {
+					_out[i] = uint8_t(value >> (56 - 8 * i));
+				}
+				_out += 8;
+			}
+		};
+
+		/**
+		 * \brief reads bit sequences MSB first, used to decode symbols of alphabets with more than 256 symbols that are interleaved with extra bits
+		 * a 64 bit buffer is loaded at once and consumed until it has to be refilled, bits behind the end of the data are read as 0
+		 */
+		class BitReader {
+		public:
+			BitReader(const uint8_t * data, size_t size) : _data(data), _size(size), _bitPos(0), _buffer(0), _available(0) {
+			}
+
+			/**
+			 * \brief returns the 64 bits starting at bitPos MSB aligned, bits behind the end of data are 0
+			 */
+			static uint64_t peek(const uint8_t * data, size_t size, uint64_t bitPos) {
+				const size_t pos = size_t(bitPos >> 3);
+				uint64_t buffer = 0;
+				if (pos + 8 <= size) {
+					memcpy(&buffer, data + pos, 8);
+#if defined(_MSC_VER)
+					buffer = _byteswap_uint64(buffer);
+#else
+					buffer = __builtin_bswap64(buffer);
+#endif
+				} else {
+					for (size_t i = 0; i < 8; i++) {
+						buffer = (buffer << 8) | ((pos + i < size) ? data[pos + i] : 0);
+					}
+				}
+				return buffer << (bitPos & 7);
+			}
+
+			/**
+			 * \brief makes sure the next bits bits (at most 56) can be consumed without loading again
+			 */
+			void fill(uint32_t bits) {
+				if (_available < bits) {
+					_buffer = peek(_data, _size, _bitPos);
+					_available = 64 - uint32_t(_bitPos & 7);
+				}
+			}
+
+			/**
+			 * \brief reads the next bits bits (at most 32) as a number, fill has to be called before
+			 */
+			uint32_t read(uint32_t bits) {
+				if (bits == 0) {
+					return 0;
+				}
+				const uint32_t value = uint32_t(_buffer >> (64 - bits));
+				consume(bits);
+				return value;
+			}
+
+			/**
+			 * \brief decodes the next symbol using table, fill has to be called with at least the maximum code length before
+			 * returns false if the next bits don't start with a valid code, table must not contain entries with two symbols
+			 */
+			bool decode(const DecodeTable & table, uint32_t & symbol) {
+				uint32_t entry = table.entries[size_t(_buffer >> (64 - table.tableBits))];
+				if (entry & DecodeTable::SUBTABLE) {
+					entry = table.entries[(entry >> 8) + size_t((_buffer << table.tableBits) >> (64 - (entry & DecodeTable::LENGTH_MASK)))];
+				}
+				const uint32_t length = entry & DecodeTable::LENGTH_MASK;
+				symbol = entry >> 8;
+				consume(length);
+				return length > 0;
+			}
+
+			/**
+			 * \brief amount of bits consumed so far
+			 */
+			uint64_t position() const {
+				return _bitPos;
+			}
+
+		private:
+			const uint8_t * _data;
+			size_t _size;
+			uint64_t _bitPos;
+			uint64_t _buffer;
+			uint32_t _available;
+
+			void consume(uint32_t bits) {
+				_buffer <<= bits;
+				_available -= bits;
+				_bitPos += bits;
+			}
+		};
+
+		/**
+		 * \brief computes optimal code lengths for the given histogram with no code longer than maxLength bits (package-merge)
+		 * lengths has the size of histogram afterwards, symbols with count 0 get length 0
+		 * a single used symbol gets length 1, 2^maxLength has to be at least the amount of used symbols
+		 */
+		static void buildLengths(const std::vector<len_t> & histogram, uint8_t maxLength, std::vector<uint8_t> & lengths);
+
+		/**
+		 * \brief assigns canonical codes to the given code lengths
+		 * codes of the same length are consecutive numbers in symbol order and shorter codes precede longer ones, so the lengths are enough to rebuild the codes
+		 */
+		static void buildCanonicalCodes(const std::vector<uint8_t> & lengths, std::vector<Code> & codes);
+
+		/**
+		 * \brief appends the code lengths (at most 15) to result
+		 * the amount of symbols up to the last used one is stored in 2 bytes followed by one nibble per length
+		 * a nibble 0 followed by a nibble k encodes a run of k + 1 unused symbols
+		 */
+		static void writeLengths(const std::vector<uint8_t> & lengths, std::string & result);
+
+		/**
+		 * \brief maximum amount of bytes writeLengths appends for alphabetSize symbols
+		 * every used symbol needs one nibble and every run of unused symbols between them two, so alternating symbols are the worst case
+		 */
+		static size_t maxLengthsSize(size_t alphabetSize);
+
+		/**
+		 * \brief reads code lengths written with writeLengths from the size bytes of data starting at pos, pos points behind them afterwards
+		 * lengths has size alphabetSize afterwards, returns ClockError::INVALID_ARGUMENT if the header is malformed or contains more than alphabetSize symbols
+		 */
+		static ClockError readLengths(const uint8_t * data, size_t size, size_t & pos, size_t alphabetSize, std::vector<uint8_t> & lengths);
+
+		/**
+		 * \brief implementations merging the count tables of calcHistogram, Auto chooses the fastest one the cpu supports
+		 */
+		enum class HistogramMerge {
+			Auto,
+			Scalar,
+			SSE2,
+			AVX2
+		};
+
+		/**
+		 * \brief sets the merge used by calcHistogram, returns false and keeps the current one if merge isn't available on this cpu
+		 * this is meant for tests and benchmarks and must not be called while other threads compress
+		 */
+		static bool setHistogramMerge(HistogramMerge merge);
+
+		/**
+		 * \brief counts the occurrences of every byte in text, histogram has size 256 afterwards
+		 */
+		static void calcHistogram(const std::string & text, std::vector<len_t> & histogram);
+
+		/**
+		 * \brief counts the occurrences of every byte in the first length bytes of data, histogram has size 256 afterwards
+		 */
+		static void calcHistogram(const uint8_t * data, size_t length, std::vector<len_t> & histogram);
+
+		/**
+		 * \brief returns the amount of bits needed to encode a text with the given histogram
+		 */
+		static uint64_t countBits(const std::vector<len_t> & histogram, const std::vector<Code> & codes);
+
+		/**
+		 * \brief encodes the first length bytes of data with codes and writes the bit sequence to out
+		 * out has to be large enough for the whole bit sequence and the padding byte, the padding byte isn't written if it doesn't contain any bits, so it has to be 0 before
+		 */
+		static void encode(const uint8_t * data, size_t length, const std::vector<Code> & codes, char * out);
+
+		/**
+		 * \brief builds the decoding table for the given codes, the index in codes is the symbol
+		 * if pairs is set and there are at most 256 symbols, entries can contain two symbols (this is only supported by decode)
+		 * returns ClockError::INVALID_ARGUMENT if a code is longer than 32 bits or codes are ambiguous
+		 */
+		static ClockError buildDecodeTable(const std::vector<Code> & codes, DecodeTable & table, bool pairs = true);
+
+		/**
+		 * \brief builds the decoding table for the given tree, also supports empty trees and trees consisting of a single leaf
+		 */
+		static ClockError buildDecodeTable(const Tree & tree, DecodeTable & table);
+
+		/**
+		 * \brief decodes length symbols from a bit sequence
+		 * \param[in] data the bit sequence including the padding byte
+		 * \param[in] size the amount of bytes of the bit sequence
+		 * \param[in] table the decoding table of the used codes
+		 * \param[in] length the amount of characters that are encoded in the bit sequence
+		 * \param[out] out the decompressed characters, has to have space for length characters
+		 * returns ClockError::INVALID_ARGUMENT if the bit sequence doesn't contain exactly the encoded characters
+		 */
+		static ClockError decode(const uint8_t * data, size_t size, const DecodeTable & table, len_t length, char * out);
+
+		/**
+		 * \brief amount of bit sequences used by encodeInterleaved
+		 */
+		static const size_t STREAMS = 4;
+
+		/**
+		 * \brief computes the sizes of the bit sequences encodeInterleaved creates for the first length bytes of data
+		 * returns the size of the whole output of encodeInterleaved
+		 */
+		static size_t interleavedSize(const uint8_t * data, size_t length, const std::vector<Code> & codes, size_t (&sizes)[STREAMS]);
+
+		/**
+		 * \brief splits the first length bytes of data into STREAMS parts of the same size and writes each part encoded with codes as its own bit sequence to out
+		 * the sizes of the first STREAMS - 1 bit sequences are stored in front of them (4 Bytes each), so the decoder can find the start of every sequence
+		 * sizes has to be computed with interleavedSize before and out needs space for the amount of bytes returned by it
+		 */
+		static void encodeInterleaved(const uint8_t * data, size_t length, const std::vector<Code> & codes, const size_t (&sizes)[STREAMS], char * out);
 
 		/**
-		 * \brief constructs a mapping from character to a bit sequence
-		 * \param[in] node Root node of the probability tree
-		 * \param[in] bitSeq Bit sequence until this point in the tree
-		 * \param[out] mapping Constructed mapping
+		 * \brief decodes length symbols written with encodeInterleaved from the size bytes of data
+		 * all bit sequences are decoded at the same time, this hides the latency of the table lookups which depend on the previous ones within a single sequence
+		 * returns ClockError::INVALID_ARGUMENT if a bit sequence doesn't contain exactly the encoded characters
 		 */
-		static void generateMapping(const std::shared_ptr<Node> & node, const std::vector<bool> & bitSeq, std::vector<std::vector<bool>> & mapping);
+		static ClockError decodeInterleaved(const uint8_t * data, size_t size, const DecodeTable & table, len_t length, char * out);
 
+	private:
 		/**
-		 * \brief converts bit sequence to the real character
-		 * \param[in] compressed the compressed string containing the bit sequence
-		 * \param[in] root the tree root with the encoding
-		 * \param[in] length the amount of characters that are encoded in the compressed string
-		 * \param[in,out] result the resulting string containing the decompressed string
+		 * \brief decodes the characters between out and end from the bit sequence data starting at bitPos
+		 * bitPos points behind the last decoded code afterwards
 		 */
-		static ClockError getChar(const std::string & compressed, const std::shared_ptr<Node> & root, len_t length, std::string & result);
+		static ClockError decodeSequence(const uint8_t * data, size_t size, uint64_t & bitPos, const DecodeTable & table, char * out, char * end);
 	};
 
 } /* namespace algorithm */
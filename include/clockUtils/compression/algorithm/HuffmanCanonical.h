@@ -0,0 +1,87 @@
+/*
+ * clockUtils
+ * Copyright (2015) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * \addtogroup compression
+ * @{
+ */
+
+#ifndef __CLOCKUTILS_COMPRESSION_ALGORITHM_HUFFMANCANONICAL_H__
+#define __CLOCKUTILS_COMPRESSION_ALGORITHM_HUFFMANCANONICAL_H__
+
+#include "clockUtils/compression/algorithm/HuffmanBase.h"
+#include "clockUtils/compression/algorithm/OutputBuffer.h"
+
+namespace clockUtils {
+namespace compression {
+namespace algorithm {
+
+	/**
+	 * \brief class for Huffman compression using canonical codes generated out of the given string
+	 * the header contains only the code lengths of the used bytes (usually 20 - 130 Bytes instead of 256 Bytes for HuffmanGeneric)
+	 * the codes are built from the exact byte counts and limited to 11 bits, so decoding needs just one table lookup per byte
+	 */
+	class CLOCK_COMPRESSION_API HuffmanCanonical : public HuffmanBase {
+	public:
+		/**
+		 * \brief maximum length of a code in bits
+		 */
+		static const uint8_t MAX_CODE_LENGTH = 11;
+
+		/**
+		 * \brief compresses the given string and returns result
+		 */
+		static ClockError compress(const std::string & uncompressed, std::string & compressed);
+
+		/**
+		 * \brief decompresses the given string and returns result
+		 */
+		static ClockError decompress(const std::string & compressed, std::string & decompressed);
+
+		/**
+		 * \brief returns the maximum size of the compressed string of length bytes
+		 */
+		static size_t maxCompressedSize(size_t length);
+
+		/**
+		 * \brief compresses length bytes of uncompressed into the buffer compressed that can hold capacity bytes
+		 * compressedLength is the size of the result afterwards, returns ClockError::OUT_OF_MEMORY if capacity is too small, compressedLength is the required size in this case
+		 */
+		static ClockError compress(const void * uncompressed, size_t length, void * compressed, size_t capacity, size_t & compressedLength);
+
+		/**
+		 * \brief decompresses length bytes of compressed into the buffer decompressed that can hold capacity bytes
+		 * decompressedLength is the size of the result afterwards, returns ClockError::OUT_OF_MEMORY if capacity is too small, decompressedLength is the required size in this case
+		 */
+		static ClockError decompress(const void * compressed, size_t length, void * decompressed, size_t capacity, size_t & decompressedLength);
+
+	private:
+		static ClockError compress(const uint8_t * data, size_t length, OutputBuffer & out);
+		static ClockError decompress(const uint8_t * data, size_t length, OutputBuffer & out);
+	};
+
+} /* namespace algorithm */
+} /* namespace compression */
+} /* namespace clockUtils */
+
+#endif /* __CLOCKUTILS_COMPRESSION_ALGORITHM_HUFFMANCANONICAL_H__ */
+
+/**
+ * @}
+ */
@@ -0,0 +1,99 @@
+/*
+ * clockUtils
+ * Copyright (2015) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * \addtogroup compression
+ * @{
+ */
+
+#ifndef __CLOCKUTILS_COMPRESSION_ALGORITHM_HUFFMANCONTEXT_H__
+#define __CLOCKUTILS_COMPRESSION_ALGORITHM_HUFFMANCONTEXT_H__
+
+#include "clockUtils/compression/algorithm/HuffmanBase.h"
+#include "clockUtils/compression/algorithm/OutputBuffer.h"
+
+namespace clockUtils {
+namespace compression {
+namespace algorithm {
+
+	/**
+	 * \brief class for Huffman compression with codes depending on the previous byte (order-1 context)
+	 * the previous bytes are grouped into up to MAX_CLASSES context classes, every class has its own canonical codes limited to 11 bits
+	 * the most frequent previous bytes get their own class and the remaining ones are added to the class they fit best, the amount of classes is chosen by the estimated size of the output
+	 * the header contains the class of every used previous byte and the code lengths of every class like HuffmanCanonical, so text with strong correlation between neighbouring bytes is compressed a lot better than with HuffmanGeneric
+	 */
+	class CLOCK_COMPRESSION_API HuffmanContext : public HuffmanBase {
+	public:
+		/**
+		 * \brief maximum length of a code in bits
+		 */
+		static const uint8_t MAX_CODE_LENGTH = 11;
+
+		/**
+		 * \brief maximum amount of context classes
+		 */
+		static const size_t MAX_CLASSES = 32;
+
+		/**
+		 * \brief compresses the given string and returns result
+		 */
+		static ClockError compress(const std::string & uncompressed, std::string & compressed);
+
+		/**
+		 * \brief decompresses the given string and returns result
+		 */
+		static ClockError decompress(const std::string & compressed, std::string & decompressed);
+
+		/**
+		 * \brief returns the maximum size of the compressed string of length bytes
+		 */
+		static size_t maxCompressedSize(size_t length);
+
+		/**
+		 * \brief compresses length bytes of uncompressed into the buffer compressed that can hold capacity bytes
+		 * compressedLength is the size of the result afterwards, returns ClockError::OUT_OF_MEMORY if capacity is too small, compressedLength is the required size in this case
+		 */
+		static ClockError compress(const void * uncompressed, size_t length, void * compressed, size_t capacity, size_t & compressedLength);
+
+		/**
+		 * \brief decompresses length bytes of compressed into the buffer decompressed that can hold capacity bytes
+		 * decompressedLength is the size of the result afterwards, returns ClockError::OUT_OF_MEMORY if capacity is too small, decompressedLength is the required size in this case
+		 */
+		static ClockError decompress(const void * compressed, size_t length, void * decompressed, size_t capacity, size_t & decompressedLength);
+
+	private:
+		static ClockError compress(const uint8_t * data, size_t length, OutputBuffer & out);
+		static ClockError decompress(const uint8_t * data, size_t length, OutputBuffer & out);
+
+		/**
+		 * \brief decodes length bytes from the size bytes of data, the table used for every byte is the one of the class of the previous byte
+		 * the first byte uses the class of the byte 0, returns ClockError::INVALID_ARGUMENT if the bit sequence doesn't contain exactly the encoded characters
+		 */
+		static ClockError decodeContexts(const uint8_t * data, size_t size, const std::vector<DecodeTable> & tables, const uint8_t (&contextClasses)[256], len_t length, char * out);
+	};
+
+} /* namespace algorithm */
+} /* namespace compression */
+} /* namespace clockUtils */
+
+#endif /* __CLOCKUTILS_COMPRESSION_ALGORITHM_HUFFMANCONTEXT_H__ */
+
+/**
+ * @}
+ */
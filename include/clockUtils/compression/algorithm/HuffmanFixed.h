@@ -26,6 +26,7 @@
 #define __CLOCKUTILS_COMPRESSION_ALGORITHM_HUFFMANFIXED_H__
 
 #include "clockUtils/compression/algorithm/HuffmanBase.h"
+#include "clockUtils/compression/algorithm/OutputBuffer.h"
 
 namespace clockUtils {
 namespace compression {
@@ -47,21 +48,41 @@ namespace algorithm {
 		 */
 		static ClockError decompress(const std::string & compressed, std::string & decompressed);
 
+		/**
+		 * \brief returns the maximum size of the compressed string of length bytes
+		 */
+		static size_t maxCompressedSize(size_t length);
+
+		/**
+		 * \brief compresses length bytes of uncompressed into the buffer compressed that can hold capacity bytes
+		 * compressedLength is the size of the result afterwards, returns ClockError::OUT_OF_MEMORY if capacity is too small, compressedLength is the required size in this case
+		 */
+		static ClockError compress(const void * uncompressed, size_t length, void * compressed, size_t capacity, size_t & compressedLength);
+
+		/**
+		 * \brief decompresses length bytes of compressed into the buffer decompressed that can hold capacity bytes
+		 * decompressedLength is the size of the result afterwards, returns ClockError::OUT_OF_MEMORY if capacity is too small, decompressedLength is the required size in this case
+		 */
+		static ClockError decompress(const void * compressed, size_t length, void * decompressed, size_t capacity, size_t & decompressedLength);
+
 	private:
+		static ClockError compress(const uint8_t * data, size_t length, OutputBuffer & out);
+		static ClockError decompress(const uint8_t * data, size_t length, OutputBuffer & out);
+
 		/**
-		 * \brief the tree in fixed Huffman is always the same, so it can be stored as static member during whole lifetime
+		 * \brief the tree in fixed Huffman is always the same, so it is built only once on first use
 		 */
-		static std::shared_ptr<Node> root;
+		static const Tree & tree();
 
 		/**
-		 * \brief because the tree in fixed Huffman stays always the same, also the mappings are constant
+		 * \brief returns the decoding table for the fixed tree, it is built on first use
 		 */
-		static std::vector<std::vector<bool>> mappings;
+		static const DecodeTable & decodeTable();
 
 		/**
-		 * \brief converts the text into a bit sequence using the mappings, if possible and otherwise filling the mappings
+		 * \brief because the tree in fixed Huffman stays always the same, also the codes are constant, they are generated on first use
 		 */
-		static void convert(const std::string & text, size_t index, std::string & result);
+		static const std::vector<Code> & codes();
 	};
 
 } /* namespace algorithm */
@@ -26,6 +26,7 @@
 #define __CLOCKUTILS_COMPRESSION_ALGORITHM_HUFFMANGENERIC_H__
 
 #include "clockUtils/compression/algorithm/HuffmanBase.h"
+#include "clockUtils/compression/algorithm/OutputBuffer.h"
 
 namespace clockUtils {
 namespace compression {
@@ -47,17 +48,32 @@ namespace algorithm {
 		 */
 		static ClockError decompress(const std::string & compressed, std::string & decompressed);
 
-	private:
 		/**
-		 * \brief converts the given text to a bit sequence using a cache internally to improve performance
+		 * \brief returns the maximum size of the compressed string of length bytes
 		 */
-		static void convert(const std::string & text, const std::shared_ptr<Node> & node, size_t index, std::string & result);
+		static size_t maxCompressedSize(size_t length);
 
 		/**
-		 * \brief calculates the frequencies of all bytes
-		 * The values are scaled down to 1 Byte to decrease memory usage
+		 * \brief compresses length bytes of uncompressed into the buffer compressed that can hold capacity bytes
+		 * compressedLength is the size of the result afterwards, returns ClockError::OUT_OF_MEMORY if capacity is too small, compressedLength is the required size in this case
 		 */
-		static std::vector<uint8_t> calcFrequencies(const std::string & text);
+		static ClockError compress(const void * uncompressed, size_t length, void * compressed, size_t capacity, size_t & compressedLength);
+
+		/**
+		 * \brief decompresses length bytes of compressed into the buffer decompressed that can hold capacity bytes
+		 * decompressedLength is the size of the result afterwards, returns ClockError::OUT_OF_MEMORY if capacity is too small, decompressedLength is the required size in this case
+		 */
+		static ClockError decompress(const void * compressed, size_t length, void * decompressed, size_t capacity, size_t & decompressedLength);
+
+	protected:
+		/**
+		 * \brief scales the histogram of all bytes down to 1 Byte per value to decrease the size of the header
+		 */
+		static std::vector<uint8_t> calcFrequencies(const std::vector<len_t> & histogram);
+
+	private:
+		static ClockError compress(const uint8_t * data, size_t length, OutputBuffer & out);
+		static ClockError decompress(const uint8_t * data, size_t length, OutputBuffer & out);
 	};
 
 } /* namespace algorithm */
@@ -0,0 +1,105 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * \addtogroup compression
+ * @{
+ */
+
+#ifndef __CLOCKUTILS_COMPRESSION_ALGORITHM_HUFFMANPRESET_H__
+#define __CLOCKUTILS_COMPRESSION_ALGORITHM_HUFFMANPRESET_H__
+
+#include "clockUtils/compression/algorithm/HuffmanBase.h"
+#include "clockUtils/compression/algorithm/OutputBuffer.h"
+
+namespace clockUtils {
+namespace compression {
+namespace algorithm {
+
+	/**
+	 * \brief class for Huffman compression using the best of several built-in dictionaries
+	 * like HuffmanFixed there is no dictionary in the header, but every string is encoded with the preset matching its content best
+	 * the presets are chosen by the size of the encoded string computed from its histogram, if none of them reduces the size the string is stored uncompressed
+	 * the header only contains the id of the preset (1 Byte) and the length of the string
+	 */
+	class CLOCK_COMPRESSION_API HuffmanPreset : public HuffmanBase {
+	public:
+		/**
+		 * \brief the dictionaries, the value is the id stored in the first byte of the compressed string
+		 */
+		enum class Preset : uint8_t {
+			STORED,		//!< 0x0	string isn't compressed
+			ENGLISH,	//!< 0x1	english text
+			MARKUP,		//!< 0x2	JSON and XML
+			BINARY,		//!< 0x3	binary data like executables
+			NUMERIC,	//!< 0x4	numbers in ASCII like CSV files
+			COUNT
+		};
+
+		/**
+		 * \brief compresses the given string and returns result
+		 */
+		static ClockError compress(const std::string & uncompressed, std::string & compressed);
+
+		/**
+		 * \brief decompresses the given string and returns result
+		 */
+		static ClockError decompress(const std::string & compressed, std::string & decompressed);
+
+		/**
+		 * \brief returns the maximum size of the compressed string of length bytes
+		 */
+		static size_t maxCompressedSize(size_t length);
+
+		/**
+		 * \brief compresses length bytes of uncompressed into the buffer compressed that can hold capacity bytes
+		 * compressedLength is the size of the result afterwards, returns ClockError::OUT_OF_MEMORY if capacity is too small, compressedLength is the required size in this case
+		 */
+		static ClockError compress(const void * uncompressed, size_t length, void * compressed, size_t capacity, size_t & compressedLength);
+
+		/**
+		 * \brief decompresses length bytes of compressed into the buffer decompressed that can hold capacity bytes
+		 * decompressedLength is the size of the result afterwards, returns ClockError::OUT_OF_MEMORY if capacity is too small, decompressedLength is the required size in this case
+		 */
+		static ClockError decompress(const void * compressed, size_t length, void * decompressed, size_t capacity, size_t & decompressedLength);
+
+	private:
+		static ClockError compress(const uint8_t * data, size_t length, OutputBuffer & out);
+		static ClockError decompress(const uint8_t * data, size_t length, OutputBuffer & out);
+
+		/**
+		 * \brief the codes of all presets except STORED (index is the id - 1), they are generated on first use
+		 */
+		static const std::vector<std::vector<Code>> & codes();
+
+		/**
+		 * \brief the decoding tables of all presets except STORED (index is the id - 1), they are built on first use
+		 */
+		static const std::vector<DecodeTable> & decodeTables();
+	};
+
+} /* namespace algorithm */
+} /* namespace compression */
+} /* namespace clockUtils */
+
+#endif /* __CLOCKUTILS_COMPRESSION_ALGORITHM_HUFFMANPRESET_H__ */
+
+/**
+ * @}
+ */
@@ -0,0 +1,104 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * \addtogroup compression
+ * @{
+ */
+
+#ifndef __CLOCKUTILS_COMPRESSION_ALGORITHM_HUFFMANTABLE_H__
+#define __CLOCKUTILS_COMPRESSION_ALGORITHM_HUFFMANTABLE_H__
+
+#include "clockUtils/compression/algorithm/HuffmanBase.h"
+
+namespace clockUtils {
+namespace compression {
+namespace algorithm {
+
+	class HuffmanTrained;
+
+	/**
+	 * class HuffmanTable
+	 *
+	 * static Huffman dictionary that is trained from sample data instead of being hardcoded like the one of HuffmanFixed
+	 * a table is trained once from samples of the data that is going to be compressed, serialized and loaded by the application, so HuffmanTrained can compress such data without a header
+	 * every byte gets a code, bytes that don't occur in the samples get one of the longest codes
+	 */
+	class CLOCK_COMPRESSION_API HuffmanTable : public HuffmanBase {
+		friend class HuffmanTrained;
+
+	public:
+		/**
+		 * \brief maximum length of a code in bits
+		 */
+		static const uint8_t MAX_CODE_LENGTH = 11;
+
+		/**
+		 * \brief creates a table with 8 bit codes for every byte
+		 */
+		HuffmanTable();
+
+		/**
+		 * \brief adds the bytes of sample to the statistics used by train
+		 * large files can be added in several chunks
+		 */
+		void addSample(const std::string & sample);
+
+		/**
+		 * \brief builds the codes from all samples added so far
+		 */
+		void train();
+
+		/**
+		 * \brief returns the amount of bytes added with addSample
+		 */
+		uint64_t sampleSize() const;
+
+		/**
+		 * \brief returns the size in bits of all samples encoded with the current codes
+		 */
+		uint64_t encodedSampleSize() const;
+
+		/**
+		 * \brief returns the code lengths of the table, this string can be stored and loaded with deserialize
+		 */
+		std::string serialize() const;
+
+		/**
+		 * \brief loads a table created with serialize
+		 * returns ClockError::INVALID_ARGUMENT if serialized isn't a valid table, the table isn't modified in this case
+		 */
+		ClockError deserialize(const std::string & serialized);
+
+	private:
+		std::vector<uint64_t> _histogram;
+		std::vector<uint8_t> _lengths;
+		std::vector<Code> _codes;
+		DecodeTable _decodeTable;
+	};
+
+} /* namespace algorithm */
+} /* namespace compression */
+} /* namespace clockUtils */
+
+#endif /* __CLOCKUTILS_COMPRESSION_ALGORITHM_HUFFMANTABLE_H__ */
+
+/**
+ * @}
+ */
@@ -0,0 +1,83 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * \addtogroup compression
+ * @{
+ */
+
+#ifndef __CLOCKUTILS_COMPRESSION_ALGORITHM_HUFFMANTRAINED_H__
+#define __CLOCKUTILS_COMPRESSION_ALGORITHM_HUFFMANTRAINED_H__
+
+#include "clockUtils/compression/algorithm/HuffmanBase.h"
+#include "clockUtils/compression/algorithm/HuffmanTable.h"
+#include "clockUtils/compression/algorithm/OutputBuffer.h"
+
+namespace clockUtils {
+namespace compression {
+namespace algorithm {
+
+	/**
+	 * \brief class for Huffman compression using a dictionary trained from sample data
+	 * works like HuffmanFixed without any header, but the dictionary is a HuffmanTable passed to every call, so it can match the data of the application
+	 * compressing and decompressing a string requires the same table
+	 */
+	class CLOCK_COMPRESSION_API HuffmanTrained : public HuffmanBase {
+	public:
+		/**
+		 * \brief compresses the given string with the codes of table and returns result
+		 */
+		static ClockError compress(const std::string & uncompressed, std::string & compressed, const HuffmanTable & table);
+
+		/**
+		 * \brief decompresses the given string with the codes of table and returns result
+		 */
+		static ClockError decompress(const std::string & compressed, std::string & decompressed, const HuffmanTable & table);
+
+		/**
+		 * \brief returns the maximum size of the compressed string of length bytes
+		 */
+		static size_t maxCompressedSize(size_t length);
+
+		/**
+		 * \brief compresses length bytes of uncompressed into the buffer compressed that can hold capacity bytes with the codes of table
+		 * compressedLength is the size of the result afterwards, returns ClockError::OUT_OF_MEMORY if capacity is too small, compressedLength is the required size in this case
+		 */
+		static ClockError compress(const void * uncompressed, size_t length, void * compressed, size_t capacity, size_t & compressedLength, const HuffmanTable & table);
+
+		/**
+		 * \brief decompresses length bytes of compressed into the buffer decompressed that can hold capacity bytes with the codes of table
+		 * decompressedLength is the size of the result afterwards, returns ClockError::OUT_OF_MEMORY if capacity is too small, decompressedLength is the required size in this case
+		 */
+		static ClockError decompress(const void * compressed, size_t length, void * decompressed, size_t capacity, size_t & decompressedLength, const HuffmanTable & table);
+
+	private:
+		static ClockError compress(const uint8_t * data, size_t length, OutputBuffer & out, const HuffmanTable & table);
+		static ClockError decompress(const uint8_t * data, size_t length, OutputBuffer & out, const HuffmanTable & table);
+	};
+
+} /* namespace algorithm */
+} /* namespace compression */
+} /* namespace clockUtils */
+
+#endif /* __CLOCKUTILS_COMPRESSION_ALGORITHM_HUFFMANTRAINED_H__ */
+
+/**
+ * @}
+ */
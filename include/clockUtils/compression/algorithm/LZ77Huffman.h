@@ -0,0 +1,123 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * \addtogroup compression
+ * @{
+ */
+
+#ifndef __CLOCKUTILS_COMPRESSION_ALGORITHM_LZ77HUFFMAN_H__
+#define __CLOCKUTILS_COMPRESSION_ALGORITHM_LZ77HUFFMAN_H__
+
+#include "clockUtils/compression/algorithm/HuffmanBase.h"
+#include "clockUtils/compression/algorithm/LZBase.h"
+#include "clockUtils/compression/algorithm/OutputBuffer.h"
+
+namespace clockUtils {
+namespace compression {
+namespace algorithm {
+
+	/**
+	 * \brief class for LZ77 compression with Huffman coded literals, match lengths and distances similar to Deflate
+	 * repeated strings are found with lazy matching, so a match is postponed if the next position starts a longer one
+	 * literals and match lengths share one alphabet, distances use a second one, both are stored as canonical codes limited to 15 bits
+	 * the effort level trades compression speed against ratio, decompression speed doesn't depend on it
+	 */
+	class CLOCK_COMPRESSION_API LZ77Huffman : public HuffmanBase, public LZBase {
+	public:
+		/**
+		 * \brief fastest level, doesn't use lazy matching
+		 */
+		static const int MIN_LEVEL = 1;
+
+		/**
+		 * \brief best compression
+		 */
+		static const int MAX_LEVEL = 9;
+
+		/**
+		 * \brief level used if none is given
+		 */
+		static const int DEFAULT_LEVEL = 6;
+
+		/**
+		 * \brief window used if none is given, the maximum is 65535 Bytes
+		 */
+		static const uint32_t DEFAULT_WINDOW = 32768;
+
+		/**
+		 * \brief compresses the given string with DEFAULT_LEVEL and DEFAULT_WINDOW and returns result
+		 */
+		static ClockError compress(const std::string & uncompressed, std::string & compressed);
+
+		/**
+		 * \brief compresses the given string and returns result
+		 * \param[in] uncompressed the string to compress
+		 * \param[out] compressed the compressed string
+		 * \param[in] level effort between MIN_LEVEL and MAX_LEVEL
+		 * \param[in] window maximum distance of a match in bytes, between 1 and 65535, larger windows find more matches
+		 * returns ClockError::INVALID_ARGUMENT if level or window are out of range
+		 */
+		static ClockError compress(const std::string & uncompressed, std::string & compressed, int level, uint32_t window = DEFAULT_WINDOW);
+
+		/**
+		 * \brief decompresses the given string and returns result
+		 * strings compressed with every level and window can be decompressed
+		 */
+		static ClockError decompress(const std::string & compressed, std::string & decompressed);
+
+		/**
+		 * \brief returns the maximum size of the compressed string of length bytes
+		 */
+		static size_t maxCompressedSize(size_t length);
+
+		/**
+		 * \brief compresses length bytes of uncompressed with DEFAULT_LEVEL and DEFAULT_WINDOW into the buffer compressed that can hold capacity bytes
+		 * compressedLength is the size of the result afterwards, returns ClockError::OUT_OF_MEMORY if capacity is too small, compressedLength is the required size in this case
+		 */
+		static ClockError compress(const void * uncompressed, size_t length, void * compressed, size_t capacity, size_t & compressedLength);
+
+		/**
+		 * \brief compresses length bytes of uncompressed into the buffer compressed that can hold capacity bytes, level and window are the same as for strings
+		 * compressedLength is the size of the result afterwards, returns ClockError::OUT_OF_MEMORY if capacity is too small, compressedLength is the required size in this case
+		 */
+		static ClockError compress(const void * uncompressed, size_t length, void * compressed, size_t capacity, size_t & compressedLength, int level, uint32_t window = DEFAULT_WINDOW);
+
+		/**
+		 * \brief decompresses length bytes of compressed into the buffer decompressed that can hold capacity bytes
+		 * decompressedLength is the size of the result afterwards, returns ClockError::OUT_OF_MEMORY if capacity is too small, decompressedLength is the required size in this case
+		 */
+		static ClockError decompress(const void * compressed, size_t length, void * decompressed, size_t capacity, size_t & decompressedLength);
+
+	private:
+		typedef HuffmanBase::len_t len_t;
+
+		static ClockError compress(const uint8_t * data, size_t length, OutputBuffer & output, int level, uint32_t window);
+		static ClockError decompress(const uint8_t * compressed, size_t length, OutputBuffer & output);
+	};
+
+} /* namespace algorithm */
+} /* namespace compression */
+} /* namespace clockUtils */
+
+#endif /* __CLOCKUTILS_COMPRESSION_ALGORITHM_LZ77HUFFMAN_H__ */
+
+/**
+ * @}
+ */
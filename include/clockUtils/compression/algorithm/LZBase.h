@@ -0,0 +1,230 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * \addtogroup compression
+ * @{
+ */
+
+#ifndef __CLOCKUTILS_COMPRESSION_ALGORITHM_LZBASE_H__
+#define __CLOCKUTILS_COMPRESSION_ALGORITHM_LZBASE_H__
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "clockUtils/compression/compressionParameters.h"
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+namespace clockUtils {
+namespace compression {
+namespace algorithm {
+
+	/**
+	 * \brief base class for LZ77 compression
+	 * contains the match finder and helpers shared by all algorithms replacing repeated strings with references to earlier occurrences
+	 */
+	class LZBase {
+	protected:
+		/**
+		 * \brief type that should be used as the 'length' counter
+		 */
+		typedef uint32_t len_t;
+
+		/**
+		 * \brief shortest match that is found
+		 */
+		static const uint32_t MIN_MATCH = 4;
+
+		static uint32_t read32(const uint8_t * data) {
+			uint32_t value;
+			memcpy(&value, data, 4);
+			return value;
+		}
+
+		static uint64_t read64(const uint8_t * data) {
+			uint64_t value;
+			memcpy(&value, data, 8);
+			return value;
+		}
+
+		/**
+		 * \brief returns the amount of equal bytes at current and match, current + result doesn't exceed limit
+		 * compares 8 bytes at once as long as possible
+		 */
+		static size_t countEqual(const uint8_t * current, const uint8_t * match, const uint8_t * limit) {
+			const uint8_t * const start = current;
+			while (current + 8 <= limit) {
+				const uint64_t diff = read64(current) ^ read64(match);
+				if (diff != 0) {
+					// first differing byte on little endian machines
+#if defined(_MSC_VER)
+					unsigned long index;
+					_BitScanForward64(&index, diff);
+					return size_t(current - start) + (index >> 3);
+#else
+					return size_t(current - start) + size_t(__builtin_ctzll(diff) >> 3);
+#endif
+				}
+				current += 8;
+				match += 8;
+			}
+			while (current < limit && *current == *match) {
+				current++;
+				match++;
+			}
+			return size_t(current - start);
+		}
+
+		/**
+		 * \brief finds earlier occurrences of the string at a position using hash chains
+		 * the first MIN_MATCH bytes of every position are hashed, positions with the same hash are linked to a chain storing the distance to the previous one
+		 * positions have to be searched in increasing order, all positions skipped in between are inserted into the chains automatically
+		 */
+		class MatchFinder {
+		public:
+			/**
+			 * \brief largest supported window
+			 */
+			static const uint32_t MAX_WINDOW = 65535;
+
+			/**
+			 * \brief prepares the finder for data
+			 * \param[in] data the string to search in
+			 * \param[in] length the length of data
+			 * \param[in] window maximum distance of a match, at most MAX_WINDOW
+			 * \param[in] attempts maximum amount of chain entries tested for every position
+			 * \param[in] niceLength the search stops as soon as a match of this length was found
+			 */
+			MatchFinder(const uint8_t * data, size_t length, uint32_t window, uint32_t attempts, uint32_t niceLength) : _data(data), _window(window), _attempts(attempts), _niceLength(niceLength), _hashShift(0), _head(), _chain(), _chainMask(0), _next(0) {
+				uint32_t hashLog = 8;
+				while (hashLog < 16 && (size_t(1) << hashLog) < length) {
+					hashLog++;
+				}
+				_hashShift = 32 - hashLog;
+				_head.assign(size_t(1) << hashLog, 0);
+				// the chain only has to reach back window bytes
+				size_t chainSize = 256;
+				while (chainSize <= window && chainSize < length) {
+					chainSize <<= 1;
+				}
+				_chain.assign(chainSize, 0);
+				_chainMask = chainSize - 1;
+			}
+
+			/**
+			 * \brief searches the longest match for the string at pos ending at most at limit
+			 * pos + MIN_MATCH must not exceed the length of the data
+			 * returns the length of the match or 0 if no match with at least MIN_MATCH bytes was found
+			 */
+			size_t find(size_t pos, size_t limit, uint32_t & distance) {
+				insert(pos);
+				const uint8_t * const current = _data + pos;
+				const uint8_t * const end = _data + limit;
+				const uint32_t first = read32(current);
+				size_t best = MIN_MATCH - 1;
+				uint32_t candidate = _head[hash(first)];
+				uint32_t attempts = _attempts;
+				while (candidate > 0 && attempts-- > 0) {
+					const size_t candidatePos = candidate - 1;
+					const uint32_t dist = uint32_t(pos - candidatePos);
+					if (dist > _window) {
+						break;
+					}
+					const uint8_t * const match = _data + candidatePos;
+					// a longer match has to differ in the byte behind the current best one
+					if (current + best < end && match[best] == current[best] && read32(match) == first) {
+						const size_t length = MIN_MATCH + countEqual(current + MIN_MATCH, match + MIN_MATCH, end);
+						if (length > best) {
+							best = length;
+							distance = dist;
+							if (length >= _niceLength || current + length >= end) {
+								break;
+							}
+						}
+					}
+					const uint16_t delta = _chain[candidatePos & _chainMask];
+					if (delta == 0 || delta > candidatePos) {
+						break;
+					}
+					candidate -= delta;
+				}
+				return (best >= MIN_MATCH) ? best : 0;
+			}
+
+			/**
+			 * \brief continues with pos without inserting the positions in between
+			 * used to skip over incompressible data faster
+			 */
+			void skip(size_t pos) {
+				if (pos > _next) {
+					_next = pos;
+				}
+			}
+
+		private:
+			const uint8_t * _data;
+			uint32_t _window;
+			uint32_t _attempts;
+			uint32_t _niceLength;
+			uint32_t _hashShift;
+
+			/**
+			 * \brief last position + 1 of every hash, 0 if the hash didn't occur yet
+			 */
+			std::vector<uint32_t> _head;
+
+			/**
+			 * \brief distance to the previous position with the same hash, 0 if there is none in the window
+			 */
+			std::vector<uint16_t> _chain;
+			size_t _chainMask;
+
+			/**
+			 * \brief first position that isn't inserted yet
+			 */
+			size_t _next;
+
+			uint32_t hash(uint32_t value) const {
+				return (value * 2654435761u) >> _hashShift;
+			}
+
+			void insert(size_t pos) {
+				for (; _next < pos; _next++) {
+					uint32_t & head = _head[hash(read32(_data + _next))];
+					const size_t delta = _next + 1 - head;
+					_chain[_next & _chainMask] = (head > 0 && delta <= _window) ? uint16_t(delta) : 0;
+					head = uint32_t(_next + 1);
+				}
+			}
+		};
+	};
+
+} /* namespace algorithm */
+} /* namespace compression */
+} /* namespace clockUtils */
+
+#endif /* __CLOCKUTILS_COMPRESSION_ALGORITHM_LZBASE_H__ */
+
+/**
+ * @}
+ */
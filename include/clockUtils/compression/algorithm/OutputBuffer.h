@@ -0,0 +1,114 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * \addtogroup compression
+ * @{
+ */
+
+#ifndef __CLOCKUTILS_COMPRESSION_ALGORITHM_OUTPUTBUFFER_H__
+#define __CLOCKUTILS_COMPRESSION_ALGORITHM_OUTPUTBUFFER_H__
+
+#include <cstddef>
+#include <new>
+#include <string>
+
+namespace clockUtils {
+namespace compression {
+namespace algorithm {
+
+	/**
+	 * class OutputBuffer
+	 *
+	 * destination of the algorithms, either a std::string growing to the needed size or a buffer of the caller with a fixed capacity
+	 * the algorithms request the space as soon as they know how much they need and write into it directly, so the std::string and the buffer interfaces share their code without copying
+	 */
+	class OutputBuffer {
+	public:
+		/**
+		 * \brief writes into str, it is resized as needed
+		 */
+		explicit OutputBuffer(std::string & str) : _string(&str), _buffer(nullptr), _capacity(0), _size(0) {
+		}
+
+		/**
+		 * \brief writes into buffer which can hold at most capacity bytes
+		 */
+		OutputBuffer(void * buffer, size_t capacity) : _string(nullptr), _buffer(static_cast<char *>(buffer)), _capacity(capacity), _size(0) {
+		}
+
+		/**
+		 * \brief makes the first size bytes of the output available and returns a pointer to them
+		 * strings get additional slack bytes that may be overwritten by the algorithm, capacity returns the amount of bytes that can be written
+		 * returns nullptr if the string can't be allocated or the buffer is too small, size returns the requested size anyway
+		 */
+		char * allocate(size_t size, size_t slack = 0) {
+			_size = size;
+			if (_string) {
+				try {
+					_string->resize(size + slack);
+				} catch (std::bad_alloc &) {
+					return nullptr;
+				}
+				_capacity = _string->length();
+				return &(*_string)[0];
+			}
+			return (size <= _capacity) ? _buffer : nullptr;
+		}
+
+		/**
+		 * \brief sets the final size of the output, size has to be less or equal to capacity
+		 */
+		void resize(size_t size) {
+			_size = size;
+			if (_string) {
+				_string->resize(size);
+			}
+		}
+
+		/**
+		 * \brief amount of bytes written by the algorithm or requested with allocate
+		 */
+		size_t size() const {
+			return _size;
+		}
+
+		/**
+		 * \brief amount of bytes that can be written after allocate succeeded
+		 */
+		size_t capacity() const {
+			return _capacity;
+		}
+
+	private:
+		std::string * _string;
+		char * _buffer;
+		size_t _capacity;
+		size_t _size;
+	};
+
+} /* namespace algorithm */
+} /* namespace compression */
+} /* namespace clockUtils */
+
+#endif /* __CLOCKUTILS_COMPRESSION_ALGORITHM_OUTPUTBUFFER_H__ */
+
+/**
+ * @}
+ */
@@ -0,0 +1,232 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * \addtogroup container
+ * @{
+ */
+
+#ifndef __CLOCKUTILS_CONTAINER_ATOMICSNAPSHOT_H__
+#define __CLOCKUTILS_CONTAINER_ATOMICSNAPSHOT_H__
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "clockUtils/errors.h"
+
+#include "clockUtils/container/containerParameters.h"
+
+namespace clockUtils {
+namespace container {
+
+	/**
+	 * class AtomicSnapshot
+	 *
+	 * read-copy-update container for larger read-mostly objects like routing tables or configurations
+	 * writers publish a new copy by swapping a pointer, old copies are deleted as soon as no reader can see them anymore
+	 * readers have to register once and then call quiescent() regularly at a point where they don't use a snapshot anymore (e.g. once per loop iteration)
+	 * get() itself doesn't write to shared memory, so readers don't bounce cache lines between each other
+	 *
+	 * T defines the type of the stored object
+	 * MAX_READERS defines the maximum amount of registered readers at the same time
+	 */
+	template<typename T, size_t MAX_READERS = 64>
+	class AtomicSnapshot {
+	public:
+		/**
+		 * \brief default constructor, initial snapshot is T()
+		 */
+		AtomicSnapshot() : _current(new T()), _epoch(1), _readers(), _writeLock(), _retired() {
+			for (ReaderSlot & slot : _readers) {
+				slot.epoch.store(0, std::memory_order_relaxed);
+			}
+		}
+
+		/**
+		 * \brief constructor with initial snapshot
+		 */
+		explicit AtomicSnapshot(const T & value) : _current(new T(value)), _epoch(1), _readers(), _writeLock(), _retired() {
+			for (ReaderSlot & slot : _readers) {
+				slot.epoch.store(0, std::memory_order_relaxed);
+			}
+		}
+
+		/**
+		 * \brief destructor, all readers have to be unregistered before
+		 */
+		~AtomicSnapshot() {
+			delete _current.load();
+			for (std::pair<T *, uint64_t> & p : _retired) {
+				delete p.first;
+			}
+		}
+
+		/**
+		 * \brief registers the calling reader and returns its id
+		 * returns ClockError::NO_SPACE_AVAILABLE if MAX_READERS readers are already registered
+		 */
+		ClockError registerReader(size_t & id) {
+			for (size_t i = 0; i < MAX_READERS; i++) {
+				uint64_t expected = 0;
+				if (_readers[i].epoch.compare_exchange_strong(expected, _epoch.load())) {
+					id = i;
+					return ClockError::SUCCESS;
+				}
+			}
+			return ClockError::NO_SPACE_AVAILABLE;
+		}
+
+		/**
+		 * \brief unregisters the reader, it mustn't use any snapshot afterwards
+		 */
+		void unregisterReader(size_t id) {
+			assert(id < MAX_READERS);
+			_readers[id].epoch.store(0, std::memory_order_release);
+		}
+
+		/**
+		 * \brief returns the current snapshot
+		 * only registered readers may call this method, the snapshot stays valid until this reader calls quiescent() or unregisterReader()
+		 */
+		const T * get() const {
+			return _current.load(std::memory_order_acquire);
+		}
+
+		/**
+		 * \brief tells that the reader with the given id doesn't hold any snapshot at the moment
+		 * only writes to the slot of this reader
+		 */
+		void quiescent(size_t id) {
+			assert(id < MAX_READERS);
+			_readers[id].epoch.store(_epoch.load(std::memory_order_acquire), std::memory_order_release);
+		}
+
+		/**
+		 * \brief publishes a new snapshot
+		 * the old snapshot is deleted as soon as all registered readers passed a quiescent state
+		 */
+		void update(const T & value) {
+			publish(new T(value));
+		}
+
+		/**
+		 * \brief publishes a new snapshot, moving the given value
+		 */
+		void update(T && value) {
+			publish(new T(std::move(value)));
+		}
+
+		/**
+		 * \brief deletes all old snapshots no reader can see anymore
+		 * returns the amount of old snapshots that are still in use
+		 */
+		size_t reclaim() {
+			std::lock_guard<std::mutex> lg(_writeLock);
+			return reclaimLocked();
+		}
+
+		/**
+		 * \brief blocks until all old snapshots are deleted
+		 * all registered readers have to pass a quiescent state for this method to return
+		 */
+		void synchronize() {
+			while (reclaim() > 0) {
+				std::this_thread::yield();
+			}
+		}
+
+	private:
+		/**
+		 * \brief epoch of the last quiescent state of a reader, 0 if the slot is unused
+		 * padded to a cache line so readers don't interfere with each other
+		 */
+		struct ReaderSlot {
+			std::atomic<uint64_t> epoch;
+			char padding[64 - sizeof(std::atomic<uint64_t>)];
+		};
+
+		std::atomic<T *> _current;
+
+		/**
+		 * \brief incremented by every update
+		 */
+		std::atomic<uint64_t> _epoch;
+
+		std::array<ReaderSlot, MAX_READERS> _readers;
+
+		/**
+		 * \brief serializes writers and guards _retired
+		 */
+		std::mutex _writeLock;
+
+		/**
+		 * \brief replaced snapshots with the epoch a reader has to reach before they can be deleted
+		 */
+		std::vector<std::pair<T *, uint64_t>> _retired;
+
+		void publish(T * snapshot) {
+			std::lock_guard<std::mutex> lg(_writeLock);
+			T * old = _current.exchange(snapshot);
+			const uint64_t epoch = _epoch.fetch_add(1) + 1;
+			_retired.push_back(std::make_pair(old, epoch));
+			reclaimLocked();
+		}
+
+		size_t reclaimLocked() {
+			uint64_t minEpoch = std::numeric_limits<uint64_t>::max();
+			for (ReaderSlot & slot : _readers) {
+				const uint64_t epoch = slot.epoch.load();
+				if (epoch != 0 && epoch < minEpoch) {
+					minEpoch = epoch;
+				}
+			}
+			size_t kept = 0;
+			for (size_t i = 0; i < _retired.size(); i++) {
+				if (_retired[i].second <= minEpoch) {
+					delete _retired[i].first;
+				} else {
+					_retired[kept++] = _retired[i];
+				}
+			}
+			_retired.resize(kept);
+			return kept;
+		}
+
+		/**
+		 * \brief forbidden
+		 */
+		AtomicSnapshot(const AtomicSnapshot &) = delete;
+		AtomicSnapshot & operator=(const AtomicSnapshot &) = delete;
+	};
+
+} /* namespace container */
+} /* namespace clockUtils */
+
+#endif /* __CLOCKUTILS_CONTAINER_ATOMICSNAPSHOT_H__ */
+
+/**
+ * @}
+ */
@@ -0,0 +1,287 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * \addtogroup container
+ * @{
+ */
+
+#ifndef __CLOCKUTILS_CONTAINER_CONCURRENTPRIORITYQUEUE_H__
+#define __CLOCKUTILS_CONTAINER_CONCURRENTPRIORITYQUEUE_H__
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "clockUtils/errors.h"
+
+#include "clockUtils/container/containerParameters.h"
+#include "clockUtils/container/Locks.h"
+
+namespace clockUtils {
+namespace container {
+
+	/**
+	 * class ConcurrentPriorityQueue
+	 *
+	 * threadsafe priority queue returning the smallest element first (e.g. the task with the earliest deadline)
+	 * implemented as relaxed MultiQueue: the elements are spread over relaxation * threads heaps, each guarded by its own SpinLock
+	 * push inserts into a random heap, tryPopMin takes the smaller top of two random heaps
+	 * so tryPopMin doesn't always return the global minimum, but one close to it, in exchange the queue scales with the amount of threads
+	 * with relaxation 1 and threads 1 there is only one heap and the order is exact
+	 *
+	 * T defines the data type being contained in the queue
+	 * Compare defines the order, the element a with Compare(a, b) for all b is popped first
+	 */
+	template<typename T, typename Compare = std::less<T>>
+	class ConcurrentPriorityQueue {
+	public:
+		/**
+		 * \brief constructor
+		 * \param[in] relaxation amount of heaps per thread, higher values reduce contention but increase the rank error of tryPopMin
+		 * \param[in] threads amount of threads using this queue, 0 uses std::thread::hardware_concurrency()
+		 * \param[in] compare comparator instance
+		 */
+		explicit ConcurrentPriorityQueue(size_t relaxation = 2, size_t threads = 0, const Compare & compare = Compare()) : _heapCount(std::max<size_t>(1, std::max<size_t>(1, relaxation) * (threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads))), _heaps(new Heap[_heapCount]), _compare(compare) {
+		}
+
+		/**
+		 * \brief inserts the given value
+		 */
+		void push(const T & value) {
+			SpinWait spin;
+			while (true) {
+				Heap & heap = _heaps[random() % _heapCount];
+				if (heap.lock.try_lock()) {
+					heap.data.push_back(value);
+					std::push_heap(heap.data.begin(), heap.data.end(), Inverted(_compare));
+					heap.size.store(heap.data.size(), std::memory_order_relaxed);
+					heap.lock.unlock();
+					return;
+				}
+				// the heap is busy, backing off keeps the threads from hammering the locks and lets a preempted holder continue
+				spin.wait();
+			}
+		}
+
+		/**
+		 * \brief removes one of the smallest elements and returns it
+		 * returns ClockError::NO_ELEMENT if the queue is empty
+		 */
+		ClockError tryPopMin(T & value) {
+			for (int attempt = 0; attempt < ATTEMPTS; attempt++) {
+				Heap * heap = lockBest();
+				if (heap != nullptr) {
+					popLocked(*heap, value);
+					heap->lock.unlock();
+					return ClockError::SUCCESS;
+				}
+			}
+			return scan(value) ? ClockError::SUCCESS : ClockError::NO_ELEMENT;
+		}
+
+		/**
+		 * \brief removes up to amount of the smallest elements and appends them to values
+		 * takes several elements from one heap at once, so the result is a bit more relaxed than calling tryPopMin amount times, but much cheaper
+		 * returns the amount of removed elements
+		 */
+		size_t tryPopMin(std::vector<T> & values, size_t amount) {
+			size_t popped = 0;
+			while (popped < amount) {
+				Heap * heap = lockBest();
+				if (heap == nullptr) {
+					T value;
+					if (!scan(value)) {
+						break;
+					}
+					values.push_back(value);
+					popped++;
+					continue;
+				}
+				// elements are spread evenly, so the smallest amount elements are roughly the smallest amount / heaps of every heap
+				const size_t limit = std::min(amount - popped, (amount + _heapCount - 1) / _heapCount);
+				for (size_t i = 0; i < limit && !heap->data.empty(); i++) {
+					T value;
+					popLocked(*heap, value);
+					values.push_back(value);
+					popped++;
+				}
+				heap->lock.unlock();
+			}
+			return popped;
+		}
+
+		/**
+		 * \brief returns true if the queue is empty, otherwise false
+		 */
+		bool empty() const {
+			return size() == 0;
+		}
+
+		/**
+		 * \brief returns size of the queue
+		 */
+		size_t size() const {
+			size_t result = 0;
+			for (size_t i = 0; i < _heapCount; i++) {
+				result += _heaps[i].size.load(std::memory_order_relaxed);
+			}
+			return result;
+		}
+
+		/**
+		 * \brief removes all elements in the queue
+		 */
+		void clear() {
+			for (size_t i = 0; i < _heapCount; i++) {
+				std::lock_guard<SpinLock> lg(_heaps[i].lock);
+				_heaps[i].data.clear();
+				_heaps[i].size.store(0, std::memory_order_relaxed);
+			}
+		}
+
+	private:
+		static const int ATTEMPTS = 8;
+
+		/**
+		 * \brief a single heap, padded so neighbouring locks don't share a cache line
+		 */
+		struct Heap {
+			Heap() : lock(), size(0), data() {
+			}
+
+			SpinLock lock;
+			std::atomic<size_t> size;
+			std::vector<T> data;
+			char padding[64];
+		};
+
+		/**
+		 * \brief std heap functions build a max heap, so the comparator is inverted
+		 */
+		struct Inverted {
+			explicit Inverted(const Compare & c) : compare(c) {
+			}
+			bool operator()(const T & a, const T & b) const {
+				return compare(b, a);
+			}
+			const Compare & compare;
+		};
+
+		const size_t _heapCount;
+		std::unique_ptr<Heap[]> _heaps;
+		Compare _compare;
+
+		/**
+		 * \brief xorshift random number generator, one per thread
+		 */
+		static uint64_t random() {
+			static thread_local uint64_t state = 0;
+			if (state == 0) {
+				state = uint64_t(std::hash<std::thread::id>()(std::this_thread::get_id())) | 1;
+			}
+			state ^= state << 13;
+			state ^= state >> 7;
+			state ^= state << 17;
+			return state;
+		}
+
+		void popLocked(Heap & heap, T & value) {
+			std::pop_heap(heap.data.begin(), heap.data.end(), Inverted(_compare));
+			value = heap.data.back();
+			heap.data.pop_back();
+			heap.size.store(heap.data.size(), std::memory_order_relaxed);
+		}
+
+		/**
+		 * \brief locks two random heaps and keeps the one with the smaller top locked
+		 * returns nullptr if a lock was busy or both heaps are empty
+		 */
+		Heap * lockBest() {
+			size_t i = random() % _heapCount;
+			size_t j = random() % _heapCount;
+			if (i > j) {
+				std::swap(i, j);
+			}
+			Heap * a = &_heaps[i];
+			if (a->size.load(std::memory_order_relaxed) == 0) {
+				a = nullptr;
+			} else if (!a->lock.try_lock()) {
+				return nullptr;
+			}
+			Heap * b = (i == j) ? nullptr : &_heaps[j];
+			if (b != nullptr && (b->size.load(std::memory_order_relaxed) == 0 || !b->lock.try_lock())) {
+				b = nullptr;
+			}
+			if (a != nullptr && a->data.empty()) {
+				a->lock.unlock();
+				a = nullptr;
+			}
+			if (b != nullptr && b->data.empty()) {
+				b->lock.unlock();
+				b = nullptr;
+			}
+			if (a != nullptr && b != nullptr) {
+				if (_compare(b->data.front(), a->data.front())) {
+					std::swap(a, b);
+				}
+				b->lock.unlock();
+			}
+			return a != nullptr ? a : b;
+		}
+
+		/**
+		 * \brief checks all heaps with blocking locks, used when random probing failed
+		 */
+		bool scan(T & value) {
+			const size_t start = random() % _heapCount;
+			for (size_t k = 0; k < _heapCount; k++) {
+				Heap & heap = _heaps[(start + k) % _heapCount];
+				if (heap.size.load(std::memory_order_relaxed) == 0) {
+					continue;
+				}
+				std::lock_guard<SpinLock> lg(heap.lock);
+				if (!heap.data.empty()) {
+					popLocked(heap, value);
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/**
+		 * \brief forbidden
+		 */
+		ConcurrentPriorityQueue(const ConcurrentPriorityQueue &) = delete;
+		ConcurrentPriorityQueue & operator=(const ConcurrentPriorityQueue &) = delete;
+	};
+
+} /* namespace container */
+} /* namespace clockUtils */
+
+#endif /* __CLOCKUTILS_CONTAINER_CONCURRENTPRIORITYQUEUE_H__ */
+
+/**
+ * @}
+ */
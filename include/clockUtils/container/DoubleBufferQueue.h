@@ -41,8 +41,9 @@ namespace container {
 	 * T defines the data type being contained in the queue
 	 * producer tells whether more than one thread pushes data into the queue
 	 * consumer tells whether more than one thread pulls data from the queue
+	 * Lock defines the lock type guarding the read and the write buffer, e.g. std::mutex or one of the locks in Locks.h
 	 */
-	template<typename T, bool producer = true, bool consumer = true>
+	template<typename T, bool producer = true, bool consumer = true, typename Lock = std::mutex>
 	class DoubleBufferQueue {
 	private:
 		template<bool v>
@@ -63,7 +64,7 @@ namespace container {
 		 * \brief pushes the given value into the queue
 		 */
 		void push(const T & value) {
-			std::lock_guard<std::mutex> lg(_writeLock);
+			std::lock_guard<Lock> lg(_writeLock);
 			_queueWrite->push(value);
 		}
 
@@ -131,12 +132,12 @@ namespace container {
 		std::queue<T> * _queueRead;
 		std::queue<T> * _queueWrite;
 
-		std::mutex _readLock;
-		std::mutex _writeLock;
+		Lock _readLock;
+		Lock _writeLock;
 
 		ClockError pop(Bool2Type<true>) {
 			static_assert(consumer, "Consumer must be true here");
-			std::lock_guard<std::mutex> lg(_readLock);
+			std::lock_guard<Lock> lg(_readLock);
 			if (_queueRead->empty()) {
 				swap();
 			}
@@ -165,7 +166,7 @@ namespace container {
 
 		ClockError front(Bool2Type<true>, T & value) {
 			static_assert(consumer, "Consumer must be true here");
-			std::lock_guard<std::mutex> lg(_readLock);
+			std::lock_guard<Lock> lg(_readLock);
 			if (_queueRead->empty()) {
 				swap();
 			}
@@ -194,7 +195,7 @@ namespace container {
 
 		ClockError poll(Bool2Type<true>, T & value) {
 			static_assert(consumer, "Consumer must be true here");
-			std::lock_guard<std::mutex> lg(_readLock);
+			std::lock_guard<Lock> lg(_readLock);
 			if (_queueRead->empty()) {
 				swap();
 			}
@@ -227,7 +228,7 @@ namespace container {
 		 * \brief swaps read and write buffer
 		 */
 		void swap() {
-			std::lock_guard<std::mutex> lg(_writeLock);
+			std::lock_guard<Lock> lg(_writeLock);
 			if (_queueRead == &_queueA) {
 				_queueWrite = &_queueA;
 				_queueRead = &_queueB;
@@ -0,0 +1,110 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * \addtogroup container
+ * @{
+ */
+
+#ifndef __CLOCKUTILS_CONTAINER_FLATHASHMAP_H__
+#define __CLOCKUTILS_CONTAINER_FLATHASHMAP_H__
+
+#include <initializer_list>
+#include <tuple>
+
+#include "clockUtils/container/FlatHashTable.h"
+
+namespace clockUtils {
+namespace container {
+
+	/**
+	 * \brief extracts the key of a key value pair
+	 */
+	struct PairKeyOf {
+		template<typename Pair>
+		const typename Pair::first_type & operator()(const Pair & value) const {
+			return value.first;
+		}
+	};
+
+	/**
+	 * class FlatHashMap
+	 *
+	 * unordered map storing its elements inline in one open addressing table (see FlatHashTable)
+	 * supports the commonly used parts of the std::unordered_map interface, but iterators and references are invalidated by every insert
+	 * for heterogeneous lookup (e.g. find with a const char * on a map with std::string keys) use StringHash and StringEqual or any other transparent functors
+	 */
+	template<typename Key, typename T, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+	class FlatHashMap : public FlatHashTable<std::pair<const Key, T>, Key, PairKeyOf, Hash, KeyEqual> {
+		typedef FlatHashTable<std::pair<const Key, T>, Key, PairKeyOf, Hash, KeyEqual> Base;
+
+	public:
+		typedef T mapped_type;
+		typedef typename Base::value_type value_type;
+		typedef typename Base::iterator iterator;
+		typedef typename Base::const_iterator const_iterator;
+
+		FlatHashMap() : Base() {
+		}
+
+		FlatHashMap(std::initializer_list<value_type> values) : Base() {
+			Base::reserve(values.size());
+			for (const value_type & v : values) {
+				insert(v);
+			}
+		}
+
+		/**
+		 * \brief inserts value if its key doesn't exist yet
+		 * returns an iterator to the element with the key and whether the value was inserted
+		 */
+		std::pair<iterator, bool> insert(const value_type & value) {
+			return Base::emplaceKey(value.first, value);
+		}
+		std::pair<iterator, bool> insert(value_type && value) {
+			return Base::emplaceKey(value.first, std::move(value));
+		}
+
+		/**
+		 * \brief constructs the mapped value from args if key doesn't exist yet
+		 */
+		template<typename... Args>
+		std::pair<iterator, bool> emplace(const Key & key, Args &&... args) {
+			return Base::emplaceKey(key, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+		}
+
+		/**
+		 * \brief returns the value mapped to key, inserts a default constructed value if key doesn't exist yet
+		 */
+		T & operator[](const Key & key) {
+			return Base::emplaceKey(key, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple()).first->second;
+		}
+		T & operator[](Key && key) {
+			return Base::emplaceKey(key, std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple()).first->second;
+		}
+	};
+
+} /* namespace container */
+} /* namespace clockUtils */
+
+#endif /* __CLOCKUTILS_CONTAINER_FLATHASHMAP_H__ */
+
+/**
+ * @}
+ */
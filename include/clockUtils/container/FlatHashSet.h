@@ -0,0 +1,99 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * \addtogroup container
+ * @{
+ */
+
+#ifndef __CLOCKUTILS_CONTAINER_FLATHASHSET_H__
+#define __CLOCKUTILS_CONTAINER_FLATHASHSET_H__
+
+#include <initializer_list>
+
+#include "clockUtils/container/FlatHashTable.h"
+
+namespace clockUtils {
+namespace container {
+
+	/**
+	 * \brief uses the value itself as key
+	 */
+	struct IdentityKeyOf {
+		template<typename Value>
+		const Value & operator()(const Value & value) const {
+			return value;
+		}
+	};
+
+	/**
+	 * class FlatHashSet
+	 *
+	 * unordered set storing its elements inline in one open addressing table (see FlatHashTable)
+	 * supports the commonly used parts of the std::unordered_set interface, but iterators and references are invalidated by every insert
+	 * elements can't be modified through iterators, because this would change their hash
+	 */
+	template<typename Key, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+	class FlatHashSet : public FlatHashTable<Key, Key, IdentityKeyOf, Hash, KeyEqual> {
+		typedef FlatHashTable<Key, Key, IdentityKeyOf, Hash, KeyEqual> Base;
+
+	public:
+		typedef typename Base::value_type value_type;
+		typedef typename Base::const_iterator iterator;
+		typedef typename Base::const_iterator const_iterator;
+
+		FlatHashSet() : Base() {
+		}
+
+		FlatHashSet(std::initializer_list<Key> values) : Base() {
+			Base::reserve(values.size());
+			for (const Key & v : values) {
+				insert(v);
+			}
+		}
+
+		const_iterator begin() const {
+			return Base::begin();
+		}
+		const_iterator end() const {
+			return Base::end();
+		}
+
+		/**
+		 * \brief inserts value if it doesn't exist yet
+		 * returns an iterator to the element and whether the value was inserted
+		 */
+		std::pair<const_iterator, bool> insert(const Key & value) {
+			std::pair<typename Base::iterator, bool> result = Base::emplaceKey(value, value);
+			return std::make_pair(const_iterator(result.first), result.second);
+		}
+		std::pair<const_iterator, bool> insert(Key && value) {
+			std::pair<typename Base::iterator, bool> result = Base::emplaceKey(value, std::move(value));
+			return std::make_pair(const_iterator(result.first), result.second);
+		}
+	};
+
+} /* namespace container */
+} /* namespace clockUtils */
+
+#endif /* __CLOCKUTILS_CONTAINER_FLATHASHSET_H__ */
+
+/**
+ * @}
+ */
@@ -0,0 +1,582 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * \addtogroup container
+ * @{
+ */
+
+#ifndef __CLOCKUTILS_CONTAINER_FLATHASHTABLE_H__
+#define __CLOCKUTILS_CONTAINER_FLATHASHTABLE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "clockUtils/container/containerParameters.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define CLOCKUTILS_CONTAINER_SSE2
+	#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+namespace clockUtils {
+namespace container {
+
+	/**
+	 * \brief transparent hash for std::string keys, allows lookups with const char * without creating a temporary std::string
+	 */
+	struct StringHash {
+		typedef void is_transparent;
+
+		size_t operator()(const std::string & s) const {
+			return hash(s.data(), s.size());
+		}
+		size_t operator()(const char * s) const {
+			return hash(s, strlen(s));
+		}
+
+	private:
+		// FNV-1a
+		static size_t hash(const char * s, size_t length) {
+			uint64_t h = 14695981039346656037ULL;
+			for (size_t i = 0; i < length; i++) {
+				h ^= uint8_t(s[i]);
+				h *= 1099511628211ULL;
+			}
+			return size_t(h);
+		}
+	};
+
+	/**
+	 * \brief transparent equality for std::string keys, counterpart of StringHash
+	 */
+	struct StringEqual {
+		typedef void is_transparent;
+
+		bool operator()(const std::string & a, const std::string & b) const {
+			return a == b;
+		}
+		bool operator()(const std::string & a, const char * b) const {
+			return a == b;
+		}
+		bool operator()(const char * a, const std::string & b) const {
+			return b == a;
+		}
+	};
+
+	/**
+	 * class FlatHashTable
+	 *
+	 * open addressing hash table used by FlatHashMap and FlatHashSet
+	 * every slot has one control byte containing 7 bits of the hash or a marker for empty and deleted slots
+	 * lookups compare the control bytes of a group of 16 slots at once (using SSE2 if available) and only touch slots with matching hash bits
+	 * all elements are stored in one array, so there is no allocation per element and iterating doesn't chase pointers
+	 *
+	 * Value defines the type stored in a slot, Key the type used for lookups
+	 * KeyOf extracts the key out of a value
+	 */
+	template<typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual>
+	class FlatHashTable {
+	private:
+		typedef int8_t ctrl_t;
+
+		static const ctrl_t EMPTY = -128;
+		static const ctrl_t DELETED = -2;
+		static const size_t GROUP_WIDTH = 16;
+
+	public:
+		typedef Key key_type;
+		typedef Value value_type;
+		typedef size_t size_type;
+		typedef Hash hasher;
+		typedef KeyEqual key_equal;
+
+		template<bool Const>
+		class Iterator {
+			friend class FlatHashTable;
+
+		public:
+			typedef std::forward_iterator_tag iterator_category;
+			typedef Value value_type;
+			typedef ptrdiff_t difference_type;
+			typedef typename std::conditional<Const, const Value *, Value *>::type pointer;
+			typedef typename std::conditional<Const, const Value &, Value &>::type reference;
+
+			Iterator() : _ctrl(nullptr), _slot(nullptr), _end(nullptr) {
+			}
+
+			// iterator converts to const_iterator
+			Iterator(const Iterator<false> & other) : _ctrl(other._ctrl), _slot(other._slot), _end(other._end) {
+			}
+
+			reference operator*() const {
+				return *_slot;
+			}
+			pointer operator->() const {
+				return _slot;
+			}
+			Iterator & operator++() {
+				++_ctrl;
+				++_slot;
+				skipEmpty();
+				return *this;
+			}
+			Iterator operator++(int) {
+				Iterator tmp = *this;
+				++*this;
+				return tmp;
+			}
+			bool operator==(const Iterator & other) const {
+				return _ctrl == other._ctrl;
+			}
+			bool operator!=(const Iterator & other) const {
+				return _ctrl != other._ctrl;
+			}
+
+		private:
+			friend class Iterator<!Const>;
+
+			const ctrl_t * _ctrl;
+			pointer _slot;
+			const ctrl_t * _end;
+
+			Iterator(const ctrl_t * ctrl, pointer slot, const ctrl_t * end) : _ctrl(ctrl), _slot(slot), _end(end) {
+			}
+
+			void skipEmpty() {
+				while (_ctrl != _end && *_ctrl < 0) {
+					++_ctrl;
+					++_slot;
+				}
+			}
+		};
+
+		typedef Iterator<false> iterator;
+		typedef Iterator<true> const_iterator;
+
+		FlatHashTable() : _ctrl(nullptr), _slots(nullptr), _capacity(0), _size(0), _growthLeft(0), _hash(), _equal() {
+		}
+
+		FlatHashTable(const FlatHashTable & other) : _ctrl(nullptr), _slots(nullptr), _capacity(0), _size(0), _growthLeft(0), _hash(other._hash), _equal(other._equal) {
+			reserve(other._size);
+			for (const Value & v : other) {
+				insertUnique(v);
+			}
+		}
+
+		FlatHashTable(FlatHashTable && other) : _ctrl(other._ctrl), _slots(other._slots), _capacity(other._capacity), _size(other._size), _growthLeft(other._growthLeft), _hash(std::move(other._hash)), _equal(std::move(other._equal)) {
+			other._ctrl = nullptr;
+			other._slots = nullptr;
+			other._capacity = 0;
+			other._size = 0;
+			other._growthLeft = 0;
+		}
+
+		~FlatHashTable() {
+			destroy();
+		}
+
+		FlatHashTable & operator=(FlatHashTable other) {
+			swap(other);
+			return *this;
+		}
+
+		void swap(FlatHashTable & other) {
+			std::swap(_ctrl, other._ctrl);
+			std::swap(_slots, other._slots);
+			std::swap(_capacity, other._capacity);
+			std::swap(_size, other._size);
+			std::swap(_growthLeft, other._growthLeft);
+			std::swap(_hash, other._hash);
+			std::swap(_equal, other._equal);
+		}
+
+		iterator begin() {
+			iterator it(_ctrl, _slots, _ctrl + _capacity);
+			it.skipEmpty();
+			return it;
+		}
+		iterator end() {
+			return iterator(_ctrl + _capacity, _slots + _capacity, _ctrl + _capacity);
+		}
+		const_iterator begin() const {
+			const_iterator it(_ctrl, _slots, _ctrl + _capacity);
+			it.skipEmpty();
+			return it;
+		}
+		const_iterator end() const {
+			return const_iterator(_ctrl + _capacity, _slots + _capacity, _ctrl + _capacity);
+		}
+		const_iterator cbegin() const {
+			return begin();
+		}
+		const_iterator cend() const {
+			return end();
+		}
+
+		/**
+		 * \brief returns true if the table is empty, otherwise false
+		 */
+		bool empty() const {
+			return _size == 0;
+		}
+
+		/**
+		 * \brief returns the amount of elements
+		 */
+		size_t size() const {
+			return _size;
+		}
+
+		/**
+		 * \brief returns the amount of slots
+		 */
+		size_t capacity() const {
+			return _capacity;
+		}
+
+		/**
+		 * \brief removes all elements, keeps the allocated memory
+		 */
+		void clear() {
+			for (size_t i = 0; i < _capacity; i++) {
+				if (_ctrl[i] >= 0) {
+					_slots[i].~Value();
+				}
+			}
+			if (_capacity > 0) {
+				memset(_ctrl, EMPTY, _capacity);
+			}
+			_size = 0;
+			_growthLeft = maxLoad(_capacity);
+		}
+
+		/**
+		 * \brief allocates enough slots for count elements, so inserting them doesn't rehash
+		 */
+		void reserve(size_t count) {
+			if (count <= _size + _growthLeft) {
+				return;
+			}
+			size_t capacity = GROUP_WIDTH;
+			while (maxLoad(capacity) < count) {
+				capacity *= 2;
+			}
+			// rehashing with the same capacity drops deleted slots
+			rehash(capacity > _capacity ? capacity : _capacity);
+		}
+
+		/**
+		 * \brief returns an iterator to the element with the given key or end()
+		 */
+		iterator find(const Key & key) {
+			return findImpl(key);
+		}
+		const_iterator find(const Key & key) const {
+			return const_cast<FlatHashTable *>(this)->findImpl(key);
+		}
+
+		/**
+		 * \brief heterogeneous lookup, only available if Hash and KeyEqual define is_transparent
+		 */
+		template<typename K, typename H = Hash, typename = typename H::is_transparent, typename E = KeyEqual, typename = typename E::is_transparent>
+		iterator find(const K & key) {
+			return findImpl(key);
+		}
+		template<typename K, typename H = Hash, typename = typename H::is_transparent, typename E = KeyEqual, typename = typename E::is_transparent>
+		const_iterator find(const K & key) const {
+			return const_cast<FlatHashTable *>(this)->findImpl(key);
+		}
+
+		/**
+		 * \brief returns 1 if an element with the given key exists, otherwise 0
+		 */
+		size_t count(const Key & key) const {
+			return find(key) == end() ? 0 : 1;
+		}
+		template<typename K, typename H = Hash, typename = typename H::is_transparent, typename E = KeyEqual, typename = typename E::is_transparent>
+		size_t count(const K & key) const {
+			return find(key) == end() ? 0 : 1;
+		}
+
+		/**
+		 * \brief removes the element at the given position, returns iterator to the next element
+		 */
+		iterator erase(const_iterator pos) {
+			const size_t index = size_t(pos._ctrl - _ctrl);
+			eraseAt(index);
+			iterator it(_ctrl + index, _slots + index, _ctrl + _capacity);
+			it.skipEmpty();
+			return it;
+		}
+
+		/**
+		 * \brief removes the element with the given key, returns the amount of removed elements
+		 */
+		size_t erase(const Key & key) {
+			iterator it = find(key);
+			if (it == end()) {
+				return 0;
+			}
+			eraseAt(size_t(it._ctrl - _ctrl));
+			return 1;
+		}
+
+	protected:
+		/**
+		 * \brief looks for key and constructs a new value with args if it doesn't exist
+		 */
+		template<typename K, typename... Args>
+		std::pair<iterator, bool> emplaceKey(const K & key, Args &&... args) {
+			const size_t hash = hashOf(key);
+			iterator it = findImpl(key, hash);
+			if (it != end()) {
+				return std::make_pair(it, false);
+			}
+			if (_growthLeft == 0) {
+				grow();
+			}
+			const size_t index = findInsertSlot(hash);
+			new (_slots + index) Value(std::forward<Args>(args)...);
+			if (_ctrl[index] == EMPTY) {
+				_growthLeft--;
+			}
+			_ctrl[index] = h2(hash);
+			_size++;
+			return std::make_pair(iterator(_ctrl + index, _slots + index, _ctrl + _capacity), true);
+		}
+
+	private:
+		ctrl_t * _ctrl;
+		Value * _slots;
+		size_t _capacity;
+		size_t _size;
+
+		/**
+		 * \brief amount of empty slots that can still be used before the table has to grow
+		 */
+		size_t _growthLeft;
+
+		Hash _hash;
+		KeyEqual _equal;
+
+		/**
+		 * \brief maximum load factor 7/8
+		 */
+		static size_t maxLoad(size_t capacity) {
+			return capacity - capacity / 8;
+		}
+
+		template<typename K>
+		size_t hashOf(const K & key) const {
+			// mix the bits, many std::hash implementations just return the value
+			uint64_t h = uint64_t(_hash(key)) * 0x9E3779B97F4A7C15ULL;
+			return size_t(h ^ (h >> 32));
+		}
+
+		static ctrl_t h2(size_t hash) {
+			return ctrl_t(hash & 0x7F);
+		}
+
+		static uint32_t countTrailingZeros(uint32_t mask) {
+#if defined(_MSC_VER)
+			unsigned long index;
+			_BitScanForward(&index, mask);
+			return uint32_t(index);
+#else
+			return uint32_t(__builtin_ctz(mask));
+#endif
+		}
+
+		/**
+		 * \brief bitmask of the slots in the group whose control byte equals value
+		 */
+		static uint32_t match(const ctrl_t * group, ctrl_t value) {
+#ifdef CLOCKUTILS_CONTAINER_SSE2
+			const __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(group));
+			return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(value))));
+#else
+			uint32_t mask = 0;
+			for (size_t i = 0; i < GROUP_WIDTH; i++) {
+				mask |= uint32_t(group[i] == value) << i;
+			}
+			return mask;
+#endif
+		}
+
+		/**
+		 * \brief bitmask of the empty and deleted slots in the group
+		 */
+		static uint32_t matchFree(const ctrl_t * group) {
+#ifdef CLOCKUTILS_CONTAINER_SSE2
+			return uint32_t(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(group))));
+#else
+			uint32_t mask = 0;
+			for (size_t i = 0; i < GROUP_WIDTH; i++) {
+				mask |= uint32_t(group[i] < 0) << i;
+			}
+			return mask;
+#endif
+		}
+
+		template<typename K>
+		iterator findImpl(const K & key) {
+			return findImpl(key, hashOf(key));
+		}
+
+		template<typename K>
+		iterator findImpl(const K & key, size_t hash) {
+			if (_capacity == 0) {
+				return end();
+			}
+			const size_t groupMask = _capacity / GROUP_WIDTH - 1;
+			size_t group = (hash >> 7) & groupMask;
+			for (size_t step = 1; ; step++) {
+				const ctrl_t * ctrl = _ctrl + group * GROUP_WIDTH;
+				for (uint32_t mask = match(ctrl, h2(hash)); mask != 0; mask &= mask - 1) {
+					const size_t index = group * GROUP_WIDTH + countTrailingZeros(mask);
+					if (_equal(KeyOf()(_slots[index]), key)) {
+						return iterator(_ctrl + index, _slots + index, _ctrl + _capacity);
+					}
+				}
+				// an empty slot ends the probe sequence, the key would have been inserted there
+				if (match(ctrl, EMPTY) != 0 || step > groupMask) {
+					return end();
+				}
+				// triangular probing visits every group once for power of two group counts
+				group = (group + step) & groupMask;
+			}
+		}
+
+		/**
+		 * \brief returns the first empty or deleted slot in the probe sequence of hash
+		 */
+		size_t findInsertSlot(size_t hash) const {
+			const size_t groupMask = _capacity / GROUP_WIDTH - 1;
+			size_t group = (hash >> 7) & groupMask;
+			for (size_t step = 1; ; step++) {
+				const uint32_t mask = matchFree(_ctrl + group * GROUP_WIDTH);
+				if (mask != 0) {
+					return group * GROUP_WIDTH + countTrailingZeros(mask);
+				}
+				group = (group + step) & groupMask;
+			}
+		}
+
+		/**
+		 * \brief inserts a value known not to be in the table, there has to be space left
+		 */
+		void insertUnique(const Value & value) {
+			const size_t hash = hashOf(KeyOf()(value));
+			const size_t index = findInsertSlot(hash);
+			new (_slots + index) Value(value);
+			_ctrl[index] = h2(hash);
+			_size++;
+			_growthLeft--;
+		}
+
+		void eraseAt(size_t index) {
+			_slots[index].~Value();
+			_size--;
+			// if the group still has an empty slot, no probe sequence runs through it, so the slot can be marked empty instead of deleted
+			const size_t group = index / GROUP_WIDTH * GROUP_WIDTH;
+			if (match(_ctrl + group, EMPTY) != 0) {
+				_ctrl[index] = EMPTY;
+				_growthLeft++;
+			} else {
+				_ctrl[index] = DELETED;
+			}
+		}
+
+		void grow() {
+			// many deleted slots: rehashing in place is enough
+			if (_capacity > 0 && _size < maxLoad(_capacity) / 2) {
+				rehash(_capacity);
+			} else {
+				rehash(_capacity == 0 ? GROUP_WIDTH : _capacity * 2);
+			}
+		}
+
+		void rehash(size_t capacity) {
+			ctrl_t * oldCtrl = _ctrl;
+			Value * oldSlots = _slots;
+			const size_t oldCapacity = _capacity;
+
+			_ctrl = new ctrl_t[capacity];
+			memset(_ctrl, EMPTY, capacity);
+			_slots = std::allocator<Value>().allocate(capacity);
+			_capacity = capacity;
+			_size = 0;
+			_growthLeft = maxLoad(capacity);
+
+			for (size_t i = 0; i < oldCapacity; i++) {
+				if (oldCtrl[i] >= 0) {
+					const size_t hash = hashOf(KeyOf()(oldSlots[i]));
+					const size_t index = findInsertSlot(hash);
+					new (_slots + index) Value(std::move(oldSlots[i]));
+					oldSlots[i].~Value();
+					_ctrl[index] = h2(hash);
+					_size++;
+					_growthLeft--;
+				}
+			}
+			if (oldCapacity > 0) {
+				std::allocator<Value>().deallocate(oldSlots, oldCapacity);
+				delete[] oldCtrl;
+			}
+		}
+
+		void destroy() {
+			if (_capacity == 0) {
+				return;
+			}
+			for (size_t i = 0; i < _capacity; i++) {
+				if (_ctrl[i] >= 0) {
+					_slots[i].~Value();
+				}
+			}
+			std::allocator<Value>().deallocate(_slots, _capacity);
+			delete[] _ctrl;
+			_ctrl = nullptr;
+			_slots = nullptr;
+			_capacity = 0;
+			_size = 0;
+			_growthLeft = 0;
+		}
+	};
+
+} /* namespace container */
+} /* namespace clockUtils */
+
+#endif /* __CLOCKUTILS_CONTAINER_FLATHASHTABLE_H__ */
+
+/**
+ * @}
+ */
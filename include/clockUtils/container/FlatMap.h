@@ -0,0 +1,312 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * \addtogroup container
+ * @{
+ */
+
+#ifndef __CLOCKUTILS_CONTAINER_FLATMAP_H__
+#define __CLOCKUTILS_CONTAINER_FLATMAP_H__
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "clockUtils/container/containerParameters.h"
+
+namespace clockUtils {
+namespace container {
+
+	/**
+	 * class FlatMap
+	 *
+	 * ordered map storing its elements sorted in one contiguous vector
+	 * lookups are binary searches over contiguous memory and iterating is as fast as iterating a vector, inserting and erasing are O(n)
+	 * best suited for maps that are built once and read often, e.g. configurations or lookup tables
+	 * iterators and references are invalidated by insert and erase
+	 * keys must not be modified through iterators
+	 * if Compare defines is_transparent (e.g. std::less<> in C++14), find, count, lower_bound and upper_bound accept every type comparable with Key
+	 */
+	template<typename Key, typename T, typename Compare = std::less<Key>>
+	class FlatMap {
+	public:
+		typedef Key key_type;
+		typedef T mapped_type;
+		typedef std::pair<Key, T> value_type;
+		typedef Compare key_compare;
+		typedef typename std::vector<value_type>::iterator iterator;
+		typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+		FlatMap() : _values(), _compare() {
+		}
+
+		explicit FlatMap(const Compare & compare) : _values(), _compare(compare) {
+		}
+
+		/**
+		 * \brief creates the map from unsorted values, for duplicate keys the first value is used
+		 */
+		FlatMap(std::initializer_list<value_type> values, const Compare & compare = Compare()) : _values(values), _compare(compare) {
+			sortValues();
+		}
+
+		/**
+		 * \brief creates the map from unsorted values, for duplicate keys the first value is used
+		 * cheaper than inserting the values one by one
+		 */
+		explicit FlatMap(std::vector<value_type> values, const Compare & compare = Compare()) : _values(std::move(values)), _compare(compare) {
+			sortValues();
+		}
+
+		iterator begin() {
+			return _values.begin();
+		}
+		iterator end() {
+			return _values.end();
+		}
+		const_iterator begin() const {
+			return _values.begin();
+		}
+		const_iterator end() const {
+			return _values.end();
+		}
+		const_iterator cbegin() const {
+			return _values.cbegin();
+		}
+		const_iterator cend() const {
+			return _values.cend();
+		}
+
+		/**
+		 * \brief returns true if the map is empty, otherwise false
+		 */
+		bool empty() const {
+			return _values.empty();
+		}
+
+		/**
+		 * \brief returns the amount of elements
+		 */
+		size_t size() const {
+			return _values.size();
+		}
+
+		/**
+		 * \brief returns the amount of elements the map can hold without reallocating
+		 */
+		size_t capacity() const {
+			return _values.capacity();
+		}
+
+		/**
+		 * \brief reserves memory for count elements
+		 */
+		void reserve(size_t count) {
+			_values.reserve(count);
+		}
+
+		/**
+		 * \brief releases unused memory
+		 */
+		void shrink_to_fit() {
+			_values.shrink_to_fit();
+		}
+
+		/**
+		 * \brief removes all elements
+		 */
+		void clear() {
+			_values.clear();
+		}
+
+		/**
+		 * \brief inserts value if its key doesn't exist yet
+		 * returns an iterator to the element with the key and whether the value was inserted
+		 */
+		std::pair<iterator, bool> insert(const value_type & value) {
+			iterator it = lower_bound(value.first);
+			if (it != _values.end() && !_compare(value.first, it->first)) {
+				return std::make_pair(it, false);
+			}
+			return std::make_pair(_values.insert(it, value), true);
+		}
+		std::pair<iterator, bool> insert(value_type && value) {
+			iterator it = lower_bound(value.first);
+			if (it != _values.end() && !_compare(value.first, it->first)) {
+				return std::make_pair(it, false);
+			}
+			return std::make_pair(_values.insert(it, std::move(value)), true);
+		}
+
+		/**
+		 * \brief constructs the mapped value from args if key doesn't exist yet
+		 */
+		template<typename... Args>
+		std::pair<iterator, bool> emplace(const Key & key, Args &&... args) {
+			iterator it = lower_bound(key);
+			if (it != _values.end() && !_compare(key, it->first)) {
+				return std::make_pair(it, false);
+			}
+			return std::make_pair(_values.emplace(it, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...)), true);
+		}
+
+		/**
+		 * \brief returns the value mapped to key, inserts a default constructed value if key doesn't exist yet
+		 */
+		T & operator[](const Key & key) {
+			return emplace(key).first->second;
+		}
+
+		/**
+		 * \brief removes the element at the given position, returns iterator to the next element
+		 */
+		iterator erase(const_iterator pos) {
+			return _values.erase(pos);
+		}
+
+		/**
+		 * \brief removes the element with the given key, returns the amount of removed elements
+		 */
+		size_t erase(const Key & key) {
+			iterator it = find(key);
+			if (it == _values.end()) {
+				return 0;
+			}
+			_values.erase(it);
+			return 1;
+		}
+
+		/**
+		 * \brief returns an iterator to the element with the given key or end()
+		 */
+		iterator find(const Key & key) {
+			return findImpl<Key>(key);
+		}
+		const_iterator find(const Key & key) const {
+			return const_cast<FlatMap *>(this)->findImpl<Key>(key);
+		}
+
+		/**
+		 * \brief returns 1 if an element with the given key exists, otherwise 0
+		 */
+		size_t count(const Key & key) const {
+			return find(key) == _values.end() ? 0 : 1;
+		}
+
+		/**
+		 * \brief returns an iterator to the first element with a key not less than key
+		 */
+		iterator lower_bound(const Key & key) {
+			return std::lower_bound(_values.begin(), _values.end(), key, KeyCompare<Key>(_compare));
+		}
+		const_iterator lower_bound(const Key & key) const {
+			return std::lower_bound(_values.begin(), _values.end(), key, KeyCompare<Key>(_compare));
+		}
+
+		/**
+		 * \brief returns an iterator to the first element with a key greater than key
+		 */
+		iterator upper_bound(const Key & key) {
+			return std::upper_bound(_values.begin(), _values.end(), key, KeyCompare<Key>(_compare));
+		}
+		const_iterator upper_bound(const Key & key) const {
+			return std::upper_bound(_values.begin(), _values.end(), key, KeyCompare<Key>(_compare));
+		}
+
+		/**
+		 * \brief heterogeneous lookups, only available if Compare defines is_transparent
+		 */
+		template<typename K, typename C = Compare, typename = typename C::is_transparent>
+		iterator find(const K & key) {
+			return findImpl<K>(key);
+		}
+		template<typename K, typename C = Compare, typename = typename C::is_transparent>
+		const_iterator find(const K & key) const {
+			return const_cast<FlatMap *>(this)->findImpl<K>(key);
+		}
+		template<typename K, typename C = Compare, typename = typename C::is_transparent>
+		size_t count(const K & key) const {
+			return find(key) == _values.end() ? 0 : 1;
+		}
+		template<typename K, typename C = Compare, typename = typename C::is_transparent>
+		iterator lower_bound(const K & key) {
+			return std::lower_bound(_values.begin(), _values.end(), key, KeyCompare<K>(_compare));
+		}
+		template<typename K, typename C = Compare, typename = typename C::is_transparent>
+		const_iterator lower_bound(const K & key) const {
+			return std::lower_bound(_values.begin(), _values.end(), key, KeyCompare<K>(_compare));
+		}
+		template<typename K, typename C = Compare, typename = typename C::is_transparent>
+		iterator upper_bound(const K & key) {
+			return std::upper_bound(_values.begin(), _values.end(), key, KeyCompare<K>(_compare));
+		}
+		template<typename K, typename C = Compare, typename = typename C::is_transparent>
+		const_iterator upper_bound(const K & key) const {
+			return std::upper_bound(_values.begin(), _values.end(), key, KeyCompare<K>(_compare));
+		}
+
+	private:
+		std::vector<value_type> _values;
+		Compare _compare;
+
+		/**
+		 * \brief compares elements with keys for lower_bound and upper_bound
+		 */
+		template<typename K>
+		struct KeyCompare {
+			const Compare & compare;
+
+			explicit KeyCompare(const Compare & c) : compare(c) {
+			}
+			bool operator()(const value_type & value, const K & key) const {
+				return compare(value.first, key);
+			}
+			bool operator()(const K & key, const value_type & value) const {
+				return compare(key, value.first);
+			}
+		};
+
+		template<typename K>
+		iterator findImpl(const K & key) {
+			iterator it = std::lower_bound(_values.begin(), _values.end(), key, KeyCompare<K>(_compare));
+			return (it != _values.end() && !_compare(key, it->first)) ? it : _values.end();
+		}
+
+		void sortValues() {
+			std::stable_sort(_values.begin(), _values.end(), [this](const value_type & a, const value_type & b) {
+				return _compare(a.first, b.first);
+			});
+			_values.erase(std::unique(_values.begin(), _values.end(), [this](const value_type & a, const value_type & b) {
+				return !_compare(a.first, b.first) && !_compare(b.first, a.first);
+			}), _values.end());
+		}
+	};
+
+} /* namespace container */
+} /* namespace clockUtils */
+
+#endif /* __CLOCKUTILS_CONTAINER_FLATMAP_H__ */
+
+/**
+ * @}
+ */
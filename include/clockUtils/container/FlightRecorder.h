@@ -0,0 +1,213 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * \addtogroup container
+ * @{
+ */
+
+#ifndef __CLOCKUTILS_CONTAINER_FLIGHTRECORDER_H__
+#define __CLOCKUTILS_CONTAINER_FLIGHTRECORDER_H__
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "clockUtils/container/containerParameters.h"
+
+namespace clockUtils {
+namespace container {
+
+	/**
+	 * class FlightRecorder
+	 *
+	 * ring buffer keeping the last SIZE recorded events, e.g. for post-mortem debugging
+	 * record() never blocks and never fails: it claims a slot with a single fetch_add and overwrites the oldest entry
+	 * every slot is stamped with the sequence number of its entry, so snapshot() can copy the ring while writers continue and skips entries that were overwritten during the copy
+	 * if a writer is preempted for a whole lap of the ring, the slot it is writing is marked as torn and the newer entry for this slot is dropped instead of mixing the two, dropped() counts these entries so the loss is visible post-mortem
+	 * T defines the type of the entries, it has to be trivially copyable
+	 * SIZE defines the amount of entries, it has to be a power of two
+	 */
+	template<typename T, size_t SIZE>
+	class FlightRecorder {
+		static_assert(std::is_trivially_copyable<T>::value, "FlightRecorder requires a trivially copyable type");
+		static_assert(SIZE > 0 && (SIZE & (SIZE - 1)) == 0, "SIZE has to be a power of two");
+
+	public:
+		/**
+		 * \brief entry returned by snapshot()
+		 */
+		struct Entry {
+			/**
+			 * \brief position in the order of all recorded events, starting at 0
+			 */
+			uint64_t sequence;
+			T value;
+		};
+
+		/**
+		 * \brief default constructor
+		 */
+		FlightRecorder() : _head(0), _dropped(0), _slots(new Slot[SIZE]) {
+			for (size_t i = 0; i < SIZE; i++) {
+				_slots[i].stamp.store(0, std::memory_order_relaxed);
+			}
+		}
+
+		/**
+		 * \brief records value and overwrites the oldest entry if the ring is full
+		 */
+		void record(const T & value) {
+			const uint64_t ticket = _head.fetch_add(1, std::memory_order_relaxed);
+			Slot & slot = _slots[ticket & (SIZE - 1)];
+			const uint64_t writing = stamp(ticket, WRITING);
+
+			uint64_t current = slot.stamp.load(std::memory_order_relaxed);
+			for (;;) {
+				if (current >= writing) {
+					// a newer entry already claimed the slot, this one is lost anyway
+					return;
+				}
+				if ((current & STATE_MASK) == WRITING || (current & STATE_MASK) == TORN_BUSY) {
+					// an older writer is still busy with this slot, drop this entry and let the older writer mark the slot as torn
+					if (slot.stamp.compare_exchange_weak(current, stamp(ticket, TORN_BUSY), std::memory_order_relaxed)) {
+						_dropped.fetch_add(1, std::memory_order_relaxed);
+						return;
+					}
+				} else if (slot.stamp.compare_exchange_weak(current, writing, std::memory_order_relaxed)) {
+					break;
+				}
+			}
+
+			std::atomic_thread_fence(std::memory_order_release);
+			uint64_t buffer[WORDS] = { 0 };
+			memcpy(buffer, &value, sizeof(T));
+			for (size_t i = 0; i < WORDS; i++) {
+				slot.data[i].store(buffer[i], std::memory_order_relaxed);
+			}
+
+			current = writing;
+			if (!slot.stamp.compare_exchange_strong(current, stamp(ticket, DONE), std::memory_order_release, std::memory_order_relaxed)) {
+				// newer writers gave up on this slot while this entry was written, nobody is writing anymore
+				_dropped.fetch_add(1, std::memory_order_relaxed);
+				while (!slot.stamp.compare_exchange_weak(current, (current & ~STATE_MASK) | TORN, std::memory_order_release, std::memory_order_relaxed)) {
+				}
+			}
+		}
+
+		/**
+		 * \brief copies the currently available entries into entries, oldest first
+		 * returns the amount of entries of the last SIZE events that were skipped because they were torn, still being written or overwritten during the copy
+		 */
+		size_t snapshot(std::vector<Entry> & entries) const {
+			entries.clear();
+			const uint64_t head = _head.load(std::memory_order_acquire);
+			const uint64_t first = head > SIZE ? head - SIZE : 0;
+			entries.reserve(size_t(head - first));
+			size_t skipped = 0;
+			for (uint64_t ticket = first; ticket < head; ticket++) {
+				Entry entry;
+				if (read(ticket, entry.value)) {
+					entry.sequence = ticket;
+					entries.push_back(entry);
+				} else {
+					skipped++;
+				}
+			}
+			return skipped;
+		}
+
+		/**
+		 * \brief returns the amount of events recorded since construction, including overwritten ones
+		 */
+		uint64_t recorded() const {
+			return _head.load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * \brief returns the amount of entries that were lost because their slot was torn by a writer lapped by the ring
+		 * entries that are regularly overwritten by newer ones aren't counted
+		 */
+		uint64_t dropped() const {
+			return _dropped.load(std::memory_order_relaxed);
+		}
+
+	private:
+		static const size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+		/**
+		 * \brief the lower two bits of a stamp contain the state of the slot, the upper bits the ticket + 1
+		 * 0 means the slot was never written
+		 */
+		static const uint64_t STATE_MASK = 3;
+		static const uint64_t TORN = 0;
+		static const uint64_t WRITING = 1;
+		static const uint64_t DONE = 2;
+		static const uint64_t TORN_BUSY = 3;
+
+		struct Slot {
+			std::atomic<uint64_t> stamp;
+			std::array<std::atomic<uint64_t>, WORDS> data;
+		};
+
+		alignas(64) std::atomic<uint64_t> _head;
+		std::atomic<uint64_t> _dropped;
+		alignas(64) std::unique_ptr<Slot[]> _slots;
+
+		static uint64_t stamp(uint64_t ticket, uint64_t state) {
+			return ((ticket + 1) << 2) | state;
+		}
+
+		bool read(uint64_t ticket, T & value) const {
+			const Slot & slot = _slots[ticket & (SIZE - 1)];
+			const uint64_t before = slot.stamp.load(std::memory_order_acquire);
+			if (before != stamp(ticket, DONE)) {
+				return false;
+			}
+			uint64_t buffer[WORDS];
+			for (size_t i = 0; i < WORDS; i++) {
+				buffer[i] = slot.data[i].load(std::memory_order_relaxed);
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (slot.stamp.load(std::memory_order_relaxed) != before) {
+				return false;
+			}
+			memcpy(&value, buffer, sizeof(T));
+			return true;
+		}
+
+		/**
+		 * \brief forbidden
+		 */
+		FlightRecorder(const FlightRecorder &) = delete;
+		FlightRecorder & operator=(const FlightRecorder &) = delete;
+	};
+
+} /* namespace container */
+} /* namespace clockUtils */
+
+#endif /* __CLOCKUTILS_CONTAINER_FLIGHTRECORDER_H__ */
+
+/**
+ * @}
+ */
@@ -28,6 +28,8 @@
 #include <array>
 #include <atomic>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 
 #include "clockUtils/errors.h"
 
@@ -0,0 +1,387 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * \addtogroup container
+ * @{
+ */
+
+#ifndef __CLOCKUTILS_CONTAINER_LOCKS_H__
+#define __CLOCKUTILS_CONTAINER_LOCKS_H__
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "clockUtils/container/containerParameters.h"
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#elif defined(__i386__) || defined(__x86_64__)
+	#include <immintrin.h>
+#endif
+
+namespace clockUtils {
+namespace container {
+
+	/**
+	 * \brief tells the cpu that the calling thread is busy waiting
+	 * reduces power consumption and the penalty when leaving the spin loop
+	 */
+	inline void cpuRelax() {
+#if defined(_MSC_VER)
+		_mm_pause();
+#elif defined(__i386__) || defined(__x86_64__)
+		_mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+		__asm__ __volatile__("yield");
+#else
+		std::this_thread::yield();
+#endif
+	}
+
+	/**
+	 * \brief exponential backoff for spin loops
+	 * after some rounds the thread yields, so a preempted lock holder can continue when there are more threads than cores
+	 */
+	class SpinWait {
+	public:
+		SpinWait() : _round(0) {
+		}
+
+		/**
+		 * \brief waits a bit longer than the last time
+		 */
+		void wait() {
+			if (_round < YIELD_ROUND) {
+				for (uint32_t i = 0; i < (1u << _round); i++) {
+					cpuRelax();
+				}
+				_round++;
+			} else {
+				std::this_thread::yield();
+			}
+		}
+
+	private:
+		static const uint32_t YIELD_ROUND = 7;
+
+		uint32_t _round;
+	};
+
+	/**
+	 * class SpinLock
+	 *
+	 * test and test-and-set lock with exponential backoff
+	 * best suited for very short critical sections with low contention
+	 * all locks in this file fulfill the Lockable concept and can be used with std::lock_guard
+	 */
+	class SpinLock {
+	public:
+		/**
+		 * \brief default constructor
+		 */
+		SpinLock() : _locked(false) {
+		}
+
+		/**
+		 * \brief blocks until the lock is acquired
+		 */
+		void lock() {
+			SpinWait spinWait;
+			while (_locked.exchange(true, std::memory_order_acquire)) {
+				// spin on a plain load to keep the cache line shared while the lock is held
+				do {
+					spinWait.wait();
+				} while (_locked.load(std::memory_order_relaxed));
+			}
+		}
+
+		/**
+		 * \brief tries to acquire the lock without waiting, returns true on success
+		 */
+		bool try_lock() {
+			return !_locked.load(std::memory_order_relaxed) && !_locked.exchange(true, std::memory_order_acquire);
+		}
+
+		/**
+		 * \brief releases the lock
+		 */
+		void unlock() {
+			_locked.store(false, std::memory_order_release);
+		}
+
+	private:
+		std::atomic<bool> _locked;
+
+		/**
+		 * \brief forbidden
+		 */
+		SpinLock(const SpinLock &) = delete;
+		SpinLock & operator=(const SpinLock &) = delete;
+	};
+
+	/**
+	 * class TicketLock
+	 *
+	 * fair spin lock, threads acquire the lock in the order they called lock()
+	 */
+	class TicketLock {
+	public:
+		/**
+		 * \brief default constructor
+		 */
+		TicketLock() : _next(0), _serving(0) {
+		}
+
+		/**
+		 * \brief blocks until the lock is acquired
+		 */
+		void lock() {
+			const uint32_t ticket = _next.fetch_add(1, std::memory_order_relaxed);
+			SpinWait spinWait;
+			while (_serving.load(std::memory_order_acquire) != ticket) {
+				spinWait.wait();
+			}
+		}
+
+		/**
+		 * \brief tries to acquire the lock without waiting, returns true on success
+		 */
+		bool try_lock() {
+			uint32_t ticket = _serving.load(std::memory_order_relaxed);
+			return _next.compare_exchange_strong(ticket, ticket + 1, std::memory_order_acquire, std::memory_order_relaxed);
+		}
+
+		/**
+		 * \brief releases the lock
+		 */
+		void unlock() {
+			_serving.store(_serving.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		}
+
+	private:
+		std::atomic<uint32_t> _next;
+		std::atomic<uint32_t> _serving;
+
+		/**
+		 * \brief forbidden
+		 */
+		TicketLock(const TicketLock &) = delete;
+		TicketLock & operator=(const TicketLock &) = delete;
+	};
+
+	/**
+	 * class MCSLock
+	 *
+	 * fair queue lock, every waiting thread spins on its own node instead of a shared flag
+	 * this keeps the lock scalable with many waiting threads
+	 * the queue nodes are taken from a small per thread stack, so nested MCSLocks have to be released in reverse order of acquisition (as std::lock_guard does)
+	 */
+	class MCSLock {
+	public:
+		/**
+		 * \brief default constructor
+		 */
+		MCSLock() : _tail(nullptr), _owner(nullptr) {
+		}
+
+		/**
+		 * \brief blocks until the lock is acquired
+		 */
+		void lock() {
+			Node * node = acquireNode();
+			node->next.store(nullptr, std::memory_order_relaxed);
+			node->locked.store(true, std::memory_order_relaxed);
+			Node * predecessor = _tail.exchange(node, std::memory_order_acq_rel);
+			if (predecessor != nullptr) {
+				predecessor->next.store(node, std::memory_order_release);
+				SpinWait spinWait;
+				while (node->locked.load(std::memory_order_acquire)) {
+					spinWait.wait();
+				}
+			}
+			_owner = node;
+		}
+
+		/**
+		 * \brief tries to acquire the lock without waiting, returns true on success
+		 */
+		bool try_lock() {
+			Node * node = acquireNode();
+			node->next.store(nullptr, std::memory_order_relaxed);
+			Node * expected = nullptr;
+			if (!_tail.compare_exchange_strong(expected, node, std::memory_order_acquire, std::memory_order_relaxed)) {
+				releaseNode(node);
+				return false;
+			}
+			_owner = node;
+			return true;
+		}
+
+		/**
+		 * \brief releases the lock and hands it over to the next waiting thread
+		 */
+		void unlock() {
+			Node * node = _owner;
+			assert(node);
+			Node * successor = node->next.load(std::memory_order_acquire);
+			if (successor == nullptr) {
+				Node * expected = node;
+				if (_tail.compare_exchange_strong(expected, nullptr, std::memory_order_release, std::memory_order_relaxed)) {
+					releaseNode(node);
+					return;
+				}
+				// a thread enqueued itself but didn't link its node yet
+				SpinWait spinWait;
+				while ((successor = node->next.load(std::memory_order_acquire)) == nullptr) {
+					spinWait.wait();
+				}
+			}
+			successor->locked.store(false, std::memory_order_release);
+			releaseNode(node);
+		}
+
+	private:
+		static const size_t MAX_NESTING = 16;
+
+		struct Node {
+			std::atomic<Node *> next;
+			std::atomic<bool> locked;
+		};
+
+		/**
+		 * \brief per thread stack of queue nodes
+		 */
+		struct NodeStack {
+			Node nodes[MAX_NESTING];
+			size_t depth = 0;
+		};
+
+		std::atomic<Node *> _tail;
+
+		/**
+		 * \brief node of the thread holding the lock, only accessed by the owner
+		 */
+		Node * _owner;
+
+		static NodeStack & nodeStack() {
+			static thread_local NodeStack stack;
+			return stack;
+		}
+
+		static Node * acquireNode() {
+			NodeStack & stack = nodeStack();
+			assert(stack.depth < MAX_NESTING);
+			return &stack.nodes[stack.depth++];
+		}
+
+		static void releaseNode(Node * node) {
+			NodeStack & stack = nodeStack();
+			assert(stack.depth > 0 && node == &stack.nodes[stack.depth - 1]);
+			(void) node;
+			stack.depth--;
+		}
+
+		/**
+		 * \brief forbidden
+		 */
+		MCSLock(const MCSLock &) = delete;
+		MCSLock & operator=(const MCSLock &) = delete;
+	};
+
+	/**
+	 * class AdaptiveLock
+	 *
+	 * spins for a short time and parks the thread on a condition variable afterwards
+	 * combines the low latency of a spin lock with the low cpu usage of a mutex for longer waits
+	 * SPINS defines the amount of spin iterations before the thread is parked
+	 */
+	template<uint32_t SPINS = 256>
+	class AdaptiveLock {
+	public:
+		/**
+		 * \brief default constructor
+		 */
+		AdaptiveLock() : _locked(false), _waiters(0), _mutex(), _condition() {
+		}
+
+		/**
+		 * \brief blocks until the lock is acquired
+		 */
+		void lock() {
+			for (uint32_t i = 0; i < SPINS; i++) {
+				if (try_lock()) {
+					return;
+				}
+				cpuRelax();
+			}
+			_waiters.fetch_add(1);
+			{
+				std::unique_lock<std::mutex> ul(_mutex);
+				while (_locked.exchange(true)) {
+					_condition.wait(ul);
+				}
+			}
+			_waiters.fetch_sub(1);
+		}
+
+		/**
+		 * \brief tries to acquire the lock without waiting, returns true on success
+		 */
+		bool try_lock() {
+			return !_locked.load(std::memory_order_relaxed) && !_locked.exchange(true);
+		}
+
+		/**
+		 * \brief releases the lock and wakes up one parked thread if there is any
+		 */
+		void unlock() {
+			_locked.store(false);
+			if (_waiters.load() > 0) {
+				std::lock_guard<std::mutex> lg(_mutex);
+				_condition.notify_one();
+			}
+		}
+
+	private:
+		std::atomic<bool> _locked;
+		std::atomic<uint32_t> _waiters;
+		std::mutex _mutex;
+		std::condition_variable _condition;
+
+		/**
+		 * \brief forbidden
+		 */
+		AdaptiveLock(const AdaptiveLock &) = delete;
+		AdaptiveLock & operator=(const AdaptiveLock &) = delete;
+	};
+
+} /* namespace container */
+} /* namespace clockUtils */
+
+#endif /* __CLOCKUTILS_CONTAINER_LOCKS_H__ */
+
+/**
+ * @}
+ */
@@ -0,0 +1,189 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * \addtogroup container
+ * @{
+ */
+
+#ifndef __CLOCKUTILS_CONTAINER_POLLABLEQUEUE_H__
+#define __CLOCKUTILS_CONTAINER_POLLABLEQUEUE_H__
+
+#include "clockUtils/container/containerParameters.h"
+
+#if CLOCKUTILS_PLATFORM == CLOCKUTILS_PLATFORM_LINUX
+
+#include <atomic>
+#include <cstdint>
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "clockUtils/errors.h"
+
+#include "clockUtils/container/LockFreeQueue.h"
+
+namespace clockUtils {
+namespace container {
+
+	/**
+	 * class PollableQueue
+	 *
+	 * LockFreeQueue with a file descriptor that can be used with select, poll or epoll
+	 * the descriptor becomes readable when the queue changes from empty to non-empty, so producers only pay a syscall if the consumer might be sleeping
+	 * the descriptor is edge-triggered: after it became readable, the consumer has to poll until ClockError::NO_ELEMENT is returned, only then the descriptor is re-armed
+	 * only available on Linux because it uses eventfd
+	 *
+	 * T defines the data type being contained in the queue
+	 * SIZE defines the maximum amount of entries this queue has space for
+	 */
+	template<typename T, size_t SIZE>
+	class PollableQueue {
+	public:
+		/**
+		 * \brief default constructor
+		 */
+		PollableQueue() : _queue(), _fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)), _signaled(false) {
+		}
+
+		/**
+		 * \brief destructor, closes the file descriptor
+		 */
+		~PollableQueue() {
+			if (_fd != -1) {
+				close(_fd);
+			}
+		}
+
+		/**
+		 * \brief returns the file descriptor to wait on for new elements, -1 if it couldn't be created
+		 */
+		int getFileDescriptor() const {
+			return _fd;
+		}
+
+		/**
+		 * \brief pushes the given value into the queue and signals the file descriptor if necessary
+		 */
+		ClockError push(const T & value) {
+			ClockError err = _queue.push(value);
+			if (err == ClockError::SUCCESS && !_signaled.exchange(true)) {
+				const uint64_t one = 1;
+				ssize_t written = write(_fd, &one, sizeof(one));
+				(void) written;
+			}
+			return err;
+		}
+
+		/**
+		 * \brief removes first entry of the queue
+		 */
+		ClockError pop() {
+			ClockError err = _queue.pop();
+			if (err == ClockError::NO_ELEMENT) {
+				rearm();
+				err = _queue.pop();
+			}
+			return err;
+		}
+
+		/**
+		 * \brief returns first entry of the queue, but keeps it in the queue
+		 */
+		ClockError front(T & value) {
+			ClockError err = _queue.front(value);
+			if (err == ClockError::NO_ELEMENT) {
+				rearm();
+				err = _queue.front(value);
+			}
+			return err;
+		}
+
+		/**
+		 * \brief removes first entry of the queue and returns its value
+		 */
+		ClockError poll(T & value) {
+			ClockError err = _queue.poll(value);
+			if (err == ClockError::NO_ELEMENT) {
+				rearm();
+				err = _queue.poll(value);
+			}
+			return err;
+		}
+
+		/**
+		 * \brief returns true if the queue is empty, otherwise false
+		 */
+		inline bool empty() const {
+			return _queue.empty();
+		}
+
+		/**
+		 * \brief returns size of the queue
+		 */
+		inline size_t size() const {
+			return _queue.size();
+		}
+
+		/**
+		 * \brief removes all elements in the queue
+		 */
+		void clear() {
+			_queue.clear();
+		}
+
+	private:
+		LockFreeQueue<T, SIZE> _queue;
+
+		int _fd;
+
+		/**
+		 * \brief true while the file descriptor is readable or about to become readable
+		 */
+		std::atomic<bool> _signaled;
+
+		/**
+		 * \brief resets the file descriptor after the consumer found the queue empty
+		 * the caller has to check the queue again afterwards, a producer might have pushed in between without signaling
+		 * the descriptor is read even if _signaled is false, because the write of a producer can arrive after an earlier reset, this costs at most one spurious wakeup
+		 */
+		void rearm() {
+			uint64_t counter;
+			ssize_t bytes = read(_fd, &counter, sizeof(counter));
+			(void) bytes;
+			_signaled.store(false);
+		}
+
+		/**
+		 * \brief forbidden
+		 */
+		PollableQueue(const PollableQueue &) = delete;
+		PollableQueue & operator=(const PollableQueue &) = delete;
+	};
+
+} /* namespace container */
+} /* namespace clockUtils */
+
+#endif /* CLOCKUTILS_PLATFORM == CLOCKUTILS_PLATFORM_LINUX */
+
+#endif /* __CLOCKUTILS_CONTAINER_POLLABLEQUEUE_H__ */
+
+/**
+ * @}
+ */
@@ -0,0 +1,313 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * \addtogroup container
+ * @{
+ */
+
+#ifndef __CLOCKUTILS_CONTAINER_QUEUESET_H__
+#define __CLOCKUTILS_CONTAINER_QUEUESET_H__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include "clockUtils/errors.h"
+
+#include "clockUtils/container/containerParameters.h"
+
+namespace clockUtils {
+namespace container {
+
+	/**
+	 * \brief order in which a QueueSet serves its queues
+	 */
+	enum class QueueSetPolicy {
+		PRIORITY,				//!< always takes the element from the queue added first that has one
+		WEIGHTED_ROUND_ROBIN	//!< takes up to weight elements from a queue before switching to the next one
+	};
+
+	/**
+	 * class QueueSet
+	 *
+	 * waits on several queues at once (e.g. LockFreeQueue and DoubleBufferQueue instances with the same element type)
+	 * all queues share one parking primitive, so a consumer sleeps until any queue gets an element instead of spinning over all of them
+	 * producers have to push through the set or call notify() after pushing into a member queue directly, otherwise sleeping consumers aren't woken up
+	 * queues have to be added before the set is used concurrently and must outlive the set
+	 *
+	 * T defines the data type being contained in the queues
+	 * policy defines the order in which the queues are served, with multiple consumers the weighted round robin is only approximate
+	 */
+	template<typename T, QueueSetPolicy policy = QueueSetPolicy::PRIORITY>
+	class QueueSet {
+	public:
+		/**
+		 * \brief default constructor
+		 */
+		QueueSet() : _queues(), _cursor(0), _served(0), _epoch(0), _waiters(0), _mutex(), _condition() {
+		}
+
+		/**
+		 * \brief destructor, doesn't touch the added queues
+		 */
+		~QueueSet() {
+			for (QueueHandle * q : _queues) {
+				delete q;
+			}
+		}
+
+		/**
+		 * \brief adds a queue to the set and returns its index
+		 * weight is only used for QueueSetPolicy::WEIGHTED_ROUND_ROBIN
+		 */
+		template<typename Queue>
+		size_t addQueue(Queue & queue, uint32_t weight = 1) {
+			_queues.push_back(new QueueAdapter<Queue>(queue, weight == 0 ? 1 : weight));
+			return _queues.size() - 1;
+		}
+
+		/**
+		 * \brief returns the amount of queues in this set
+		 */
+		size_t queueCount() const {
+			return _queues.size();
+		}
+
+		/**
+		 * \brief pushes the value into the queue with the given index and wakes up a waiting consumer
+		 */
+		ClockError push(size_t index, const T & value) {
+			if (index >= _queues.size()) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			ClockError err = _queues[index]->push(value);
+			if (err == ClockError::SUCCESS) {
+				notify();
+			}
+			return err;
+		}
+
+		/**
+		 * \brief wakes up a waiting consumer, has to be called after pushing into a member queue directly
+		 * only pays for a syscall if a consumer is actually waiting
+		 */
+		void notify() {
+			_epoch.fetch_add(1);
+			if (_waiters.load() > 0) {
+				std::lock_guard<std::mutex> lg(_mutex);
+				_condition.notify_one();
+			}
+		}
+
+		/**
+		 * \brief removes the next element according to the policy without waiting
+		 * index is set to the queue the element was taken from
+		 * returns ClockError::NO_ELEMENT if all queues are empty
+		 */
+		ClockError poll(T & value, size_t & index) {
+			return poll(value, index, std::integral_constant<QueueSetPolicy, policy>());
+		}
+
+		/**
+		 * \brief removes the next element according to the policy, blocks until an element is available
+		 */
+		ClockError selectPoll(T & value, size_t & index) {
+			while (true) {
+				uint64_t epoch;
+				if (prepareWait(value, index, epoch)) {
+					return ClockError::SUCCESS;
+				}
+				{
+					std::unique_lock<std::mutex> ul(_mutex);
+					while (_epoch.load() == epoch) {
+						_condition.wait(ul);
+					}
+				}
+				_waiters.fetch_sub(1);
+			}
+		}
+
+		/**
+		 * \brief removes the next element according to the policy, blocks until an element is available or the timeout expired
+		 * returns ClockError::TIMEOUT if no element arrived in time
+		 */
+		template<typename Rep, typename Period>
+		ClockError selectPoll(T & value, size_t & index, const std::chrono::duration<Rep, Period> & timeout) {
+			const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + timeout;
+			while (true) {
+				uint64_t epoch;
+				if (prepareWait(value, index, epoch)) {
+					return ClockError::SUCCESS;
+				}
+				bool expired = false;
+				{
+					std::unique_lock<std::mutex> ul(_mutex);
+					while (_epoch.load() == epoch && !expired) {
+						expired = _condition.wait_until(ul, deadline) == std::cv_status::timeout;
+					}
+				}
+				_waiters.fetch_sub(1);
+				if (expired && poll(value, index) != ClockError::SUCCESS) {
+					return ClockError::TIMEOUT;
+				}
+			}
+		}
+
+		/**
+		 * \brief returns true if all queues are empty
+		 */
+		bool empty() const {
+			for (QueueHandle * q : _queues) {
+				if (!q->empty()) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+	private:
+		/**
+		 * \brief type erased access to a member queue
+		 */
+		class QueueHandle {
+		public:
+			explicit QueueHandle(uint32_t w) : weight(w) {
+			}
+			virtual ~QueueHandle() {
+			}
+			virtual ClockError push(const T & value) = 0;
+			virtual ClockError poll(T & value) = 0;
+			virtual bool empty() const = 0;
+
+			const uint32_t weight;
+		};
+
+		template<typename Queue>
+		class QueueAdapter : public QueueHandle {
+		public:
+			QueueAdapter(Queue & queue, uint32_t w) : QueueHandle(w), _queue(queue) {
+			}
+			ClockError push(const T & value) override {
+				return push(value, std::is_same<decltype(_queue.push(value)), void>());
+			}
+			ClockError poll(T & value) override {
+				return _queue.poll(value);
+			}
+			bool empty() const override {
+				return _queue.empty();
+			}
+
+		private:
+			Queue & _queue;
+
+			// DoubleBufferQueue::push returns void, LockFreeQueue::push returns ClockError
+			ClockError push(const T & value, std::true_type) {
+				_queue.push(value);
+				return ClockError::SUCCESS;
+			}
+			ClockError push(const T & value, std::false_type) {
+				return _queue.push(value);
+			}
+		};
+
+		std::vector<QueueHandle *> _queues;
+
+		/**
+		 * \brief round robin state, index of the current queue and elements taken from it
+		 */
+		std::atomic<size_t> _cursor;
+		std::atomic<uint32_t> _served;
+
+		/**
+		 * \brief incremented on every notify, a consumer only sleeps while it doesn't change
+		 */
+		std::atomic<uint64_t> _epoch;
+		std::atomic<uint32_t> _waiters;
+		std::mutex _mutex;
+		std::condition_variable _condition;
+
+		ClockError poll(T & value, size_t & index, std::integral_constant<QueueSetPolicy, QueueSetPolicy::PRIORITY>) {
+			for (size_t i = 0; i < _queues.size(); i++) {
+				if (_queues[i]->poll(value) == ClockError::SUCCESS) {
+					index = i;
+					return ClockError::SUCCESS;
+				}
+			}
+			return ClockError::NO_ELEMENT;
+		}
+
+		ClockError poll(T & value, size_t & index, std::integral_constant<QueueSetPolicy, QueueSetPolicy::WEIGHTED_ROUND_ROBIN>) {
+			const size_t count = _queues.size();
+			size_t cursor = _cursor.load(std::memory_order_relaxed);
+			uint32_t served = _served.load(std::memory_order_relaxed);
+			// one round more than queues, because the current queue might have used up its weight
+			for (size_t i = 0; i <= count; i++) {
+				if (cursor >= count) {
+					cursor = 0;
+				}
+				if (served < _queues[cursor]->weight && _queues[cursor]->poll(value) == ClockError::SUCCESS) {
+					index = cursor;
+					_cursor.store(cursor, std::memory_order_relaxed);
+					_served.store(served + 1, std::memory_order_relaxed);
+					return ClockError::SUCCESS;
+				}
+				cursor++;
+				served = 0;
+			}
+			return ClockError::NO_ELEMENT;
+		}
+
+		/**
+		 * \brief registers as waiter and checks the queues again
+		 * returns true if an element was found, otherwise the caller has to wait while _epoch equals epoch and unregister afterwards
+		 */
+		bool prepareWait(T & value, size_t & index, uint64_t & epoch) {
+			if (poll(value, index) == ClockError::SUCCESS) {
+				return true;
+			}
+			_waiters.fetch_add(1);
+			epoch = _epoch.load();
+			// a push between the first poll and reading the epoch didn't see us waiting
+			if (poll(value, index) == ClockError::SUCCESS) {
+				_waiters.fetch_sub(1);
+				return true;
+			}
+			return false;
+		}
+
+		/**
+		 * \brief forbidden
+		 */
+		QueueSet(const QueueSet &) = delete;
+		QueueSet & operator=(const QueueSet &) = delete;
+	};
+
+} /* namespace container */
+} /* namespace clockUtils */
+
+#endif /* __CLOCKUTILS_CONTAINER_QUEUESET_H__ */
+
+/**
+ * @}
+ */
@@ -0,0 +1,164 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * \addtogroup container
+ * @{
+ */
+
+#ifndef __CLOCKUTILS_CONTAINER_SEQLOCK_H__
+#define __CLOCKUTILS_CONTAINER_SEQLOCK_H__
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "clockUtils/container/containerParameters.h"
+#include "clockUtils/container/Locks.h"
+
+namespace clockUtils {
+namespace container {
+
+	/**
+	 * class SeqLock
+	 *
+	 * wraps a value that is read very often and written rarely
+	 * readers don't write to shared memory at all, they just retry if a writer was active during the read
+	 * T defines the type of the value, it has to be trivially copyable because readers can observe a partially written copy before they detect it and retry
+	 */
+	template<typename T>
+	class SeqLock {
+		static_assert(std::is_trivially_copyable<T>::value, "SeqLock requires a trivially copyable type");
+
+	public:
+		/**
+		 * \brief default constructor, value is initialized with T(), only this constructor needs T to be default constructible
+		 */
+		SeqLock() : _sequence(0), _data() {
+			write(T());
+		}
+
+		/**
+		 * \brief constructor with initial value
+		 */
+		explicit SeqLock(const T & value) : _sequence(0), _data() {
+			write(value);
+		}
+
+		/**
+		 * \brief sets the new value
+		 * concurrent writers are serialized
+		 */
+		void store(const T & value) {
+			uint64_t sequence = _sequence.load(std::memory_order_relaxed);
+			SpinWait spinWait;
+			// an odd sequence number marks a write in progress
+			while ((sequence & 1) || !_sequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+				spinWait.wait();
+				sequence = _sequence.load(std::memory_order_relaxed);
+			}
+			std::atomic_thread_fence(std::memory_order_release);
+			write(value);
+			_sequence.store(sequence + 2, std::memory_order_release);
+		}
+
+		/**
+		 * \brief returns a consistent copy of the current value
+		 * the value is copied into raw storage, so T doesn't need to be default constructible
+		 */
+		T load() const {
+			uint64_t buffer[WORDS];
+			SpinWait spinWait;
+			while (!read(buffer)) {
+				spinWait.wait();
+			}
+			typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+			memcpy(&storage, buffer, sizeof(T));
+			return *reinterpret_cast<const T *>(&storage);
+		}
+
+		/**
+		 * \brief tries once to read the value, returns false if a writer interfered
+		 */
+		bool tryLoad(T & value) const {
+			uint64_t buffer[WORDS];
+			if (!read(buffer)) {
+				return false;
+			}
+			memcpy(&value, buffer, sizeof(T));
+			return true;
+		}
+
+		/**
+		 * \brief returns the amount of stores since construction
+		 */
+		uint64_t version() const {
+			return _sequence.load(std::memory_order_acquire) / 2;
+		}
+
+	private:
+		static const size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+		std::atomic<uint64_t> _sequence;
+
+		/**
+		 * \brief the value split into atomic words, so concurrent reads and writes aren't a data race
+		 */
+		std::array<std::atomic<uint64_t>, WORDS> _data;
+
+		/**
+		 * \brief copies the words of the value into buffer, returns false if a writer interfered
+		 */
+		bool read(uint64_t (&buffer)[WORDS]) const {
+			const uint64_t before = _sequence.load(std::memory_order_acquire);
+			if (before & 1) {
+				return false;
+			}
+			for (size_t i = 0; i < WORDS; i++) {
+				buffer[i] = _data[i].load(std::memory_order_relaxed);
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+			return _sequence.load(std::memory_order_relaxed) == before;
+		}
+
+		void write(const T & value) {
+			uint64_t buffer[WORDS] = { 0 };
+			memcpy(buffer, &value, sizeof(T));
+			for (size_t i = 0; i < WORDS; i++) {
+				_data[i].store(buffer[i], std::memory_order_relaxed);
+			}
+		}
+
+		/**
+		 * \brief forbidden
+		 */
+		SeqLock(const SeqLock &) = delete;
+		SeqLock & operator=(const SeqLock &) = delete;
+	};
+
+} /* namespace container */
+} /* namespace clockUtils */
+
+#endif /* __CLOCKUTILS_CONTAINER_SEQLOCK_H__ */
+
+/**
+ * @}
+ */
@@ -33,6 +33,7 @@
 #include <vector>
 
 #include "clockUtils/errors.h"
+#include "clockUtils/container/FlatMap.h"
 #include "clockUtils/iniParser/iniParserParameters.h"
 
 namespace clockUtils {
@@ -179,8 +180,8 @@ namespace iniParser {
 		};
 
 		// one vector with lines/values for each section
-		std::map<std::string, std::vector<std::tuple<std::string, std::string, size_t, std::string>>> _data;
-		std::map<std::string, std::vector<std::string>> _allLines;
+		container::FlatMap<std::string, std::vector<std::tuple<std::string, std::string, size_t, std::string>>> _data;
+		container::FlatMap<std::string, std::vector<std::string>> _allLines;
 	};
 
 	/**
@@ -0,0 +1,214 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "clockUtils/compression/MappedFile.h"
+
+#include <new>
+
+#include "clockUtils/errors.h"
+
+#if CLOCKUTILS_PLATFORM == CLOCKUTILS_PLATFORM_WIN32
+	#include <Windows.h>
+#elif CLOCKUTILS_PLATFORM == CLOCKUTILS_PLATFORM_LINUX
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace clockUtils {
+namespace compression {
+
+	namespace {
+
+		/**
+		 * \brief reads the identity of the file behind handle, returns false if it isn't available
+		 */
+#if CLOCKUTILS_PLATFORM == CLOCKUTILS_PLATFORM_WIN32
+		bool fileIdentity(HANDLE handle, uint64_t & device, uint64_t & index) {
+			BY_HANDLE_FILE_INFORMATION info;
+			if (!GetFileInformationByHandle(handle, &info)) {
+				return false;
+			}
+			device = info.dwVolumeSerialNumber;
+			index = (uint64_t(info.nFileIndexHigh) << 32) | info.nFileIndexLow;
+			return true;
+		}
+#elif CLOCKUTILS_PLATFORM == CLOCKUTILS_PLATFORM_LINUX
+		void fileIdentity(const struct stat & info, uint64_t & device, uint64_t & index) {
+			device = uint64_t(info.st_dev);
+			index = uint64_t(info.st_ino);
+		}
+#endif
+
+	} /* namespace */
+
+	MappedFile::MappedFile() : _data(nullptr), _size(0), _opened(false), _device(0), _index(0), _mapping(nullptr) {
+	}
+
+	MappedFile::~MappedFile() {
+		close();
+	}
+
+	ClockError MappedFile::open(const std::string & file) {
+		close();
+#if CLOCKUTILS_PLATFORM == CLOCKUTILS_PLATFORM_WIN32
+		HANDLE handle = CreateFileA(file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (handle == INVALID_HANDLE_VALUE) {
+			return ClockError::FILENOTFOUND;
+		}
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(handle, &size) || uint64_t(size.QuadPart) > SIZE_MAX || !fileIdentity(handle, _device, _index)) {
+			CloseHandle(handle);
+			return ClockError::OUT_OF_MEMORY;
+		}
+		_opened = true;
+		if (size.QuadPart == 0) {
+			// empty files can't be mapped
+			CloseHandle(handle);
+			return ClockError::SUCCESS;
+		}
+		HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		// the mapping keeps the file open
+		CloseHandle(handle);
+		if (mapping == nullptr) {
+			return ClockError::OUT_OF_MEMORY;
+		}
+		const void * data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (data == nullptr) {
+			CloseHandle(mapping);
+			return ClockError::OUT_OF_MEMORY;
+		}
+		_mapping = mapping;
+		_data = static_cast<const char *>(data);
+		_size = size_t(size.QuadPart);
+#elif CLOCKUTILS_PLATFORM == CLOCKUTILS_PLATFORM_LINUX
+		const int fd = ::open(file.c_str(), O_RDONLY);
+		if (fd == -1) {
+			return ClockError::FILENOTFOUND;
+		}
+		struct stat info;
+		if (fstat(fd, &info) == -1 || !S_ISREG(info.st_mode) || uint64_t(info.st_size) > SIZE_MAX) {
+			::close(fd);
+			return ClockError::FILENOTFOUND;
+		}
+		fileIdentity(info, _device, _index);
+		_opened = true;
+		if (info.st_size == 0) {
+			// empty files can't be mapped
+			::close(fd);
+			return ClockError::SUCCESS;
+		}
+		void * data = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		// the mapping keeps the file open
+		::close(fd);
+		if (data == MAP_FAILED) {
+			return ClockError::OUT_OF_MEMORY;
+		}
+		madvise(data, size_t(info.st_size), MADV_SEQUENTIAL);
+		_data = static_cast<const char *>(data);
+		_size = size_t(info.st_size);
+#endif
+		return ClockError::SUCCESS;
+	}
+
+	void MappedFile::close() {
+		if (_data) {
+#if CLOCKUTILS_PLATFORM == CLOCKUTILS_PLATFORM_WIN32
+			UnmapViewOfFile(_data);
+			CloseHandle(_mapping);
+#elif CLOCKUTILS_PLATFORM == CLOCKUTILS_PLATFORM_LINUX
+			munmap(const_cast<char *>(_data), _size);
+#endif
+		}
+		_data = nullptr;
+		_size = 0;
+		_opened = false;
+		_mapping = nullptr;
+	}
+
+	bool MappedFile::isSameFile(const std::string & file) const {
+		if (!_opened) {
+			return false;
+		}
+		uint64_t device = 0;
+		uint64_t index = 0;
+#if CLOCKUTILS_PLATFORM == CLOCKUTILS_PLATFORM_WIN32
+		HANDLE handle = CreateFileA(file.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (handle == INVALID_HANDLE_VALUE) {
+			return false;
+		}
+		const bool known = fileIdentity(handle, device, index);
+		CloseHandle(handle);
+		if (!known) {
+			return false;
+		}
+#elif CLOCKUTILS_PLATFORM == CLOCKUTILS_PLATFORM_LINUX
+		struct stat info;
+		if (stat(file.c_str(), &info) == -1) {
+			return false;
+		}
+		fileIdentity(info, device, index);
+#endif
+		return device == _device && index == _index;
+	}
+
+	FileWriter::FileWriter() : _file(nullptr), _buffer(nullptr) {
+	}
+
+	FileWriter::~FileWriter() {
+		close();
+	}
+
+	ClockError FileWriter::open(const std::string & file) {
+		close();
+		_file = std::fopen(file.c_str(), "wb");
+		if (!_file) {
+			return ClockError::FILENOTFOUND;
+		}
+		// without the buffer the default one of the C library is used
+		_buffer = new (std::nothrow) char[BUFFER_SIZE];
+		if (_buffer) {
+			std::setvbuf(_file, _buffer, _IOFBF, BUFFER_SIZE);
+		}
+		return ClockError::SUCCESS;
+	}
+
+	ClockError FileWriter::write(const char * data, size_t length) {
+		if (!_file) {
+			return ClockError::INVALID_USAGE;
+		}
+		return (std::fwrite(data, 1, length, _file) == length) ? ClockError::SUCCESS : ClockError::UNKNOWN;
+	}
+
+	ClockError FileWriter::close() {
+		ClockError error = ClockError::SUCCESS;
+		if (_file) {
+			if (std::fclose(_file) != 0) {
+				error = ClockError::UNKNOWN;
+			}
+			_file = nullptr;
+		}
+		delete[] _buffer;
+		_buffer = nullptr;
+		return error;
+	}
+
+} /* namespace compression */
+} /* namespace clockUtils */
@@ -0,0 +1,611 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "clockUtils/compression/algorithm/FSE.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#include "clockUtils/errors.h"
+
+namespace clockUtils {
+namespace compression {
+namespace algorithm {
+
+	namespace {
+
+		/**
+		 * \brief index of the highest set bit, value must not be 0
+		 */
+		uint32_t highBit(uint32_t value) {
+#if defined(_MSC_VER)
+			unsigned long index;
+			_BitScanReverse(&index, value);
+			return uint32_t(index);
+#else
+			return uint32_t(31 - __builtin_clz(value));
+#endif
+		}
+
+		/**
+		 * \brief distributes the states of the table over the bytes, every byte gets as many states as its normalized count
+		 * the states of one byte are spread over the whole table, so the encoder doesn't prefer a region of states
+		 */
+		void spreadSymbols(const std::vector<uint16_t> & counts, uint8_t tableLog, std::vector<uint8_t> & spread) {
+			const uint32_t size = 1u << tableLog;
+			const uint32_t mask = size - 1;
+			// odd step, so every state is visited exactly once
+			const uint32_t step = (size >> 1) + (size >> 3) + 3;
+			spread.resize(size);
+			uint32_t pos = 0;
+			for (size_t s = 0; s < counts.size(); s++) {
+				for (uint32_t i = 0; i < counts[s]; i++) {
+					spread[pos] = uint8_t(s);
+					pos = (pos + step) & mask;
+				}
+			}
+			assert(pos == 0);
+		}
+
+		/**
+		 * \brief values needed to encode a byte without branches
+		 * the amount of bits to write is (state + deltaBits) >> 16, the next state is found at (state >> bits) + deltaState
+		 */
+		struct SymbolTransform {
+			int32_t deltaState;
+			uint32_t deltaBits;
+		};
+
+		struct EncodingTable {
+			/**
+			 * \brief next states (+ table size) sorted by byte
+			 */
+			std::vector<uint16_t> states;
+			std::array<SymbolTransform, 256> symbols;
+		};
+
+		/**
+		 * \brief entry of the decoding table, the next state is newState plus the next bits bits of the stream
+		 */
+		struct StateEntry {
+			uint16_t newState;
+			uint8_t symbol;
+			uint8_t bits;
+		};
+
+		void buildEncodingTable(const std::vector<uint16_t> & counts, uint8_t tableLog, EncodingTable & table) {
+			const uint32_t size = 1u << tableLog;
+			std::vector<uint8_t> spread;
+			spreadSymbols(counts, tableLog, spread);
+
+			std::array<uint32_t, 256> next;
+			uint32_t total = 0;
+			for (size_t s = 0; s < 256; s++) {
+				next[s] = total;
+				total += counts[s];
+			}
+			table.states.resize(size);
+			for (uint32_t u = 0; u < size; u++) {
+				table.states[next[spread[u]]++] = uint16_t(size + u);
+			}
+
+			total = 0;
+			for (size_t s = 0; s < 256; s++) {
+				const uint32_t count = counts[s];
+				if (count == 0) {
+					table.symbols[s] = SymbolTransform { 0, 0 };
+					continue;
+				}
+				// a byte with count n needs tableLog - log2(n) bits, states below minState write one bit less
+				const uint32_t maxBits = tableLog - ((count > 1) ? highBit(count - 1) : 0);
+				const uint32_t minState = count << maxBits;
+				table.symbols[s] = SymbolTransform { int32_t(total) - int32_t(count), (maxBits << 16) - minState };
+				total += count;
+			}
+		}
+
+		void buildDecodingTable(const std::vector<uint16_t> & counts, uint8_t tableLog, std::vector<StateEntry> & table) {
+			const uint32_t size = 1u << tableLog;
+			std::vector<uint8_t> spread;
+			spreadSymbols(counts, tableLog, spread);
+
+			std::array<uint32_t, 256> next;
+			for (size_t s = 0; s < 256; s++) {
+				next[s] = counts[s];
+			}
+			table.resize(size);
+			for (uint32_t u = 0; u < size; u++) {
+				const uint8_t symbol = spread[u];
+				const uint32_t state = next[symbol]++;
+				const uint32_t bits = tableLog - highBit(state);
+				table[u] = StateEntry { uint16_t((state << bits) - size), symbol, uint8_t(bits) };
+			}
+		}
+
+		/**
+		 * \brief writes bit sequences LSB first into a preallocated buffer, the decoder reads them in reverse order
+		 * the bits are collected in a 64 bit register, flush has to be called before it contains more than 56 bits
+		 */
+		class StateWriter {
+		public:
+			explicit StateWriter(char * out) : _start(reinterpret_cast<uint8_t *>(out)), _out(_start), _buffer(0), _bits(0) {
+			}
+
+			/**
+			 * \brief appends the lower bits bits of value, the other bits of value have to be 0
+			 */
+			void write(uint32_t value, uint32_t bits) {
+				_buffer |= uint64_t(value) << _bits;
+				_bits += bits;
+			}
+
+			/**
+			 * \brief stores all complete bytes, this always writes 8 bytes
+			 */
+			void flush() {
+				memcpy(_out, &_buffer, 8);
+				const uint32_t bytes = _bits >> 3;
+				_out += bytes;
+				_buffer = (bytes > 0) ? _buffer >> (8 * bytes) : _buffer;
+				_bits &= 7;
+			}
+
+			/**
+			 * \brief terminates the bit sequence with a 1 bit, so the decoder can find its last bit, and returns its size in bytes
+			 */
+			size_t finish() {
+				write(1, 1);
+				flush();
+				return size_t(_out - _start) + ((_bits > 0) ? 1 : 0);
+			}
+
+		private:
+			uint8_t * _start;
+			uint8_t * _out;
+			uint64_t _buffer;
+			uint32_t _bits;
+		};
+
+		/**
+		 * \brief reads a bit sequence written with StateWriter from its end to its start
+		 * reading never accesses memory outside of the sequence, too many bits are detected with remaining()
+		 */
+		class StateReader {
+		public:
+			StateReader() : _begin(nullptr), _pos(nullptr), _buffer(0), _consumed(0), _padding(0) {
+			}
+
+			/**
+			 * \brief returns false if data can't be a bit sequence written with StateWriter
+			 * size has to be at least 8, the first padding bits are zeros in front of the actual sequence which must not be consumed
+			 */
+			bool init(const uint8_t * data, size_t size, uint32_t padding) {
+				if (size < 8 || data[size - 1] == 0) {
+					return false;
+				}
+				_begin = data;
+				_pos = data + size - 8;
+				_padding = padding;
+				memcpy(&_buffer, _pos, 8);
+				// skip the padding of the last byte and the terminating 1 bit
+				_consumed = 8 - highBit(data[size - 1]);
+				return true;
+			}
+
+			/**
+			 * \brief reads the next bits bits, at most 56 bits can be read between two reloads
+			 */
+			uint32_t read(uint32_t bits) {
+				// shifted in two steps, so reading 0 bits works without a branch
+				const uint32_t value = uint32_t(((_buffer << (_consumed & 63)) >> 1) >> (63 - bits));
+				_consumed += bits;
+				return value;
+			}
+
+			/**
+			 * \brief loads the next bytes, afterwards at least 56 bits can be read unless the start of the sequence is reached
+			 * returns false if more bits were read than the sequence contains
+			 */
+			bool reload() {
+				size_t bytes = _consumed >> 3;
+				if (bytes > size_t(_pos - _begin)) {
+					bytes = size_t(_pos - _begin);
+				}
+				_pos -= bytes;
+				_consumed -= uint32_t(bytes) * 8;
+				memcpy(&_buffer, _pos, 8);
+				return _consumed <= 64;
+			}
+
+			/**
+			 * \brief amount of bits that weren't read yet, negative if more bits were read than the sequence contains
+			 */
+			int64_t remaining() const {
+				return int64_t(_pos - _begin) * 8 + 64 - int64_t(_consumed) - int64_t(_padding);
+			}
+
+		private:
+			const uint8_t * _begin;
+			const uint8_t * _pos;
+			uint64_t _buffer;
+			uint32_t _consumed;
+			uint32_t _padding;
+
+			/**
+			 * \brief forbidden
+			 */
+			StateReader(const StateReader &) = delete;
+			StateReader & operator=(const StateReader &) = delete;
+		};
+
+		inline void encodeSymbol(uint32_t & state, uint8_t symbol, const EncodingTable & table, StateWriter & writer) {
+			const SymbolTransform & transform = table.symbols[symbol];
+			const uint32_t bits = (state + transform.deltaBits) >> 16;
+			writer.write(state & ((1u << bits) - 1), bits);
+			state = table.states[size_t(int32_t(state >> bits) + transform.deltaState)];
+		}
+
+		inline char decodeSymbol(uint32_t & state, const StateEntry * table, StateReader & reader) {
+			const StateEntry entry = table[state];
+			state = entry.newState + reader.read(entry.bits);
+			return char(entry.symbol);
+		}
+
+		/**
+		 * \brief encodes length bytes of data with two interleaved states and returns the size of the bit sequence written to out
+		 * bytes at even positions use the first state, bytes at odd positions the second one
+		 * the bytes are encoded from back to front, so the decoder can restore them from front to back
+		 */
+		size_t encodeStates(const uint8_t * data, size_t length, const EncodingTable & table, uint8_t tableLog, char * out) {
+			const uint32_t size = 1u << tableLog;
+			StateWriter writer(out);
+			uint32_t first = size;
+			uint32_t second = size;
+			size_t i = length;
+			if (i & 1) {
+				encodeSymbol(first, data[--i], table, writer);
+				writer.flush();
+			}
+			// at most 4 * MAX_TABLE_LOG bits between two flushes
+			for (; i >= 4; i -= 4) {
+				encodeSymbol(second, data[i - 1], table, writer);
+				encodeSymbol(first, data[i - 2], table, writer);
+				encodeSymbol(second, data[i - 3], table, writer);
+				encodeSymbol(first, data[i - 4], table, writer);
+				writer.flush();
+			}
+			if (i == 2) {
+				encodeSymbol(second, data[1], table, writer);
+				encodeSymbol(first, data[0], table, writer);
+				writer.flush();
+			}
+			// the decoder starts with the first state, so it is written last
+			writer.write(second - size, tableLog);
+			writer.write(first - size, tableLog);
+			return writer.finish();
+		}
+
+		ClockError decodeStates(const uint8_t * data, size_t dataSize, const std::vector<StateEntry> & table, uint8_t tableLog, char * out, size_t length) {
+			// short sequences are copied behind zero bytes, so the reader can always load 8 bytes
+			uint8_t padded[8] = { 0 };
+			uint32_t padding = 0;
+			if (dataSize > 0 && dataSize < 8) {
+				memcpy(padded + 8 - dataSize, data, dataSize);
+				padding = uint32_t(8 - dataSize) * 8;
+				data = padded;
+				dataSize = 8;
+			}
+			StateReader reader;
+			if (!reader.init(data, dataSize, padding)) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			const StateEntry * entries = table.data();
+			uint32_t first = reader.read(tableLog);
+			uint32_t second = reader.read(tableLog);
+
+			char * const end = out + length;
+			if (!reader.reload()) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			while (end - out >= 4) {
+				out[0] = decodeSymbol(first, entries, reader);
+				out[1] = decodeSymbol(second, entries, reader);
+				out[2] = decodeSymbol(first, entries, reader);
+				out[3] = decodeSymbol(second, entries, reader);
+				out += 4;
+				if (!reader.reload()) {
+					return ClockError::INVALID_ARGUMENT;
+				}
+			}
+			if (end - out >= 2) {
+				out[0] = decodeSymbol(first, entries, reader);
+				out[1] = decodeSymbol(second, entries, reader);
+				out += 2;
+			}
+			if (out < end) {
+				*out = decodeSymbol(first, entries, reader);
+			}
+			// both states have to end in the initial state of the encoder and all bits have to be used
+			return (first == 0 && second == 0 && reader.remaining() == 0) ? ClockError::SUCCESS : ClockError::INVALID_ARGUMENT;
+		}
+
+	} /* namespace */
+
+	ClockError FSE::compress(const std::string & uncompressed, std::string & compressed) {
+		OutputBuffer out(compressed);
+		return compress(reinterpret_cast<const uint8_t *>(uncompressed.data()), uncompressed.length(), out);
+	}
+
+	ClockError FSE::decompress(const std::string & compressed, std::string & decompressed) {
+		OutputBuffer out(decompressed);
+		return decompress(reinterpret_cast<const uint8_t *>(compressed.data()), compressed.length(), out);
+	}
+
+	ClockError FSE::compress(const void * uncompressed, size_t length, void * compressed, size_t capacity, size_t & compressedLength) {
+		OutputBuffer out(compressed, capacity);
+		ClockError error = compress(static_cast<const uint8_t *>(uncompressed), length, out);
+		compressedLength = out.size();
+		return error;
+	}
+
+	ClockError FSE::decompress(const void * compressed, size_t length, void * decompressed, size_t capacity, size_t & decompressedLength) {
+		OutputBuffer out(decompressed, capacity);
+		ClockError error = decompress(static_cast<const uint8_t *>(compressed), length, out);
+		decompressedLength = out.size();
+		return error;
+	}
+
+	size_t FSE::maxCompressedSize(size_t length) {
+		if (length == 0) {
+			return sizeof(len_t);
+		}
+		// table log, largest byte and at most 16 bits per count like reserved by writeCounts
+		const size_t headerSize = sizeof(len_t) + 2 + 256 * 2;
+		return headerSize + size_t((uint64_t(length) * MAX_TABLE_LOG + 2 * MAX_TABLE_LOG + 1) / 8) + 8;
+	}
+
+	ClockError FSE::compress(const uint8_t * data, size_t length, OutputBuffer & out) {
+		if (length > std::numeric_limits<len_t>::max()) {
+			// string is too long
+			return ClockError::INVALID_ARGUMENT;
+		}
+		std::vector<len_t> histogram;
+		calcHistogram(data, length, histogram);
+
+		const len_t len = len_t(length);
+		std::string header;
+		uint8_t tableLog = 0;
+		EncodingTable table;
+		try {
+			for (size_t i = 0; i < sizeof(len_t); i++) {
+				header += char(uint8_t((len >> (8 * (sizeof(len_t) - 1 - i))) & 0xFF));
+			}
+			if (length > 0) {
+				uint8_t maxSymbol = 255;
+				while (histogram[maxSymbol] == 0) {
+					maxSymbol--;
+				}
+				tableLog = optimalTableLog(len, maxSymbol);
+				std::vector<uint16_t> counts;
+				normalizeCounts(histogram, len, tableLog, counts);
+				writeCounts(counts, tableLog, header);
+				buildEncodingTable(counts, tableLog, table);
+			}
+		} catch (std::bad_alloc &) {
+			return ClockError::OUT_OF_MEMORY;
+		}
+		if (length == 0) {
+			char * compressed = out.allocate(header.length());
+			if (!compressed) {
+				return ClockError::OUT_OF_MEMORY;
+			}
+			std::copy(header.begin(), header.end(), compressed);
+			return ClockError::SUCCESS;
+		}
+
+		// at most tableLog bits per byte, both states, the terminating bit and the 8 bytes written by every flush
+		char * compressed = out.allocate(header.length() + size_t((uint64_t(len) * tableLog + 2 * tableLog + 1) / 8) + 8);
+		if (!compressed) {
+			return ClockError::OUT_OF_MEMORY;
+		}
+		std::copy(header.begin(), header.end(), compressed);
+		const size_t size = encodeStates(data, length, table, tableLog, compressed + header.length());
+		out.resize(header.length() + size);
+
+		return ClockError::SUCCESS;
+	}
+
+	ClockError FSE::decompress(const uint8_t * data, size_t length, OutputBuffer & out) {
+		if (length < sizeof(len_t)) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+		len_t len = 0;
+		for (size_t i = 0; i < sizeof(len_t); i++) {
+			len *= 0x100; // * 256
+			len += data[i];
+		}
+		if (len == 0) {
+			out.allocate(0);
+			return (length == sizeof(len_t)) ? ClockError::SUCCESS : ClockError::INVALID_ARGUMENT;
+		}
+
+		size_t pos = sizeof(len_t);
+		uint8_t tableLog = 0;
+		std::vector<uint16_t> counts;
+		ClockError error = readCounts(data, length, pos, tableLog, counts);
+		if (error != ClockError::SUCCESS) {
+			return error;
+		}
+		std::vector<StateEntry> table;
+		try {
+			buildDecodingTable(counts, tableLog, table);
+		} catch (std::bad_alloc &) {
+			return ClockError::OUT_OF_MEMORY;
+		}
+		// unless a byte fills more than half of the table, every byte needs at least one bit
+		uint32_t minBits = tableLog;
+		for (const StateEntry & entry : table) {
+			minBits = std::min(minBits, uint32_t(entry.bits));
+		}
+		if (uint64_t(len) * minBits > uint64_t(length - pos) * 8) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+
+		char * decompressed = out.allocate(len);
+		if (!decompressed) {
+			return ClockError::OUT_OF_MEMORY;
+		}
+
+		return decodeStates(data + pos, length - pos, table, tableLog, decompressed, len);
+	}
+
+	uint8_t FSE::optimalTableLog(len_t length, uint8_t maxSymbol) {
+		// short strings don't profit from a large table, but its header would be larger
+		const uint32_t sourceLog = (length > 1) ? highBit(length - 1) : 0;
+		uint32_t tableLog = std::min(uint32_t(MAX_TABLE_LOG), std::max(sourceLog, 2u) - 2);
+		// the table needs more states than there are different bytes
+		const uint32_t minLog = std::min(highBit(length) + 1, highBit(maxSymbol | 1u) + 2);
+		tableLog = std::max(tableLog, minLog);
+		return uint8_t(std::min(std::max(tableLog, uint32_t(MIN_TABLE_LOG)), uint32_t(MAX_TABLE_LOG)));
+	}
+
+	void FSE::normalizeCounts(const std::vector<len_t> & histogram, len_t length, uint8_t tableLog, std::vector<uint16_t> & counts) {
+		const uint32_t size = 1u << tableLog;
+		counts.assign(256, 0);
+		uint32_t distributed = 0;
+		for (size_t s = 0; s < 256; s++) {
+			if (histogram[s] > 0) {
+				const uint32_t count = uint32_t((uint64_t(histogram[s]) * size + length / 2) / length);
+				counts[s] = uint16_t(std::max(count, 1u));
+				distributed += counts[s];
+			}
+		}
+		if (distributed == size) {
+			return;
+		}
+
+		// a byte occurring c times with count n costs c * log2(size / n) bits, so the rounding error is corrected where changing a count by 1 costs the fewest bits
+		// the direction doesn't change, so only the cost of the modified byte has to be updated in every step
+		const bool increase = distributed < size;
+		std::array<double, 256> costs;
+		auto cost = [&](size_t s) {
+			if (histogram[s] == 0 || (!increase && counts[s] == 1)) {
+				return std::numeric_limits<double>::max();
+			}
+			const double n = counts[s];
+			return increase ? histogram[s] * std::log2(n / (n + 1)) : histogram[s] * std::log2(n / (n - 1));
+		};
+		for (size_t s = 0; s < 256; s++) {
+			costs[s] = cost(s);
+		}
+		for (; distributed != size; distributed = increase ? distributed + 1 : distributed - 1) {
+			const size_t best = size_t(std::min_element(costs.begin(), costs.end()) - costs.begin());
+			counts[best] = increase ? uint16_t(counts[best] + 1) : uint16_t(counts[best] - 1);
+			costs[best] = cost(best);
+		}
+	}
+
+	void FSE::writeCounts(const std::vector<uint16_t> & counts, uint8_t tableLog, std::string & result) {
+		size_t maxSymbol = 255;
+		while (counts[maxSymbol] == 0) {
+			maxSymbol--;
+		}
+		result += char(tableLog);
+		result += char(uint8_t(maxSymbol));
+
+		// every count needs at most MAX_TABLE_LOG + 1 bits, the BitWriter stores 8 bytes at once
+		const size_t offset = result.length();
+		result.resize(offset + 256 * 2 + 8, 0x0);
+		BitWriter writer(&result[offset]);
+		size_t bits = 0;
+		uint32_t remaining = 1u << tableLog;
+		for (size_t s = 0; s < maxSymbol; s++) {
+			const uint32_t length = highBit(remaining) + 1;
+			writer.write(counts[s], length);
+			bits += length;
+			remaining -= counts[s];
+			if (counts[s] == 0) {
+				size_t zeros = 0;
+				while (s + 1 + zeros < maxSymbol && counts[s + 1 + zeros] == 0) {
+					zeros++;
+				}
+				s += zeros;
+				for (; zeros >= 3; zeros -= 3) {
+					writer.write(3, 2);
+					bits += 2;
+				}
+				writer.write(uint32_t(zeros), 2);
+				bits += 2;
+			}
+		}
+		writer.flush();
+		result.resize(offset + (bits + 7) / 8);
+	}
+
+	ClockError FSE::readCounts(const uint8_t * data, size_t size, size_t & pos, uint8_t & tableLog, std::vector<uint16_t> & counts) {
+		if (size < pos + 2) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+		tableLog = data[pos];
+		const size_t maxSymbol = data[pos + 1];
+		if (tableLog < MIN_TABLE_LOG || tableLog > MAX_TABLE_LOG) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+		pos += 2;
+
+		counts.assign(256, 0);
+		const size_t available = size - pos;
+		BitReader reader(data + pos, available);
+		uint32_t remaining = 1u << tableLog;
+		for (size_t s = 0; s < maxSymbol; s++) {
+			reader.fill(32);
+			const uint32_t count = reader.read(highBit(remaining) + 1);
+			// the last byte needs at least one state
+			if (count >= remaining) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			counts[s] = uint16_t(count);
+			remaining -= count;
+			if (count == 0) {
+				uint32_t repeat;
+				do {
+					reader.fill(2);
+					repeat = reader.read(2);
+					if (s + repeat >= maxSymbol) {
+						return ClockError::INVALID_ARGUMENT;
+					}
+					s += repeat;
+				} while (repeat == 3);
+			}
+		}
+		counts[maxSymbol] = uint16_t(remaining);
+		const size_t bytes = size_t((reader.position() + 7) / 8);
+		if (bytes > available) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+		pos += bytes;
+		return ClockError::SUCCESS;
+	}
+
+} /* namespace algorithm */
+} /* namespace compression */
+} /* namespace clockUtils */
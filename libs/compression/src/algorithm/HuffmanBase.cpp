@@ -19,100 +19,753 @@
 
 #include "clockUtils/compression/algorithm/HuffmanBase.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cmath>
-#include <queue>
+#include <cstddef>
+#include <cstring>
 
 #include "clockUtils/errors.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define CLOCKUTILS_COMPRESSION_SSE2
+	#include <emmintrin.h>
+#endif
+
+// the AVX2 code is compiled with a function attribute and only used if the cpu supports it, this isn't available with MSVC
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+	#define CLOCKUTILS_COMPRESSION_AVX2
+	#include <immintrin.h>
+#endif
+
 namespace clockUtils {
 namespace compression {
 namespace algorithm {
 
-	std::shared_ptr<HuffmanBase::Node> HuffmanBase::buildTree(const std::vector<uint8_t> & header) {
-		struct compare {
-			bool operator()(const std::shared_ptr<Node> & a, const std::shared_ptr<Node> & b) const {
-				assert(a && b);
-				return a->value > b->value;
-			}
+	void HuffmanBase::buildTree(const std::vector<uint8_t> & header, Tree & tree) {
+		// min heap of node indices, pushed and popped in the same order as a std::priority_queue would do to keep the tree (and so the format) unchanged
+		const auto compare = [&tree](uint16_t a, uint16_t b) {
+			return tree.nodes[a].value > tree.nodes[b].value;
 		};
+		std::array<uint16_t, 256> queue;
+		size_t queueSize = 0;
 
-		std::priority_queue<std::shared_ptr<Node>, std::vector<std::shared_ptr<Node>>, compare> queue;
-
+		tree.size = 0;
 		for (size_t i = 0; i < 256; i++) {
 			if (header[i] == 0) {
 				continue;
 			}
-			std::shared_ptr<Node> node = std::make_shared<Node>();
-			node->value = header[i];
-			node->c = uint8_t(i);
-			queue.push(node);
+			Tree::Node & node = tree.nodes[tree.size];
+			node.value = header[i];
+			node.c = uint8_t(i);
+			node.left = Tree::NONE;
+			node.right = Tree::NONE;
+			queue[queueSize++] = tree.size++;
+			std::push_heap(queue.begin(), queue.begin() + std::ptrdiff_t(queueSize), compare);
 		}
 
-		while (queue.size() >= 2) {
+		while (queueSize >= 2) {
 			// combine the first two nodes
-			std::shared_ptr<Node> left = queue.top();
-			queue.pop();
-			std::shared_ptr<Node> right = queue.top();
-			queue.pop();
-			std::shared_ptr<Node> node = std::make_shared<Node>();
-			node->left = left;
-			node->right = right;
-			node->value = left->value + right->value;
-			queue.push(node);
-		}
-
-		return queue.top();
-	}
-
-	void HuffmanBase::generateMapping(const std::shared_ptr<Node> & node, const std::vector<bool> & bitSeq, std::vector<std::vector<bool>> & mapping) {
-		assert(node);
-		// reached leaves
-		if (node->left == nullptr) {
-			assert(node->right == nullptr);
-			mapping[node->c] = bitSeq;
+			std::pop_heap(queue.begin(), queue.begin() + std::ptrdiff_t(queueSize), compare);
+			const uint16_t left = queue[--queueSize];
+			std::pop_heap(queue.begin(), queue.begin() + std::ptrdiff_t(queueSize), compare);
+			const uint16_t right = queue[--queueSize];
+			Tree::Node & node = tree.nodes[tree.size];
+			node.left = left;
+			node.right = right;
+			node.value = tree.nodes[left].value + tree.nodes[right].value;
+			node.c = 0;
+			queue[queueSize++] = tree.size++;
+			std::push_heap(queue.begin(), queue.begin() + std::ptrdiff_t(queueSize), compare);
+		}
+
+		tree.root = (queueSize == 1) ? queue[0] : Tree::NONE;
+	}
+
+	namespace {
+
+		/**
+		 * \brief amount of count tables, consecutive bytes are counted in different tables
+		 * so runs of the same byte don't wait for the increment of the previous byte to be stored
+		 */
+		const size_t HISTOGRAM_TABLES = 8;
+
+		struct HistogramTables {
+			alignas(32) uint32_t counts[HISTOGRAM_TABLES][256];
+		};
+
+		typedef void (*MergeFunction)(const HistogramTables & tables, uint32_t * histogram);
+
+		void mergeScalar(const HistogramTables & tables, uint32_t * histogram) {
+			for (size_t i = 0; i < 256; i++) {
+				uint32_t sum = 0;
+				for (size_t t = 0; t < HISTOGRAM_TABLES; t++) {
+					sum += tables.counts[t][i];
+				}
+				histogram[i] = sum;
+			}
+		}
+
+#ifdef CLOCKUTILS_COMPRESSION_SSE2
+		void mergeSSE2(const HistogramTables & tables, uint32_t * histogram) {
+			for (size_t i = 0; i < 256; i += 4) {
+				__m128i sum = _mm_load_si128(reinterpret_cast<const __m128i *>(&tables.counts[0][i]));
+				for (size_t t = 1; t < HISTOGRAM_TABLES; t++) {
+					sum = _mm_add_epi32(sum, _mm_load_si128(reinterpret_cast<const __m128i *>(&tables.counts[t][i])));
+				}
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(histogram + i), sum);
+			}
+		}
+#endif
+
+#ifdef CLOCKUTILS_COMPRESSION_AVX2
+		__attribute__((target("avx2"))) void mergeAVX2(const HistogramTables & tables, uint32_t * histogram) {
+			for (size_t i = 0; i < 256; i += 8) {
+				__m256i sum = _mm256_load_si256(reinterpret_cast<const __m256i *>(&tables.counts[0][i]));
+				for (size_t t = 1; t < HISTOGRAM_TABLES; t++) {
+					sum = _mm256_add_epi32(sum, _mm256_load_si256(reinterpret_cast<const __m256i *>(&tables.counts[t][i])));
+				}
+				_mm256_storeu_si256(reinterpret_cast<__m256i *>(histogram + i), sum);
+			}
+		}
+#endif
+
+		/**
+		 * \brief chooses the fastest merge the cpu supports
+		 */
+		MergeFunction selectMerge() {
+#ifdef CLOCKUTILS_COMPRESSION_AVX2
+			if (__builtin_cpu_supports("avx2")) {
+				return &mergeAVX2;
+			}
+#endif
+#ifdef CLOCKUTILS_COMPRESSION_SSE2
+			return &mergeSSE2;
+#else
+			return &mergeScalar;
+#endif
+		}
+
+		/**
+		 * \brief the merge used by calcHistogram
+		 */
+		std::atomic<MergeFunction> & activeMerge() {
+			static std::atomic<MergeFunction> merge(selectMerge());
+			return merge;
+		}
+
+	} /* namespace */
+
+	bool HuffmanBase::setHistogramMerge(HistogramMerge merge) {
+		MergeFunction function = nullptr;
+		switch (merge) {
+		case HistogramMerge::Auto: {
+			function = selectMerge();
+			break;
+		}
+		case HistogramMerge::Scalar: {
+			function = &mergeScalar;
+			break;
+		}
+		case HistogramMerge::SSE2: {
+#ifdef CLOCKUTILS_COMPRESSION_SSE2
+			function = &mergeSSE2;
+#endif
+			break;
+		}
+		case HistogramMerge::AVX2: {
+#ifdef CLOCKUTILS_COMPRESSION_AVX2
+			if (__builtin_cpu_supports("avx2")) {
+				function = &mergeAVX2;
+			}
+#endif
+			break;
+		}
+		default: {
+			break;
+		}
+		}
+		if (!function) {
+			return false;
+		}
+		activeMerge().store(function, std::memory_order_relaxed);
+		return true;
+	}
+
+	void HuffmanBase::calcHistogram(const std::string & text, std::vector<len_t> & histogram) {
+		calcHistogram(reinterpret_cast<const uint8_t *>(text.data()), text.length(), histogram);
+	}
+
+	void HuffmanBase::calcHistogram(const uint8_t * data, size_t length, std::vector<len_t> & histogram) {
+		const MergeFunction merge = activeMerge().load(std::memory_order_relaxed);
+
+		HistogramTables tables;
+		memset(&tables, 0, sizeof(tables));
+		const uint8_t * const end = data + length;
+		// 16 bytes per iteration, every table counts two of them
+		for (; end - data >= 16; data += 16) {
+			uint64_t first;
+			uint64_t second;
+			memcpy(&first, data, 8);
+			memcpy(&second, data + 8, 8);
+			for (size_t t = 0; t < HISTOGRAM_TABLES; t++) {
+				tables.counts[t][uint8_t(first >> (8 * t))]++;
+			}
+			for (size_t t = 0; t < HISTOGRAM_TABLES; t++) {
+				tables.counts[t][uint8_t(second >> (8 * t))]++;
+			}
+		}
+		for (; data < end; data++) {
+			tables.counts[0][*data]++;
+		}
+
+		histogram.resize(256);
+		merge(tables, histogram.data());
+	}
+
+	uint64_t HuffmanBase::countBits(const std::vector<len_t> & histogram, const std::vector<Code> & codes) {
+		uint64_t bits = 0;
+		for (size_t i = 0; i < histogram.size(); i++) {
+			bits += uint64_t(histogram[i]) * codes[i].length;
+		}
+		return bits;
+	}
+
+	void HuffmanBase::buildLengths(const std::vector<len_t> & histogram, uint8_t maxLength, std::vector<uint8_t> & lengths) {
+		lengths.assign(histogram.size(), 0);
+
+		std::vector<uint32_t> symbols;
+		for (size_t i = 0; i < histogram.size(); i++) {
+			if (histogram[i] > 0) {
+				symbols.push_back(uint32_t(i));
+			}
+		}
+		if (symbols.empty()) {
+			return;
+		}
+		if (symbols.size() == 1) {
+			lengths[symbols[0]] = 1;
 			return;
 		}
-		std::vector<bool> left = bitSeq;
-		left.push_back(true);
-		generateMapping(node->left, left, mapping);
+		assert(symbols.size() <= (size_t(1) << maxLength));
+		std::stable_sort(symbols.begin(), symbols.end(), [&histogram](uint32_t a, uint32_t b) {
+			return histogram[a] < histogram[b];
+		});
+
+		// package-merge: every list contains the leaves and the pairs of the previous list, both sorted by weight
+		// the 2n - 2 lightest items of the last list define the code lengths, every appearance of a leaf in them adds one bit to its code
+		struct Item {
+			uint64_t weight;
+			int32_t symbol; // -1 for packages
+			uint32_t left;
+			uint32_t right;
+		};
+		std::vector<Item> items;
+		items.reserve(symbols.size() * 2 * maxLength);
+		std::vector<uint32_t> leaves;
+		for (uint32_t symbol : symbols) {
+			leaves.push_back(uint32_t(items.size()));
+			items.push_back(Item { histogram[symbol], int32_t(symbol), 0, 0 });
+		}
+		std::vector<uint32_t> list = leaves;
+		for (uint8_t level = 1; level < maxLength; level++) {
+			std::vector<uint32_t> merged;
+			merged.reserve(leaves.size() + list.size() / 2);
+			size_t leaf = 0;
+			for (size_t i = 0; i + 1 < list.size(); i += 2) {
+				const Item package = { items[list[i]].weight + items[list[i + 1]].weight, -1, list[i], list[i + 1] };
+				while (leaf < leaves.size() && items[leaves[leaf]].weight <= package.weight) {
+					merged.push_back(leaves[leaf++]);
+				}
+				merged.push_back(uint32_t(items.size()));
+				items.push_back(package);
+			}
+			while (leaf < leaves.size()) {
+				merged.push_back(leaves[leaf++]);
+			}
+			list.swap(merged);
+		}
+
+		std::vector<uint32_t> stack(list.begin(), list.begin() + std::ptrdiff_t(2 * symbols.size() - 2));
+		while (!stack.empty()) {
+			const Item & item = items[stack.back()];
+			stack.pop_back();
+			if (item.symbol >= 0) {
+				lengths[size_t(item.symbol)]++;
+			} else {
+				stack.push_back(item.left);
+				stack.push_back(item.right);
+			}
+		}
+	}
+
+	void HuffmanBase::buildCanonicalCodes(const std::vector<uint8_t> & lengths, std::vector<Code> & codes) {
+		codes.assign(lengths.size(), Code { 0, 0 });
+		uint32_t counts[33] = { 0 };
+		for (uint8_t length : lengths) {
+			assert(length <= 32);
+			counts[length]++;
+		}
+		counts[0] = 0;
+		uint32_t next[33] = { 0 };
+		uint32_t code = 0;
+		for (size_t length = 1; length <= 32; length++) {
+			code = (code + counts[length - 1]) << 1;
+			next[length] = code;
+		}
+		for (size_t i = 0; i < lengths.size(); i++) {
+			if (lengths[i] > 0) {
+				codes[i].code = next[lengths[i]]++;
+				codes[i].length = lengths[i];
+			}
+		}
+	}
+
+	void HuffmanBase::writeLengths(const std::vector<uint8_t> & lengths, std::string & result) {
+		size_t count = lengths.size();
+		while (count > 0 && lengths[count - 1] == 0) {
+			count--;
+		}
+		assert(count <= 0xFFFF);
+		result += char(uint8_t(count >> 8));
+		result += char(uint8_t(count & 0xFF));
+
+		std::vector<uint8_t> nibbles;
+		for (size_t i = 0; i < count;) {
+			if (lengths[i] > 0) {
+				assert(lengths[i] <= 15);
+				nibbles.push_back(lengths[i++]);
+				continue;
+			}
+			size_t run = 0;
+			while (i < count && lengths[i] == 0 && run < 16) {
+				run++;
+				i++;
+			}
+			nibbles.push_back(0);
+			nibbles.push_back(uint8_t(run - 1));
+		}
+		for (size_t i = 0; i < nibbles.size(); i += 2) {
+			result += char(uint8_t((nibbles[i] << 4) | ((i + 1 < nibbles.size()) ? nibbles[i + 1] : 0)));
+		}
+	}
 
-		std::vector<bool> right = bitSeq;
-		right.push_back(false);
-		generateMapping(node->right, right, mapping);
+	size_t HuffmanBase::maxLengthsSize(size_t alphabetSize) {
+		// the last symbol is used, so at most every second symbol is a run of unused ones
+		const size_t nibbles = alphabetSize + alphabetSize / 2;
+		return 2 + (nibbles + 1) / 2;
 	}
 
-	ClockError HuffmanBase::getChar(const std::string & compressed, const std::shared_ptr<Node> & root, len_t length, std::string & result) {
-		assert(root);
-		// first bit of first byte, actual bit index in stream is byteIndex * 8 + bitIndex
-		uint8_t bitIndex = 0;
-		len_t byteIndex = 0;
+	ClockError HuffmanBase::readLengths(const uint8_t * data, size_t size, size_t & pos, size_t alphabetSize, std::vector<uint8_t> & lengths) {
+		if (pos + 2 > size) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+		const size_t count = (size_t(data[pos]) << 8) | data[pos + 1];
+		pos += 2;
+		if (count > alphabetSize) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+		lengths.assign(alphabetSize, 0);
+
+		size_t nibble = 0; // index of the next nibble starting at pos
+		auto next = [&](uint8_t & value) {
+			const size_t byte = pos + nibble / 2;
+			if (byte >= size) {
+				return false;
+			}
+			value = (nibble % 2 == 0) ? uint8_t(data[byte] >> 4) : uint8_t(data[byte] & 0x0F);
+			nibble++;
+			return true;
+		};
+		for (size_t i = 0; i < count;) {
+			uint8_t value;
+			if (!next(value)) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			if (value > 0) {
+				lengths[i++] = value;
+				continue;
+			}
+			if (!next(value) || i + value + 1 > count) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			i += value + 1u;
+		}
+		pos += (nibble + 1) / 2;
 
-		uint8_t currentChar = compressed[0];
+		return ClockError::SUCCESS;
+	}
 
-		bool endReached = false;
-		for (len_t i = 0; i < length; i++) {
-			std::shared_ptr<Node> node = root;
-			while (node->left != nullptr || node->right != nullptr) {
-				if (endReached) {
+	void HuffmanBase::encode(const uint8_t * data, size_t length, const std::vector<Code> & codes, char * out) {
+		uint8_t maxLength = 0;
+		for (const Code & c : codes) {
+			maxLength = std::max(maxLength, c.length);
+		}
+		if (maxLength == 0) {
+			// only one character, it's encoded with 0 bits
+			return;
+		}
+		const Code * table = codes.data();
+		BitWriter writer(out);
+		for (const uint8_t * const end = data + length; data < end; data++) {
+			writer.write(table[*data].code, table[*data].length);
+		}
+		writer.flush();
+	}
+
+	void HuffmanBase::generateCodes(const Tree & tree, std::vector<Code> & codes) {
+		if (tree.root == Tree::NONE) {
+			return;
+		}
+		struct Entry {
+			uint16_t node;
+			uint8_t length;
+			uint32_t code;
+		};
+		// depth first traversal, the stack never contains more entries than the tree has nodes
+		std::array<Entry, Tree::MAX_NODES> stack;
+		size_t stackSize = 0;
+		stack[stackSize++] = Entry { tree.root, 0, 0 };
+		while (stackSize > 0) {
+			const Entry e = stack[--stackSize];
+			const Tree::Node & node = tree.nodes[e.node];
+			// reached leaves
+			if (node.left == Tree::NONE) {
+				assert(node.right == Tree::NONE);
+				codes[node.c].code = e.code;
+				codes[node.c].length = e.length;
+				continue;
+			}
+			assert(e.length < 32);
+			// left child is encoded as 1
+			stack[stackSize++] = Entry { node.left, uint8_t(e.length + 1), (e.code << 1) | 1 };
+			stack[stackSize++] = Entry { node.right, uint8_t(e.length + 1), e.code << 1 };
+		}
+	}
+
+	ClockError HuffmanBase::buildDecodeTable(const std::vector<Code> & codes, DecodeTable & table, bool pairs) {
+		table.maxLength = 0;
+		table.single = 0;
+		for (const Code & c : codes) {
+			if (c.length > 32) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			if (c.length > table.maxLength) {
+				table.maxLength = c.length;
+			}
+		}
+		if (table.maxLength == 0 || codes.size() > (size_t(1) << 24)) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+
+		// Kraft inequality, overlapping codes can't be decoded
+		uint64_t kraft = 0;
+		for (const Code & c : codes) {
+			if (c.length > 0) {
+				kraft += uint64_t(1) << (table.maxLength - c.length);
+			}
+		}
+		if (kraft > (uint64_t(1) << table.maxLength)) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+
+		// small alphabets with short codes also use the full first level, so more entries can contain two characters
+		const bool dual = pairs && codes.size() <= 256;
+		table.tableBits = (table.maxLength < DecodeTable::TABLE_BITS && !dual) ? table.maxLength : DecodeTable::TABLE_BITS;
+		const uint32_t tableBits = table.tableBits;
+		table.entries.assign(size_t(1) << tableBits, 0);
+
+		// second level tables are as large as the longest code with the same prefix needs
+		std::vector<uint8_t> subBits(size_t(1) << tableBits, 0);
+		for (const Code & c : codes) {
+			if (c.length > tableBits) {
+				uint8_t & bits = subBits[c.code >> (c.length - tableBits)];
+				bits = std::max(bits, uint8_t(c.length - tableBits));
+			}
+		}
+		for (size_t prefix = 0; prefix < subBits.size(); prefix++) {
+			if (subBits[prefix] > 0) {
+				const size_t offset = table.entries.size();
+				if (offset >= (size_t(1) << 24)) {
+					return ClockError::INVALID_ARGUMENT;
+				}
+				table.entries[prefix] = uint32_t(offset << 8) | DecodeTable::SUBTABLE | subBits[prefix];
+				table.entries.resize(offset + (size_t(1) << subBits[prefix]), 0);
+			}
+		}
+
+		for (size_t symbol = 0; symbol < codes.size(); symbol++) {
+			const Code & c = codes[symbol];
+			if (c.length == 0) {
+				continue;
+			}
+			const uint32_t entry = uint32_t(symbol << 8) | c.length;
+			if (c.length <= tableBits) {
+				const size_t first = size_t(c.code) << (tableBits - c.length);
+				std::fill(table.entries.begin() + first, table.entries.begin() + first + (size_t(1) << (tableBits - c.length)), entry);
+			} else {
+				const uint32_t remaining = c.length - tableBits;
+				const uint32_t pointer = table.entries[c.code >> remaining];
+				const uint32_t bits = pointer & DecodeTable::LENGTH_MASK;
+				const size_t first = (pointer >> 8) + ((size_t(c.code) & ((size_t(1) << remaining) - 1)) << (bits - remaining));
+				std::fill(table.entries.begin() + first, table.entries.begin() + first + (size_t(1) << (bits - remaining)), entry);
+			}
+		}
+
+		// for byte alphabets a first level entry can contain two characters if both codes fit into the index
+		if (dual) {
+			const size_t mask = (size_t(1) << tableBits) - 1;
+			const std::vector<uint32_t> single(table.entries.begin(), table.entries.begin() + (size_t(1) << tableBits));
+			for (size_t index = 0; index <= mask; index++) {
+				const uint32_t first = single[index];
+				const uint32_t firstLength = first & DecodeTable::LENGTH_MASK;
+				if ((first & DecodeTable::SUBTABLE) || firstLength == 0 || firstLength == tableBits) {
+					continue;
+				}
+				const uint32_t second = single[(index << firstLength) & mask];
+				const uint32_t secondLength = second & DecodeTable::LENGTH_MASK;
+				if ((second & DecodeTable::SUBTABLE) || secondLength == 0 || secondLength > tableBits - firstLength) {
+					continue;
+				}
+				table.entries[index] = (firstLength << 24) | (((second >> 8) & 0xFF) << 16) | (first & 0xFF00) | DecodeTable::DUAL | (firstLength + secondLength);
+			}
+		}
+
+		return ClockError::SUCCESS;
+	}
+
+	ClockError HuffmanBase::buildDecodeTable(const Tree & tree, DecodeTable & table) {
+		if (tree.root == Tree::NONE || tree.nodes[tree.root].left == Tree::NONE) {
+			// a tree with at most one leaf, the character is encoded with 0 bits
+			table.tableBits = 0;
+			table.maxLength = 0;
+			table.single = (tree.root == Tree::NONE) ? 0 : tree.nodes[tree.root].c;
+			table.entries.clear();
+			return ClockError::SUCCESS;
+		}
+		std::vector<Code> codes(256, Code { 0, 0 });
+		generateCodes(tree, codes);
+		return buildDecodeTable(codes, table);
+	}
+
+	ClockError HuffmanBase::decode(const uint8_t * data, size_t size, const DecodeTable & table, len_t length, char * out) {
+		if (size == 0) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+
+		if (table.maxLength == 0) {
+			// every character is encoded with 0 bits, so there's only the padding byte
+			std::fill(out, out + length, char(table.single));
+			return (size == 1) ? ClockError::SUCCESS : ClockError::INVALID_ARGUMENT;
+		}
+
+		uint64_t bitPos = 0;
+		ClockError error = decodeSequence(data, size, bitPos, table, out, out + length);
+		if (error != ClockError::SUCCESS) {
+			return error;
+		}
+		return (bitPos / 8 == size - 1) ? ClockError::SUCCESS : ClockError::INVALID_ARGUMENT;
+	}
+
+	ClockError HuffmanBase::decodeSequence(const uint8_t * data, size_t size, uint64_t & bitPos, const DecodeTable & table, char * out, char * end) {
+		const uint64_t totalBits = uint64_t(size) * 8;
+		const uint32_t tableShift = 64 - table.tableBits;
+		const uint32_t * entries = table.entries.data();
+		// every lookup must only see valid bits of the buffer
+		const uint32_t lookahead = (table.maxLength > table.tableBits) ? table.maxLength : table.tableBits;
+		while (end - out >= 2) {
+			if (bitPos >= totalBits) { // no more bits left
+				return ClockError::INVALID_ARGUMENT;
+			}
+			uint64_t buffer = BitReader::peek(data, size, bitPos);
+			// one load contains at least 57 valid bits, decode as many characters as fit completely
+			const uint32_t limit = 64 - uint32_t(bitPos & 7) - lookahead;
+			uint32_t used = 0;
+			while (used <= limit && end - out >= 2) {
+				uint32_t entry = entries[buffer >> tableShift];
+				if (entry & DecodeTable::SUBTABLE) {
+					entry = entries[(entry >> 8) + ((buffer << table.tableBits) >> (64 - (entry & DecodeTable::LENGTH_MASK)))];
+				}
+				const uint32_t codeLength = entry & DecodeTable::LENGTH_MASK;
+				if (codeLength == 0) { // no code with this prefix
+					return ClockError::INVALID_ARGUMENT;
+				}
+				// writing both characters unconditionally avoids a branch, the second one is overwritten if the entry contains only one
+				out[0] = char(entry >> 8);
+				out[1] = char(entry >> 16);
+				out += 1 + ((entry & DecodeTable::DUAL) ? 1 : 0);
+				buffer <<= codeLength;
+				used += codeLength;
+			}
+			bitPos += used;
+		}
+		if (out != end) {
+			// last character, an entry with two characters must only consume the bits of the first one
+			if (bitPos >= totalBits) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			const uint64_t buffer = BitReader::peek(data, size, bitPos);
+			uint32_t entry = entries[buffer >> tableShift];
+			if (entry & DecodeTable::SUBTABLE) {
+				entry = entries[(entry >> 8) + ((buffer << table.tableBits) >> (64 - (entry & DecodeTable::LENGTH_MASK)))];
+			}
+			const uint32_t codeLength = (entry & DecodeTable::DUAL) ? ((entry >> 24) & DecodeTable::LENGTH_MASK) : (entry & DecodeTable::LENGTH_MASK);
+			if (codeLength == 0) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			*out = char(entry >> 8);
+			bitPos += codeLength;
+		}
+		return ClockError::SUCCESS;
+	}
+
+	size_t HuffmanBase::interleavedSize(const uint8_t * data, size_t length, const std::vector<Code> & codes, size_t (&sizes)[STREAMS]) {
+		const size_t segment = (length + STREAMS - 1) / STREAMS;
+		size_t total = 4 * (STREAMS - 1);
+		for (size_t i = 0; i < STREAMS; i++) {
+			const size_t begin = std::min(i * segment, length);
+			const size_t end = std::min(begin + segment, length);
+			uint64_t bits = 0;
+			for (size_t j = begin; j < end; j++) {
+				bits += codes[data[j]].length;
+			}
+			// bit sequence with at least one byte padding
+			sizes[i] = size_t(bits / 8) + 1;
+			total += sizes[i];
+		}
+		return total;
+	}
+
+	void HuffmanBase::encodeInterleaved(const uint8_t * data, size_t length, const std::vector<Code> & codes, const size_t (&sizes)[STREAMS], char * out) {
+		for (size_t i = 0; i < STREAMS - 1; i++) {
+			for (size_t j = 0; j < 4; j++) {
+				*out++ = char(uint8_t(sizes[i] >> (8 * (3 - j))));
+			}
+		}
+
+		uint8_t maxLength = 0;
+		for (const Code & c : codes) {
+			maxLength = std::max(maxLength, c.length);
+		}
+		const size_t segment = (length + STREAMS - 1) / STREAMS;
+		for (size_t i = 0; i < STREAMS; i++) {
+			// the padding byte isn't written if it doesn't contain any bits
+			out[sizes[i] - 1] = 0x0;
+			if (maxLength == 0) {
+				// only one character, it's encoded with 0 bits
+				out += sizes[i];
+				continue;
+			}
+			const size_t begin = std::min(i * segment, length);
+			const size_t end = std::min(begin + segment, length);
+			BitWriter writer(out);
+			for (size_t j = begin; j < end; j++) {
+				writer.write(codes[data[j]].code, codes[data[j]].length);
+			}
+			writer.flush();
+			out += sizes[i];
+		}
+	}
+
+	ClockError HuffmanBase::decodeInterleaved(const uint8_t * data, size_t size, const DecodeTable & table, len_t length, char * out) {
+		const size_t jumpTableSize = 4 * (STREAMS - 1);
+		if (size < jumpTableSize) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+
+		struct Stream {
+			const uint8_t * data;
+			size_t size;
+			uint64_t bitPos;
+			char * out;
+			char * end;
+		};
+		Stream streams[STREAMS];
+		const size_t segment = (size_t(length) + STREAMS - 1) / STREAMS;
+		size_t pos = jumpTableSize;
+		for (size_t i = 0; i < STREAMS; i++) {
+			size_t streamSize = size - pos;
+			if (i < STREAMS - 1) {
+				streamSize = 0;
+				for (size_t j = 0; j < 4; j++) {
+					streamSize = (streamSize << 8) | data[4 * i + j];
+				}
+			}
+			// every bit sequence contains at least the padding byte
+			if (streamSize == 0 || streamSize > size - pos) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			const size_t begin = std::min(i * segment, size_t(length));
+			streams[i] = Stream { data + pos, streamSize, 0, out + begin, out + std::min(begin + segment, size_t(length)) };
+			pos += streamSize;
+		}
+
+		if (table.maxLength == 0) {
+			// every character is encoded with 0 bits, so there's only the padding byte
+			std::fill(out, out + length, char(table.single));
+			for (const Stream & stream : streams) {
+				if (stream.size != 1) {
 					return ClockError::INVALID_ARGUMENT;
 				}
-				node = (currentChar & (1 << (7 - bitIndex))) ? node->left : node->right;
-				bitIndex++;
-				if (bitIndex == 8) { // next byte
-					bitIndex = 0;
-					byteIndex++;
-					if (byteIndex >= compressed.length()) { // no more bytes left
-						endReached = true;
-					} else {
-						currentChar = compressed[byteIndex];
+			}
+			return ClockError::SUCCESS;
+		}
+
+		const uint32_t tableShift = 64 - table.tableBits;
+		const uint32_t * entries = table.entries.data();
+		const uint32_t lookahead = (table.maxLength > table.tableBits) ? table.maxLength : table.tableBits;
+		// every load contains at least 57 valid bits, so this amount of codes can be decoded without checking the consumed bits
+		const size_t codesPerLoad = std::min(size_t(57 / lookahead), size_t(4));
+		// every code can produce 2 characters
+		const std::ptrdiff_t margin = std::ptrdiff_t(2 * codesPerLoad);
+		bool fast = true;
+		while (fast) {
+			for (Stream & stream : streams) {
+				if (stream.end - stream.out < margin || stream.bitPos >= uint64_t(stream.size) * 8) {
+					fast = false;
+				}
+			}
+			if (!fast) {
+				break;
+			}
+			// the streams don't depend on each other, so the cpu can work on all of them in parallel
+			for (Stream & stream : streams) {
+				// local copies, the compiler can't keep the members in registers because the written characters could alias them
+				char * dest = stream.out;
+				uint64_t buffer = BitReader::peek(stream.data, stream.size, stream.bitPos);
+				uint32_t used = 0;
+				for (size_t i = 0; i < codesPerLoad; i++) {
+					uint32_t entry = entries[buffer >> tableShift];
+					if (entry & DecodeTable::SUBTABLE) {
+						entry = entries[(entry >> 8) + ((buffer << table.tableBits) >> (64 - (entry & DecodeTable::LENGTH_MASK)))];
+					}
+					const uint32_t codeLength = entry & DecodeTable::LENGTH_MASK;
+					if (codeLength == 0) {
+						return ClockError::INVALID_ARGUMENT;
 					}
+					dest[0] = char(entry >> 8);
+					dest[1] = char(entry >> 16);
+					dest += 1 + ((entry & DecodeTable::DUAL) ? 1 : 0);
+					buffer <<= codeLength;
+					used += codeLength;
 				}
+				stream.out = dest;
+				stream.bitPos += used;
 			}
-			result[i] = node->c;
 		}
 
-		return (byteIndex == compressed.length() - 1) ? ClockError::SUCCESS : ClockError::INVALID_ARGUMENT;
+		// the rest of every stream
+		for (Stream & stream : streams) {
+			ClockError error = decodeSequence(stream.data, stream.size, stream.bitPos, table, stream.out, stream.end);
+			if (error != ClockError::SUCCESS) {
+				return error;
+			}
+			if (stream.bitPos / 8 != stream.size - 1) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+		}
+		return ClockError::SUCCESS;
 	}
 
 } /* namespace algorithm */
@@ -0,0 +1,141 @@
+/*
+ * clockUtils
+ * Copyright (2015) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "clockUtils/compression/algorithm/HuffmanCanonical.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "clockUtils/errors.h"
+
+namespace clockUtils {
+namespace compression {
+namespace algorithm {
+
+	ClockError HuffmanCanonical::compress(const std::string & uncompressed, std::string & compressed) {
+		OutputBuffer out(compressed);
+		return compress(reinterpret_cast<const uint8_t *>(uncompressed.data()), uncompressed.length(), out);
+	}
+
+	ClockError HuffmanCanonical::decompress(const std::string & compressed, std::string & decompressed) {
+		OutputBuffer out(decompressed);
+		return decompress(reinterpret_cast<const uint8_t *>(compressed.data()), compressed.length(), out);
+	}
+
+	ClockError HuffmanCanonical::compress(const void * uncompressed, size_t length, void * compressed, size_t capacity, size_t & compressedLength) {
+		OutputBuffer out(compressed, capacity);
+		ClockError error = compress(static_cast<const uint8_t *>(uncompressed), length, out);
+		compressedLength = out.size();
+		return error;
+	}
+
+	ClockError HuffmanCanonical::decompress(const void * compressed, size_t length, void * decompressed, size_t capacity, size_t & decompressedLength) {
+		OutputBuffer out(decompressed, capacity);
+		ClockError error = decompress(static_cast<const uint8_t *>(compressed), length, out);
+		decompressedLength = out.size();
+		return error;
+	}
+
+	size_t HuffmanCanonical::maxCompressedSize(size_t length) {
+		if (length == 0) {
+			return sizeof(len_t);
+		}
+		// the code lengths of the 256 bytes followed by at most MAX_CODE_LENGTH bits per byte
+		return sizeof(len_t) + maxLengthsSize(256) + length / 8 * MAX_CODE_LENGTH + (length % 8 * MAX_CODE_LENGTH) / 8 + 1;
+	}
+
+	ClockError HuffmanCanonical::compress(const uint8_t * data, size_t length, OutputBuffer & out) {
+		if (length > std::numeric_limits<len_t>::max()) {
+			// string is too long
+			return ClockError::INVALID_ARGUMENT;
+		}
+		std::vector<len_t> histogram;
+		calcHistogram(data, length, histogram);
+		std::vector<uint8_t> lengths;
+		buildLengths(histogram, MAX_CODE_LENGTH, lengths);
+		std::vector<Code> codes;
+		buildCanonicalCodes(lengths, codes);
+
+		std::string header;
+		try {
+			len_t len = len_t(length);
+			for (size_t i = 0; i < sizeof(len_t); i++) {
+				header += char(uint8_t((len >> (8 * (sizeof(len_t) - 1 - i))) & 0xFF));
+			}
+			if (length > 0) {
+				writeLengths(lengths, header);
+			}
+		} catch (std::bad_alloc &) {
+			return ClockError::OUT_OF_MEMORY;
+		}
+
+		// bit sequence with at least one byte padding, an empty string consists only of its length
+		const size_t size = header.length() + ((length > 0) ? size_t(countBits(histogram, codes) / 8) + 1 : 0);
+		char * compressed = out.allocate(size);
+		if (!compressed) {
+			return ClockError::OUT_OF_MEMORY;
+		}
+		std::copy(header.begin(), header.end(), compressed);
+		if (length > 0) {
+			compressed[size - 1] = 0x0;
+			encode(data, length, codes, compressed + header.length());
+		}
+
+		return ClockError::SUCCESS;
+	}
+
+	ClockError HuffmanCanonical::decompress(const uint8_t * data, size_t length, OutputBuffer & out) {
+		if (length < sizeof(len_t)) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+		len_t len = 0;
+		for (size_t i = 0; i < sizeof(len_t); i++) {
+			len *= 0x100; // * 256
+			len += data[i];
+		}
+		if (len == 0) {
+			out.allocate(0);
+			return (length == sizeof(len_t)) ? ClockError::SUCCESS : ClockError::INVALID_ARGUMENT;
+		}
+
+		size_t pos = sizeof(len_t);
+		std::vector<uint8_t> lengths;
+		ClockError error = readLengths(data, length, pos, 256, lengths);
+		if (error != ClockError::SUCCESS) {
+			return error;
+		}
+		std::vector<Code> codes;
+		buildCanonicalCodes(lengths, codes);
+		DecodeTable table;
+		error = buildDecodeTable(codes, table);
+		if (error != ClockError::SUCCESS) {
+			return error;
+		}
+
+		char * decompressed = out.allocate(len);
+		if (!decompressed) {
+			return ClockError::OUT_OF_MEMORY;
+		}
+
+		return decode(data + pos, length - pos, table, len, decompressed);
+	}
+
+} /* namespace algorithm */
+} /* namespace compression */
+} /* namespace clockUtils */
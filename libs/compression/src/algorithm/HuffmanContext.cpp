@@ -0,0 +1,449 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "clockUtils/compression/algorithm/HuffmanContext.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "clockUtils/errors.h"
+
+namespace clockUtils {
+namespace compression {
+namespace algorithm {
+
+	namespace {
+
+		/**
+		 * \brief size of the bitmap marking the previous bytes that occur in the string
+		 */
+		const size_t BITMAP_SIZE = 256 / 8;
+
+		/**
+		 * \brief strings shorter than this are counted by sorting
+		 */
+		const size_t SHORT_LENGTH = 4096;
+
+		/**
+		 * \brief amount of bits needed to store a class id
+		 */
+		uint32_t classBits(size_t classes) {
+			uint32_t bits = 0;
+			while ((size_t(1) << bits) < classes) {
+				bits++;
+			}
+			return bits;
+		}
+
+		/**
+		 * \brief the bytes following one previous byte, only the ones that occur are stored because most contexts are followed by few different bytes
+		 */
+		struct Context {
+			uint8_t byte;
+			uint32_t count;
+			std::vector<std::pair<uint8_t, uint32_t>> followers;
+		};
+
+		/**
+		 * \brief counts the bytes following every previous byte, the first byte follows the byte 0
+		 * the contexts are sorted by their amount, short strings sort their pairs instead of clearing a histogram with 65536 entries
+		 */
+		std::vector<Context> collectContexts(const uint8_t * data, size_t length) {
+			std::vector<Context> contexts;
+			if (length < SHORT_LENGTH) {
+				std::vector<uint16_t> pairs(length);
+				uint8_t previous = 0;
+				for (size_t i = 0; i < length; i++) {
+					pairs[i] = uint16_t((previous << 8) | data[i]);
+					previous = data[i];
+				}
+				std::sort(pairs.begin(), pairs.end());
+				for (size_t i = 0; i < length;) {
+					size_t j = i + 1;
+					while (j < length && pairs[j] == pairs[i]) {
+						j++;
+					}
+					const uint8_t context = uint8_t(pairs[i] >> 8);
+					if (contexts.empty() || contexts.back().byte != context) {
+						contexts.push_back(Context { context, 0, {} });
+					}
+					contexts.back().count += uint32_t(j - i);
+					contexts.back().followers.push_back(std::make_pair(uint8_t(pairs[i] & 0xFF), uint32_t(j - i)));
+					i = j;
+				}
+			} else {
+				std::vector<uint32_t> histograms(256 * 256, 0);
+				uint8_t previous = 0;
+				for (size_t i = 0; i < length; i++) {
+					histograms[size_t(previous) * 256 + data[i]]++;
+					previous = data[i];
+				}
+				for (size_t c = 0; c < 256; c++) {
+					Context context = { uint8_t(c), 0, {} };
+					for (size_t next = 0; next < 256; next++) {
+						const uint32_t count = histograms[c * 256 + next];
+						if (count > 0) {
+							context.count += count;
+							context.followers.push_back(std::make_pair(uint8_t(next), count));
+						}
+					}
+					if (context.count > 0) {
+						contexts.push_back(context);
+					}
+				}
+			}
+			std::stable_sort(contexts.begin(), contexts.end(), [](const Context & a, const Context & b) {
+				return a.count > b.count;
+			});
+			return contexts;
+		}
+
+		/**
+		 * \brief assigns every context to one of classes classes and returns the histograms of the classes
+		 * the first classes contexts (the most frequent ones) are the seeds of the classes, every other context is added to the class whose seed needs the least bits for its followers
+		 */
+		std::vector<std::vector<uint32_t>> assignClasses(const std::vector<Context> & contexts, size_t classes, uint8_t (&contextClasses)[256]) {
+			std::vector<std::vector<uint32_t>> histograms(classes, std::vector<uint32_t>(256, 0));
+			for (size_t k = 0; k < classes; k++) {
+				contextClasses[contexts[k].byte] = uint8_t(k);
+				for (const auto & f : contexts[k].followers) {
+					histograms[k][f.first] += f.second;
+				}
+			}
+			if (contexts.size() > classes) {
+				// estimated bits per byte of every seed, bytes not following the seed get a small probability so they are possible, but expensive
+				std::vector<std::vector<double>> costs(classes);
+				for (size_t k = 0; k < classes; k++) {
+					const double total = std::log2(double(contexts[k].count) + 128.0);
+					costs[k].assign(256, total + 1.0);
+					for (const auto & f : contexts[k].followers) {
+						costs[k][f.first] = total - std::log2(double(f.second) + 0.5);
+					}
+				}
+				for (size_t i = classes; i < contexts.size(); i++) {
+					size_t best = 0;
+					double bestCost = std::numeric_limits<double>::max();
+					for (size_t k = 0; k < classes; k++) {
+						double cost = 0.0;
+						for (const auto & f : contexts[i].followers) {
+							cost += double(f.second) * costs[k][f.first];
+						}
+						if (cost < bestCost) {
+							bestCost = cost;
+							best = k;
+						}
+					}
+					contextClasses[contexts[i].byte] = uint8_t(best);
+				}
+				for (size_t i = classes; i < contexts.size(); i++) {
+					std::vector<uint32_t> & histogram = histograms[contextClasses[contexts[i].byte]];
+					for (const auto & f : contexts[i].followers) {
+						histogram[f.first] += f.second;
+					}
+				}
+			}
+			return histograms;
+		}
+
+		/**
+		 * \brief estimates the size of the output in bits using the entropy of every class and the approximate size of the header
+		 */
+		double estimateBits(const std::vector<std::vector<uint32_t>> & histograms, size_t contexts) {
+			double bits = (histograms.size() > 1) ? double(BITMAP_SIZE * 8 + contexts * classBits(histograms.size())) : 0.0;
+			for (const std::vector<uint32_t> & histogram : histograms) {
+				uint64_t total = 0;
+				size_t used = 0;
+				for (uint32_t count : histogram) {
+					total += count;
+					used += (count > 0) ? 1 : 0;
+				}
+				// amount and one nibble per used byte, some more for the runs of unused bytes
+				bits += double(16 + 4 * used + 32);
+				for (uint32_t count : histogram) {
+					if (count > 0) {
+						bits += double(count) * std::log2(double(total) / double(count));
+					}
+				}
+			}
+			return bits;
+		}
+
+	} /* namespace */
+
+	ClockError HuffmanContext::compress(const std::string & uncompressed, std::string & compressed) {
+		OutputBuffer out(compressed);
+		return compress(reinterpret_cast<const uint8_t *>(uncompressed.data()), uncompressed.length(), out);
+	}
+
+	ClockError HuffmanContext::decompress(const std::string & compressed, std::string & decompressed) {
+		OutputBuffer out(decompressed);
+		return decompress(reinterpret_cast<const uint8_t *>(compressed.data()), compressed.length(), out);
+	}
+
+	ClockError HuffmanContext::compress(const void * uncompressed, size_t length, void * compressed, size_t capacity, size_t & compressedLength) {
+		OutputBuffer out(compressed, capacity);
+		ClockError error = compress(static_cast<const uint8_t *>(uncompressed), length, out);
+		compressedLength = out.size();
+		return error;
+	}
+
+	ClockError HuffmanContext::decompress(const void * compressed, size_t length, void * decompressed, size_t capacity, size_t & decompressedLength) {
+		OutputBuffer out(decompressed, capacity);
+		ClockError error = decompress(static_cast<const uint8_t *>(compressed), length, out);
+		decompressedLength = out.size();
+		return error;
+	}
+
+	size_t HuffmanContext::maxCompressedSize(size_t length) {
+		if (length == 0) {
+			return sizeof(len_t);
+		}
+		// amount of classes, the classes of all 256 previous bytes and the code lengths of every class
+		const size_t header = 1 + BITMAP_SIZE + 256 * classBits(MAX_CLASSES) / 8 + MAX_CLASSES * maxLengthsSize(256);
+		return sizeof(len_t) + header + length / 8 * MAX_CODE_LENGTH + (length % 8 * MAX_CODE_LENGTH) / 8 + 1;
+	}
+
+	ClockError HuffmanContext::compress(const uint8_t * data, size_t length, OutputBuffer & out) {
+		if (length > std::numeric_limits<len_t>::max()) {
+			// string is too long
+			return ClockError::INVALID_ARGUMENT;
+		}
+
+		std::string header;
+		std::vector<std::vector<Code>> codes;
+		uint8_t contextClasses[256] = { 0 };
+		uint64_t bits = 0;
+		try {
+			len_t len = len_t(length);
+			for (size_t i = 0; i < sizeof(len_t); i++) {
+				header += char(uint8_t((len >> (8 * (sizeof(len_t) - 1 - i))) & 0xFF));
+			}
+			if (length == 0) {
+				// an empty string consists only of its length
+				char * compressed = out.allocate(header.length());
+				if (!compressed) {
+					return ClockError::OUT_OF_MEMORY;
+				}
+				std::copy(header.begin(), header.end(), compressed);
+				return ClockError::SUCCESS;
+			}
+
+			const std::vector<Context> contexts = collectContexts(data, length);
+
+			// more classes model the string better but need a larger header, so the amount is doubled as long as the estimated output gets smaller
+			const size_t maxClasses = std::min(contexts.size(), size_t(MAX_CLASSES));
+			size_t bestClasses = 1;
+			double bestBits = std::numeric_limits<double>::max();
+			for (size_t classes = 1; classes <= maxClasses; classes = (classes < maxClasses) ? std::min(classes * 2, maxClasses) : classes + 1) {
+				uint8_t assignment[256];
+				const double estimate = estimateBits(assignClasses(contexts, classes, assignment), contexts.size());
+				if (estimate >= bestBits) {
+					break;
+				}
+				bestBits = estimate;
+				bestClasses = classes;
+			}
+			const std::vector<std::vector<uint32_t>> classHistograms = assignClasses(contexts, bestClasses, contextClasses);
+
+			header += char(uint8_t(bestClasses));
+			if (bestClasses > 1) {
+				// bitmap of the previous bytes that occur followed by their classes
+				std::string bitmap(BITMAP_SIZE, '\0');
+				for (const Context & context : contexts) {
+					bitmap[context.byte / 8] = char(uint8_t(bitmap[context.byte / 8]) | (0x80 >> (context.byte % 8)));
+				}
+				header += bitmap;
+				const uint32_t idBits = classBits(bestClasses);
+				uint32_t buffer = 0;
+				uint32_t buffered = 0;
+				for (size_t c = 0; c < 256; c++) {
+					if (uint8_t(bitmap[c / 8]) & (0x80 >> (c % 8))) {
+						buffer = (buffer << idBits) | contextClasses[c];
+						buffered += idBits;
+						while (buffered >= 8) {
+							header += char(uint8_t(buffer >> (buffered - 8)));
+							buffered -= 8;
+						}
+					}
+				}
+				if (buffered > 0) {
+					header += char(uint8_t(buffer << (8 - buffered)));
+				}
+			}
+			codes.resize(bestClasses);
+			for (size_t k = 0; k < bestClasses; k++) {
+				std::vector<uint8_t> lengths;
+				buildLengths(classHistograms[k], MAX_CODE_LENGTH, lengths);
+				buildCanonicalCodes(lengths, codes[k]);
+				writeLengths(lengths, header);
+				bits += countBits(classHistograms[k], codes[k]);
+			}
+		} catch (std::bad_alloc &) {
+			return ClockError::OUT_OF_MEMORY;
+		}
+
+		// bit sequence with at least one byte padding
+		const size_t size = header.length() + size_t(bits / 8) + 1;
+		char * compressed = out.allocate(size);
+		if (!compressed) {
+			return ClockError::OUT_OF_MEMORY;
+		}
+		std::copy(header.begin(), header.end(), compressed);
+		compressed[size - 1] = 0x0;
+
+		const std::vector<Code> * classCodes[256];
+		for (size_t c = 0; c < 256; c++) {
+			classCodes[c] = &codes[contextClasses[c]];
+		}
+		BitWriter writer(compressed + header.length());
+		uint8_t previous = 0;
+		for (const uint8_t * const end = data + length; data < end; data++) {
+			const Code & code = (*classCodes[previous])[*data];
+			writer.write(code.code, code.length);
+			previous = *data;
+		}
+		writer.flush();
+
+		return ClockError::SUCCESS;
+	}
+
+	ClockError HuffmanContext::decompress(const uint8_t * data, size_t length, OutputBuffer & out) {
+		if (length < sizeof(len_t)) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+		len_t len = 0;
+		for (size_t i = 0; i < sizeof(len_t); i++) {
+			len *= 0x100; // * 256
+			len += data[i];
+		}
+		if (len == 0) {
+			out.allocate(0);
+			return (length == sizeof(len_t)) ? ClockError::SUCCESS : ClockError::INVALID_ARGUMENT;
+		}
+		// every byte needs at least one bit
+		if (len / 8 > length) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+
+		size_t pos = sizeof(len_t);
+		if (pos >= length) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+		const size_t classes = data[pos++];
+		if (classes == 0 || classes > MAX_CLASSES) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+		uint8_t contextClasses[256] = { 0 };
+		if (classes > 1) {
+			if (length - pos < BITMAP_SIZE) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			const uint8_t * bitmap = data + pos;
+			pos += BITMAP_SIZE;
+			const uint32_t idBits = classBits(classes);
+			uint64_t bitPos = uint64_t(pos) * 8;
+			for (size_t c = 0; c < 256; c++) {
+				if (bitmap[c / 8] & (0x80 >> (c % 8))) {
+					if (bitPos + idBits > uint64_t(length) * 8) {
+						return ClockError::INVALID_ARGUMENT;
+					}
+					const uint32_t id = uint32_t(BitReader::peek(data, length, bitPos) >> (64 - idBits));
+					if (id >= classes) {
+						return ClockError::INVALID_ARGUMENT;
+					}
+					contextClasses[c] = uint8_t(id);
+					bitPos += idBits;
+				}
+			}
+			pos = size_t((bitPos + 7) / 8);
+		}
+
+		std::vector<DecodeTable> tables(classes);
+		for (size_t k = 0; k < classes; k++) {
+			std::vector<uint8_t> lengths;
+			ClockError error = readLengths(data, length, pos, 256, lengths);
+			if (error != ClockError::SUCCESS) {
+				return error;
+			}
+			for (uint8_t l : lengths) {
+				if (l > MAX_CODE_LENGTH) {
+					return ClockError::INVALID_ARGUMENT;
+				}
+			}
+			std::vector<Code> codes;
+			buildCanonicalCodes(lengths, codes);
+			// entries with two bytes can't be used because the second byte might need another table
+			error = buildDecodeTable(codes, tables[k], false);
+			if (error != ClockError::SUCCESS) {
+				return error;
+			}
+		}
+		if (pos >= length) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+
+		char * decompressed = out.allocate(len);
+		if (!decompressed) {
+			return ClockError::OUT_OF_MEMORY;
+		}
+
+		return decodeContexts(data + pos, length - pos, tables, contextClasses, len, decompressed);
+	}
+
+	ClockError HuffmanContext::decodeContexts(const uint8_t * data, size_t size, const std::vector<DecodeTable> & tables, const uint8_t (&contextClasses)[256], len_t length, char * out) {
+		// the table of every previous byte, so decoding needs no lookup of the class
+		const uint32_t * entries[256];
+		uint32_t shifts[256];
+		for (size_t c = 0; c < 256; c++) {
+			const DecodeTable & table = tables[contextClasses[c]];
+			entries[c] = table.entries.data();
+			shifts[c] = 64 - table.tableBits;
+		}
+
+		const uint64_t totalBits = uint64_t(size) * 8;
+		uint64_t bitPos = 0;
+		uint8_t previous = 0;
+		for (const char * const end = out + length; out < end;) {
+			if (bitPos >= totalBits) { // no more bits left
+				return ClockError::INVALID_ARGUMENT;
+			}
+			uint64_t buffer = BitReader::peek(data, size, bitPos);
+			// one load contains at least 57 valid bits, decode as many characters as fit completely
+			const uint32_t limit = 64 - uint32_t(bitPos & 7) - MAX_CODE_LENGTH;
+			uint32_t used = 0;
+			while (used <= limit && out < end) {
+				const uint32_t entry = entries[previous][buffer >> shifts[previous]];
+				const uint32_t codeLength = entry & DecodeTable::LENGTH_MASK;
+				if (codeLength == 0) { // no code with this prefix
+					return ClockError::INVALID_ARGUMENT;
+				}
+				previous = uint8_t(entry >> 8);
+				*out++ = char(previous);
+				buffer <<= codeLength;
+				used += codeLength;
+			}
+			bitPos += used;
+		}
+		return (bitPos / 8 == size - 1) ? ClockError::SUCCESS : ClockError::INVALID_ARGUMENT;
+	}
+
+} /* namespace algorithm */
+} /* namespace compression */
+} /* namespace clockUtils */
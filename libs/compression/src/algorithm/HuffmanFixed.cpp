@@ -21,6 +21,7 @@
 
 #include "clockUtils/errors.h"
 
+#include <algorithm>
 #include <cassert>
 #include <limits>
 
@@ -57,69 +58,112 @@ namespace algorithm {
 		1, 1, 1, 1, 1, 1
 	});
 
-	std::shared_ptr<HuffmanBase::Node> HuffmanFixed::root = HuffmanFixed::buildTree(preVec);
-	std::vector<std::vector<bool>> HuffmanFixed::mappings = std::vector<std::vector<bool>>(256);
-
 	ClockError HuffmanFixed::compress(const std::string & uncompressed, std::string & compressed) {
-		if (uncompressed.length() > std::numeric_limits<len_t>::max()) {
+		OutputBuffer out(compressed);
+		return compress(reinterpret_cast<const uint8_t *>(uncompressed.data()), uncompressed.length(), out);
+	}
+
+	ClockError HuffmanFixed::decompress(const std::string & compressed, std::string & decompressed) {
+		OutputBuffer out(decompressed);
+		return decompress(reinterpret_cast<const uint8_t *>(compressed.data()), compressed.length(), out);
+	}
+
+	size_t HuffmanFixed::maxCompressedSize(size_t length) {
+		static const size_t maxLength = []() {
+			uint8_t result = 0;
+			for (const Code & c : codes()) {
+				result = std::max(result, c.length);
+			}
+			return size_t(result);
+		}();
+		return sizeof(len_t) + length / 8 * maxLength + (length % 8 * maxLength) / 8 + 1;
+	}
+
+	ClockError HuffmanFixed::compress(const void * uncompressed, size_t length, void * compressed, size_t capacity, size_t & compressedLength) {
+		OutputBuffer out(compressed, capacity);
+		ClockError error = compress(static_cast<const uint8_t *>(uncompressed), length, out);
+		compressedLength = out.size();
+		return error;
+	}
+
+	ClockError HuffmanFixed::decompress(const void * compressed, size_t length, void * decompressed, size_t capacity, size_t & decompressedLength) {
+		OutputBuffer out(decompressed, capacity);
+		ClockError error = decompress(static_cast<const uint8_t *>(compressed), length, out);
+		decompressedLength = out.size();
+		return error;
+	}
+
+	ClockError HuffmanFixed::compress(const uint8_t * data, size_t length, OutputBuffer & out) {
+		if (length > std::numeric_limits<len_t>::max()) {
 			// string is too long
 			return ClockError::INVALID_ARGUMENT;
 		}
-		try {
-			compressed = std::string(sizeof(len_t), 0x0);
-		} catch (std::bad_alloc &) {
+		std::vector<len_t> histogram;
+		calcHistogram(data, length, histogram);
+
+		// length and the bit sequence with at least one byte padding
+		const size_t size = sizeof(len_t) + size_t(countBits(histogram, codes()) / 8) + 1;
+		char * compressed = out.allocate(size);
+		if (!compressed) {
 			return ClockError::OUT_OF_MEMORY;
 		}
 
-		len_t len = len_t(uncompressed.length());
+		len_t len = len_t(length);
 		for (size_t i = 0; i < sizeof(len_t); i++) {
-			compressed[i] = uint8_t((len >> (8 * (sizeof(len_t) - 1 - i))) & 0xFF);
+			compressed[i] = char(uint8_t((len >> (8 * (sizeof(len_t) - 1 - i))) & 0xFF));
 		}
 
-		convert(uncompressed, sizeof(len_t) * 8, compressed);
+		compressed[size - 1] = 0x0;
+		encode(data, length, codes(), compressed + sizeof(len_t));
 
 		return ClockError::SUCCESS;
 	}
 
-	ClockError HuffmanFixed::decompress(const std::string & compressed, std::string & decompressed) {
-		if (compressed.length() < sizeof(len_t)) {
+	ClockError HuffmanFixed::decompress(const uint8_t * data, size_t length, OutputBuffer & out) {
+		if (length < sizeof(len_t)) {
 			return ClockError::INVALID_ARGUMENT;
 		}
-		std::string realText(compressed.begin() + sizeof(len_t), compressed.end());
-
 		len_t len = 0;
 		for (size_t i = 0; i < sizeof(len_t); i++) {
 			len *= 0x100; // * 256
-			len += uint8_t(compressed[i]);
+			len += data[i];
 		}
 
-		try {
-			decompressed = std::string(len, 0x0);
-		} catch (std::bad_alloc &) {
+		char * decompressed = out.allocate(len);
+		if (!decompressed) {
 			return ClockError::OUT_OF_MEMORY;
 		}
 
-		return getChar(realText, root, len, decompressed);
+		return decode(data + sizeof(len_t), length - sizeof(len_t), decodeTable(), len, decompressed);
 	}
 
-	void HuffmanFixed::convert(const std::string & text, size_t index, std::string & result) {
-		if (mappings[0].size() == 0) {
-			std::vector<bool> vec;
-			generateMapping(root, vec, mappings);
-		}
-		for (uint8_t c : text) {
-			size_t len = mappings[c].size();
-
-			while ((index + len) / 8 + 1 > result.size()) { // FIXME if index + len % 8 == 0 -> has 1 byte too much
-				result += char(uint8_t(0x0));
-			}
+	const HuffmanBase::Tree & HuffmanFixed::tree() {
+		static const Tree fixedTree = []() {
+			Tree t;
+			buildTree(preVec, t);
+			return t;
+		}();
+		return fixedTree;
+	}
 
-			for (size_t i = 0; i < len; i++) {
-				result[(index + i) / 8] |= mappings[c][i] ? (1 << (7 - (index + i) % 8)) : 0;
-			}
+	const std::vector<HuffmanBase::Code> & HuffmanFixed::codes() {
+		static const std::vector<Code> table = []() {
+			std::vector<Code> c(256, Code { 0, 0 });
+			generateCodes(tree(), c);
+			return c;
+		}();
+		return table;
+	}
 
-			index += len;
-		}
+	const HuffmanBase::DecodeTable & HuffmanFixed::decodeTable() {
+		static const DecodeTable table = []() {
+			DecodeTable t;
+			ClockError error = buildDecodeTable(tree(), t);
+			assert(error == ClockError::SUCCESS);
+			(void) error;
+			return t;
+		}();
+		return table;
 	}
 
 } /* namespace algorithm */
@@ -19,6 +19,7 @@
 
 #include "clockUtils/compression/algorithm/HuffmanGeneric.h"
 
+#include <algorithm>
 #include <limits>
 
 #include "clockUtils/errors.h"
@@ -28,88 +29,115 @@ namespace compression {
 namespace algorithm {
 
 	ClockError HuffmanGeneric::compress(const std::string & uncompressed, std::string & compressed) {
-		if (uncompressed.length() > std::numeric_limits<len_t>::max()) {
+		OutputBuffer out(compressed);
+		return compress(reinterpret_cast<const uint8_t *>(uncompressed.data()), uncompressed.length(), out);
+	}
+
+	ClockError HuffmanGeneric::decompress(const std::string & compressed, std::string & decompressed) {
+		OutputBuffer out(decompressed);
+		return decompress(reinterpret_cast<const uint8_t *>(compressed.data()), compressed.length(), out);
+	}
+
+	ClockError HuffmanGeneric::compress(const void * uncompressed, size_t length, void * compressed, size_t capacity, size_t & compressedLength) {
+		OutputBuffer out(compressed, capacity);
+		ClockError error = compress(static_cast<const uint8_t *>(uncompressed), length, out);
+		compressedLength = out.size();
+		return error;
+	}
+
+	ClockError HuffmanGeneric::decompress(const void * compressed, size_t length, void * decompressed, size_t capacity, size_t & decompressedLength) {
+		OutputBuffer out(decompressed, capacity);
+		ClockError error = decompress(static_cast<const uint8_t *>(compressed), length, out);
+		decompressedLength = out.size();
+		return error;
+	}
+
+	size_t HuffmanGeneric::maxCompressedSize(size_t length) {
+		// a Huffman code of length l needs a total frequency of at least fib(l + 2), so the codes of 256 frequencies up to 255 are shorter than 24 bits
+		return 256 + sizeof(len_t) + length * 3 + 1;
+	}
+
+	ClockError HuffmanGeneric::compress(const uint8_t * data, size_t length, OutputBuffer & out) {
+		if (length > std::numeric_limits<len_t>::max()) {
 			// string is too long
 			return ClockError::INVALID_ARGUMENT;
 		}
-		std::vector<uint8_t> header = calcFrequencies(uncompressed);
-
-		compressed = std::string(header.begin(), header.end());
+		std::vector<len_t> histogram;
+		calcHistogram(data, length, histogram);
+		std::vector<uint8_t> header = calcFrequencies(histogram);
+
+		Tree tree;
+		buildTree(header, tree);
+		std::vector<Code> codes(256, Code { 0, 0 });
+		generateCodes(tree, codes);
+
+		// header, length and the bit sequence with at least one byte padding
+		const size_t headerSize = 256 + sizeof(len_t);
+		const size_t size = headerSize + size_t(countBits(histogram, codes) / 8) + 1;
+		char * compressed = out.allocate(size);
+		if (!compressed) {
+			return ClockError::OUT_OF_MEMORY;
+		}
+		std::copy(header.begin(), header.end(), compressed);
 
-		len_t len = len_t(uncompressed.length());
+		len_t len = len_t(length);
 		for (size_t i = 0; i < sizeof(len_t); i++) {
-			compressed += uint8_t((len >> (8 * (sizeof(len_t) - 1 - i))) & 0xFF);
+			compressed[256 + i] = char(uint8_t((len >> (8 * (sizeof(len_t) - 1 - i))) & 0xFF));
 		}
 
-		std::shared_ptr<Node> root = buildTree(header);
-
-		convert(uncompressed, root, (256 + sizeof(len_t)) * 8, compressed);
+		compressed[size - 1] = 0x0;
+		encode(data, length, codes, compressed + headerSize);
 
 		return ClockError::SUCCESS;
 	}
 
-	ClockError HuffmanGeneric::decompress(const std::string & compressed, std::string & decompressed) {
-		if (compressed.length() < (256 + sizeof(len_t))) { // length of the header
+	ClockError HuffmanGeneric::decompress(const uint8_t * data, size_t length, OutputBuffer & out) {
+		if (length < (256 + sizeof(len_t))) { // length of the header
 			return ClockError::INVALID_ARGUMENT;
 		}
-		std::vector<uint8_t> header(compressed.begin(), compressed.begin() + 256);
+		std::vector<uint8_t> header(data, data + 256);
 
-		std::shared_ptr<Node> root = buildTree(header);
+		Tree tree;
+		buildTree(header, tree);
 
-		std::string realText(compressed.begin() + (256 + sizeof(len_t)), compressed.end());
+		DecodeTable table;
+		ClockError error = buildDecodeTable(tree, table);
+		if (error != ClockError::SUCCESS) {
+			return error;
+		}
 
 		len_t len = 0;
 		for (size_t i = 0; i < sizeof(len_t); i++) {
 			len *= 0x100; // * 256
-			len += uint8_t(compressed[256 + i]);
+			len += data[256 + i];
 		}
 
-		try {
-			decompressed = std::string(len, 0x0);
-		} catch (std::bad_alloc &) {
+		char * decompressed = out.allocate(len);
+		if (!decompressed) {
 			return ClockError::OUT_OF_MEMORY;
 		}
 
-		return getChar(realText, root, len, decompressed);
-	}
-
-	void HuffmanGeneric::convert(const std::string & text, const std::shared_ptr<Node> & root, size_t index, std::string & result) {
-		std::vector<std::vector<bool>> mappings(256);
-		generateMapping(root, std::vector<bool>(), mappings);
-
-		for (uint8_t c : text) {
-			size_t len = mappings[c].size();
-
-			while ((index + len) / 8 + 1 > result.size()) {
-				result += char(uint8_t(0x0));
-			}
-
-			for (size_t i = 0; i < len; i++) {
-				result[(index + i) / 8] |= mappings[c][i] ? (1 << (7 - (index + i) % 8)) : 0;
-			}
-
-			index += len;
-		}
+		return decode(data + 256 + sizeof(len_t), length - 256 - sizeof(len_t), table, len, decompressed);
 	}
 
-	std::vector<uint8_t> HuffmanGeneric::calcFrequencies(const std::string & text) {
-		std::vector<len_t> header(256, 0);
-
+	std::vector<uint8_t> HuffmanGeneric::calcFrequencies(const std::vector<len_t> & histogram) {
 		len_t max = 0;
 
-		for (uint8_t c : text) {
-			header[c]++;
-
-			if (header[c] > max) {
-				max = header[c];
+		for (len_t count : histogram) {
+			if (count > max) {
+				max = count;
 			}
 		}
 
 		std::vector<uint8_t> charHeader(256, 0);
+		if (max == 0) {
+			// empty string
+			return charHeader;
+		}
 
 		for (size_t i = 0; i < 256; ++i) {
-			charHeader[i] = uint8_t(header[i] / double(max) * 255.0);
-			if (header[i] > 0 && charHeader[i] == 0) {
+			charHeader[i] = uint8_t(histogram[i] / double(max) * 255.0);
+			if (histogram[i] > 0 && charHeader[i] == 0) {
 				charHeader[i] = 1;
 			}
 		}
@@ -0,0 +1,124 @@
+/*
+ * clockUtils
+ * Copyright (2015) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "clockUtils/compression/algorithm/HuffmanInterleaved.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "clockUtils/errors.h"
+
+namespace clockUtils {
+namespace compression {
+namespace algorithm {
+
+	ClockError HuffmanInterleaved::compress(const std::string & uncompressed, std::string & compressed) {
+		OutputBuffer out(compressed);
+		return compress(reinterpret_cast<const uint8_t *>(uncompressed.data()), uncompressed.length(), out);
+	}
+
+	ClockError HuffmanInterleaved::decompress(const std::string & compressed, std::string & decompressed) {
+		OutputBuffer out(decompressed);
+		return decompress(reinterpret_cast<const uint8_t *>(compressed.data()), compressed.length(), out);
+	}
+
+	ClockError HuffmanInterleaved::compress(const void * uncompressed, size_t length, void * compressed, size_t capacity, size_t & compressedLength) {
+		OutputBuffer out(compressed, capacity);
+		ClockError error = compress(static_cast<const uint8_t *>(uncompressed), length, out);
+		compressedLength = out.size();
+		return error;
+	}
+
+	ClockError HuffmanInterleaved::decompress(const void * compressed, size_t length, void * decompressed, size_t capacity, size_t & decompressedLength) {
+		OutputBuffer out(decompressed, capacity);
+		ClockError error = decompress(static_cast<const uint8_t *>(compressed), length, out);
+		decompressedLength = out.size();
+		return error;
+	}
+
+	size_t HuffmanInterleaved::maxCompressedSize(size_t length) {
+		// like HuffmanGeneric with the jump table and a padding byte for every bit sequence
+		return HuffmanGeneric::maxCompressedSize(length) + 4 * (STREAMS - 1) + STREAMS - 1;
+	}
+
+	ClockError HuffmanInterleaved::compress(const uint8_t * data, size_t length, OutputBuffer & out) {
+		if (length > std::numeric_limits<len_t>::max()) {
+			// string is too long
+			return ClockError::INVALID_ARGUMENT;
+		}
+		std::vector<len_t> histogram;
+		calcHistogram(data, length, histogram);
+		std::vector<uint8_t> header = calcFrequencies(histogram);
+
+		Tree tree;
+		buildTree(header, tree);
+		std::vector<Code> codes(256, Code { 0, 0 });
+		generateCodes(tree, codes);
+
+		// header, length, jump table and the bit sequences
+		const size_t headerSize = 256 + sizeof(len_t);
+		size_t sizes[STREAMS];
+		char * compressed = out.allocate(headerSize + interleavedSize(data, length, codes, sizes));
+		if (!compressed) {
+			return ClockError::OUT_OF_MEMORY;
+		}
+		std::copy(header.begin(), header.end(), compressed);
+
+		len_t len = len_t(length);
+		for (size_t i = 0; i < sizeof(len_t); i++) {
+			compressed[256 + i] = char(uint8_t((len >> (8 * (sizeof(len_t) - 1 - i))) & 0xFF));
+		}
+
+		encodeInterleaved(data, length, codes, sizes, compressed + headerSize);
+
+		return ClockError::SUCCESS;
+	}
+
+	ClockError HuffmanInterleaved::decompress(const uint8_t * data, size_t length, OutputBuffer & out) {
+		if (length < (256 + sizeof(len_t))) { // length of the header
+			return ClockError::INVALID_ARGUMENT;
+		}
+		std::vector<uint8_t> header(data, data + 256);
+
+		Tree tree;
+		buildTree(header, tree);
+
+		DecodeTable table;
+		ClockError error = buildDecodeTable(tree, table);
+		if (error != ClockError::SUCCESS) {
+			return error;
+		}
+
+		len_t len = 0;
+		for (size_t i = 0; i < sizeof(len_t); i++) {
+			len *= 0x100; // * 256
+			len += data[256 + i];
+		}
+
+		char * decompressed = out.allocate(len);
+		if (!decompressed) {
+			return ClockError::OUT_OF_MEMORY;
+		}
+
+		return decodeInterleaved(data + 256 + sizeof(len_t), length - 256 - sizeof(len_t), table, len, decompressed);
+	}
+
+} /* namespace algorithm */
+} /* namespace compression */
+} /* namespace clockUtils */
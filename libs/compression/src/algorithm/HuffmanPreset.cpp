@@ -0,0 +1,318 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "clockUtils/compression/algorithm/HuffmanPreset.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#include "clockUtils/errors.h"
+
+namespace clockUtils {
+namespace compression {
+namespace algorithm {
+
+	namespace {
+
+		/**
+		 * \brief maximum length of a code in bits, bytes that are rare in a preset get codes of this length
+		 */
+		const uint8_t MAX_CODE_LENGTH = 11;
+
+		/**
+		 * \brief relative frequencies of english text, letters and space are the most frequent bytes
+		 * these are the frequencies of the dictionary of HuffmanFixed, so english text is encoded as well as with HuffmanFixed
+		 */
+		const uint8_t ENGLISH_FREQUENCIES[256] = {
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			7, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 255, 1, 1, 1, 1, 1, 1, 3,
+			4, 4, 1, 1, 10, 2, 10, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 2, 1, 1, 1, 1,
+			1, 1, 2, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 3, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 74, 24, 30,
+			40, 179, 24, 23, 67, 95, 1, 3, 50, 33,
+			94, 88, 20, 8, 66, 69, 111, 33, 7, 21,
+			2, 21, 2, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1
+		
+		};
+
+		/**
+		 * \brief relative frequencies of JSON and XML, besides the text there are a lot of spaces for indentation, quotes and brackets
+		 */
+		const uint8_t MARKUP_FREQUENCIES[256] = {
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			25, 1, 1, 22, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 255, 1, 51, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 10, 4, 45, 12, 8, 7,
+			6, 4, 5, 4, 3, 2, 1, 1, 17, 1,
+			10, 5, 10, 1, 1, 6, 2, 8, 2, 3,
+			2, 2, 3, 3, 1, 1, 2, 10, 5, 2,
+			4, 1, 4, 7, 6, 1, 2, 1, 1, 1,
+			1, 1, 1, 1, 1, 2, 1, 43, 9, 26,
+			17, 87, 13, 9, 14, 38, 2, 4, 23, 30,
+			37, 45, 20, 1, 50, 48, 59, 18, 7, 4,
+			4, 13, 2, 4, 1, 4, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1
+		};
+
+		/**
+		 * \brief relative frequencies of executables and other binary data, 0x00 and 0xFF are frequent, the other bytes are almost uniform
+		 */
+		const uint8_t BINARY_FREQUENCIES[256] = {
+			255, 22, 9, 7, 8, 7, 4, 4, 14, 3,
+			4, 3, 2, 2, 15, 26, 14, 3, 2, 1,
+			2, 4, 1, 1, 7, 1, 1, 1, 1, 1,
+			1, 6, 21, 1, 1, 1, 32, 2, 1, 1,
+			6, 4, 1, 1, 2, 3, 3, 1, 6, 5,
+			1, 1, 1, 2, 1, 1, 4, 5, 1, 2,
+			2, 2, 1, 1, 6, 15, 7, 3, 12, 5,
+			2, 2, 70, 12, 1, 1, 16, 4, 1, 1,
+			4, 1, 1, 3, 4, 3, 2, 2, 2, 1,
+			1, 2, 3, 2, 2, 4, 3, 5, 2, 4,
+			4, 8, 7, 2, 4, 5, 1, 1, 5, 3,
+			5, 6, 6, 1, 5, 6, 14, 6, 2, 2,
+			2, 1, 1, 1, 4, 1, 1, 2, 5, 2,
+			1, 11, 13, 11, 2, 1, 3, 33, 1, 25,
+			3, 16, 2, 1, 3, 1, 1, 1, 2, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			2, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 2, 1, 1, 1,
+			2, 1, 2, 1, 2, 1, 3, 1, 3, 1,
+			2, 1, 8, 3, 2, 5, 2, 2, 4, 6,
+			2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+			2, 1, 1, 1, 1, 1, 2, 1, 1, 2,
+			1, 1, 1, 3, 2, 1, 1, 1, 1, 1,
+			1, 2, 14, 7, 1, 4, 2, 2, 2, 3,
+			3, 1, 1, 2, 1, 1, 3, 3, 3, 1,
+			2, 2, 2, 3, 5, 52
+		};
+
+		/**
+		 * \brief relative frequencies of numbers in ASCII separated by commas, semicolons, spaces, tabs or new lines
+		 */
+		const uint8_t NUMERIC_FREQUENCIES[256] = {
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 65,
+			93, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 65, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 40, 130, 100, 200, 1, 220, 220,
+			220, 220, 220, 220, 220, 220, 220, 220, 1, 65,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 20,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 42, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1
+		};
+
+		/**
+		 * \brief frequencies of all presets except STORED in the order of their ids
+		 */
+		const uint8_t * const FREQUENCIES[] = { ENGLISH_FREQUENCIES, MARKUP_FREQUENCIES, BINARY_FREQUENCIES, NUMERIC_FREQUENCIES };
+
+	} /* namespace */
+
+	ClockError HuffmanPreset::compress(const std::string & uncompressed, std::string & compressed) {
+		OutputBuffer out(compressed);
+		return compress(reinterpret_cast<const uint8_t *>(uncompressed.data()), uncompressed.length(), out);
+	}
+
+	ClockError HuffmanPreset::decompress(const std::string & compressed, std::string & decompressed) {
+		OutputBuffer out(decompressed);
+		return decompress(reinterpret_cast<const uint8_t *>(compressed.data()), compressed.length(), out);
+	}
+
+	ClockError HuffmanPreset::compress(const void * uncompressed, size_t length, void * compressed, size_t capacity, size_t & compressedLength) {
+		OutputBuffer out(compressed, capacity);
+		ClockError error = compress(static_cast<const uint8_t *>(uncompressed), length, out);
+		compressedLength = out.size();
+		return error;
+	}
+
+	ClockError HuffmanPreset::decompress(const void * compressed, size_t length, void * decompressed, size_t capacity, size_t & decompressedLength) {
+		OutputBuffer out(decompressed, capacity);
+		ClockError error = decompress(static_cast<const uint8_t *>(compressed), length, out);
+		decompressedLength = out.size();
+		return error;
+	}
+
+	size_t HuffmanPreset::maxCompressedSize(size_t length) {
+		// a preset is only used if the result is shorter than the stored string
+		return 1 + length;
+	}
+
+	ClockError HuffmanPreset::compress(const uint8_t * data, size_t length, OutputBuffer & out) {
+		if (length > std::numeric_limits<len_t>::max()) {
+			// string is too long
+			return ClockError::INVALID_ARGUMENT;
+		}
+		// id of the preset and length
+		const size_t headerSize = 1 + sizeof(len_t);
+		std::vector<len_t> histogram;
+		calcHistogram(data, length, histogram);
+
+		// choose the preset resulting in the shortest string, storing the string costs only the id
+		Preset preset = Preset::STORED;
+		size_t size = 1 + length;
+		for (uint8_t id = 1; id < uint8_t(Preset::COUNT); id++) {
+			// bit sequence with at least one byte padding
+			const uint64_t presetSize = headerSize + countBits(histogram, codes()[id - 1]) / 8 + 1;
+			if (presetSize < size) {
+				preset = Preset(id);
+				size = size_t(presetSize);
+			}
+		}
+
+		char * compressed = out.allocate(size);
+		if (!compressed) {
+			return ClockError::OUT_OF_MEMORY;
+		}
+		compressed[0] = char(preset);
+
+		if (preset == Preset::STORED) {
+			std::copy(data, data + length, compressed + 1);
+			return ClockError::SUCCESS;
+		}
+
+		len_t len = len_t(length);
+		for (size_t i = 0; i < sizeof(len_t); i++) {
+			compressed[1 + i] = char(uint8_t((len >> (8 * (sizeof(len_t) - 1 - i))) & 0xFF));
+		}
+
+		compressed[size - 1] = 0x0;
+		encode(data, length, codes()[uint8_t(preset) - 1], compressed + headerSize);
+
+		return ClockError::SUCCESS;
+	}
+
+	ClockError HuffmanPreset::decompress(const uint8_t * data, size_t length, OutputBuffer & out) {
+		if (length == 0 || data[0] >= uint8_t(Preset::COUNT)) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+		const uint8_t id = data[0];
+		if (id == uint8_t(Preset::STORED)) {
+			char * decompressed = out.allocate(length - 1);
+			if (!decompressed) {
+				return ClockError::OUT_OF_MEMORY;
+			}
+			std::copy(data + 1, data + length, decompressed);
+			return ClockError::SUCCESS;
+		}
+
+		const size_t headerSize = 1 + sizeof(len_t);
+		if (length < headerSize) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+		len_t len = 0;
+		for (size_t i = 0; i < sizeof(len_t); i++) {
+			len *= 0x100; // * 256
+			len += data[1 + i];
+		}
+		// every byte needs at least one bit
+		if (len / 8 > length) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+
+		char * decompressed = out.allocate(len);
+		if (!decompressed) {
+			return ClockError::OUT_OF_MEMORY;
+		}
+
+		return decode(data + headerSize, length - headerSize, decodeTables()[id - 1], len, decompressed);
+	}
+
+	const std::vector<std::vector<HuffmanBase::Code>> & HuffmanPreset::codes() {
+		static const std::vector<std::vector<Code>> presetCodes = []() {
+			std::vector<std::vector<Code>> result;
+			for (const uint8_t * frequencies : FREQUENCIES) {
+				std::vector<len_t> histogram(frequencies, frequencies + 256);
+				std::vector<uint8_t> lengths;
+				buildLengths(histogram, MAX_CODE_LENGTH, lengths);
+				std::vector<Code> c;
+				buildCanonicalCodes(lengths, c);
+				result.push_back(c);
+			}
+			return result;
+		}();
+		return presetCodes;
+	}
+
+	const std::vector<HuffmanBase::DecodeTable> & HuffmanPreset::decodeTables() {
+		static const std::vector<DecodeTable> tables = []() {
+			std::vector<DecodeTable> result;
+			for (const std::vector<Code> & c : codes()) {
+				DecodeTable t;
+				ClockError error = buildDecodeTable(c, t);
+				assert(error == ClockError::SUCCESS);
+				(void) error;
+				result.push_back(t);
+			}
+			return result;
+		}();
+		return tables;
+	}
+
+} /* namespace algorithm */
+} /* namespace compression */
+} /* namespace clockUtils */
@@ -0,0 +1,121 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "clockUtils/compression/algorithm/HuffmanTable.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#include "clockUtils/errors.h"
+
+namespace clockUtils {
+namespace compression {
+namespace algorithm {
+
+	HuffmanTable::HuffmanTable() : _histogram(256, 0), _lengths(256, 8), _codes(), _decodeTable() {
+		buildCanonicalCodes(_lengths, _codes);
+		ClockError error = buildDecodeTable(_codes, _decodeTable);
+		assert(error == ClockError::SUCCESS);
+		(void) error;
+	}
+
+	void HuffmanTable::addSample(const std::string & sample) {
+		std::vector<len_t> histogram;
+		calcHistogram(sample, histogram);
+		for (size_t i = 0; i < 256; i++) {
+			_histogram[i] += histogram[i];
+		}
+	}
+
+	void HuffmanTable::train() {
+		uint64_t max = 0;
+		for (uint64_t count : _histogram) {
+			max = std::max(max, count);
+		}
+		// the counts are scaled down to fit into len_t, every byte gets a count of at least 1 so it also gets a code
+		uint32_t shift = 0;
+		while ((max >> shift) >= std::numeric_limits<len_t>::max() / 2) {
+			shift++;
+		}
+		std::vector<len_t> histogram(256);
+		for (size_t i = 0; i < 256; i++) {
+			histogram[i] = len_t(_histogram[i] >> shift) + 1;
+		}
+		buildLengths(histogram, MAX_CODE_LENGTH, _lengths);
+		buildCanonicalCodes(_lengths, _codes);
+		ClockError error = buildDecodeTable(_codes, _decodeTable);
+		assert(error == ClockError::SUCCESS);
+		(void) error;
+	}
+
+	uint64_t HuffmanTable::sampleSize() const {
+		uint64_t size = 0;
+		for (uint64_t count : _histogram) {
+			size += count;
+		}
+		return size;
+	}
+
+	uint64_t HuffmanTable::encodedSampleSize() const {
+		uint64_t bits = 0;
+		for (size_t i = 0; i < 256; i++) {
+			bits += _histogram[i] * _lengths[i];
+		}
+		return bits;
+	}
+
+	std::string HuffmanTable::serialize() const {
+		std::string result;
+		writeLengths(_lengths, result);
+		return result;
+	}
+
+	ClockError HuffmanTable::deserialize(const std::string & serialized) {
+		size_t pos = 0;
+		std::vector<uint8_t> lengths;
+		ClockError error = readLengths(reinterpret_cast<const uint8_t *>(serialized.data()), serialized.length(), pos, 256, lengths);
+		if (error != ClockError::SUCCESS) {
+			return error;
+		}
+		if (pos != serialized.length()) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+		for (uint8_t length : lengths) {
+			// every byte needs a code
+			if (length == 0 || length > MAX_CODE_LENGTH) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+		}
+		std::vector<Code> codes;
+		buildCanonicalCodes(lengths, codes);
+		DecodeTable decodeTable;
+		error = buildDecodeTable(codes, decodeTable);
+		if (error != ClockError::SUCCESS) {
+			return error;
+		}
+		_lengths = lengths;
+		_codes = codes;
+		_decodeTable = decodeTable;
+		return ClockError::SUCCESS;
+	}
+
+} /* namespace algorithm */
+} /* namespace compression */
+} /* namespace clockUtils */
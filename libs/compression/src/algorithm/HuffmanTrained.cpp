@@ -0,0 +1,108 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "clockUtils/compression/algorithm/HuffmanTrained.h"
+
+#include <limits>
+
+#include "clockUtils/errors.h"
+
+namespace clockUtils {
+namespace compression {
+namespace algorithm {
+
+	ClockError HuffmanTrained::compress(const std::string & uncompressed, std::string & compressed, const HuffmanTable & table) {
+		OutputBuffer out(compressed);
+		return compress(reinterpret_cast<const uint8_t *>(uncompressed.data()), uncompressed.length(), out, table);
+	}
+
+	ClockError HuffmanTrained::decompress(const std::string & compressed, std::string & decompressed, const HuffmanTable & table) {
+		OutputBuffer out(decompressed);
+		return decompress(reinterpret_cast<const uint8_t *>(compressed.data()), compressed.length(), out, table);
+	}
+
+	ClockError HuffmanTrained::compress(const void * uncompressed, size_t length, void * compressed, size_t capacity, size_t & compressedLength, const HuffmanTable & table) {
+		OutputBuffer out(compressed, capacity);
+		ClockError error = compress(static_cast<const uint8_t *>(uncompressed), length, out, table);
+		compressedLength = out.size();
+		return error;
+	}
+
+	ClockError HuffmanTrained::decompress(const void * compressed, size_t length, void * decompressed, size_t capacity, size_t & decompressedLength, const HuffmanTable & table) {
+		OutputBuffer out(decompressed, capacity);
+		ClockError error = decompress(static_cast<const uint8_t *>(compressed), length, out, table);
+		decompressedLength = out.size();
+		return error;
+	}
+
+	size_t HuffmanTrained::maxCompressedSize(size_t length) {
+		return sizeof(len_t) + length / 8 * HuffmanTable::MAX_CODE_LENGTH + (length % 8 * HuffmanTable::MAX_CODE_LENGTH) / 8 + 1;
+	}
+
+	ClockError HuffmanTrained::compress(const uint8_t * data, size_t length, OutputBuffer & out, const HuffmanTable & table) {
+		if (length > std::numeric_limits<len_t>::max()) {
+			// string is too long
+			return ClockError::INVALID_ARGUMENT;
+		}
+		std::vector<len_t> histogram;
+		calcHistogram(data, length, histogram);
+
+		// length and the bit sequence with at least one byte padding
+		const size_t size = sizeof(len_t) + size_t(countBits(histogram, table._codes) / 8) + 1;
+		char * compressed = out.allocate(size);
+		if (!compressed) {
+			return ClockError::OUT_OF_MEMORY;
+		}
+
+		len_t len = len_t(length);
+		for (size_t i = 0; i < sizeof(len_t); i++) {
+			compressed[i] = char(uint8_t((len >> (8 * (sizeof(len_t) - 1 - i))) & 0xFF));
+		}
+
+		compressed[size - 1] = 0x0;
+		encode(data, length, table._codes, compressed + sizeof(len_t));
+
+		return ClockError::SUCCESS;
+	}
+
+	ClockError HuffmanTrained::decompress(const uint8_t * data, size_t length, OutputBuffer & out, const HuffmanTable & table) {
+		if (length < sizeof(len_t)) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+		len_t len = 0;
+		for (size_t i = 0; i < sizeof(len_t); i++) {
+			len *= 0x100; // * 256
+			len += data[i];
+		}
+		// every byte needs at least one bit
+		if (len / 8 > length) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+
+		char * decompressed = out.allocate(len);
+		if (!decompressed) {
+			return ClockError::OUT_OF_MEMORY;
+		}
+
+		return decode(data + sizeof(len_t), length - sizeof(len_t), table._decodeTable, len, decompressed);
+	}
+
+} /* namespace algorithm */
+} /* namespace compression */
+} /* namespace clockUtils */
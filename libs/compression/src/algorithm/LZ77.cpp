@@ -0,0 +1,342 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "clockUtils/compression/algorithm/LZ77.h"
+
+#include <limits>
+
+#include "clockUtils/errors.h"
+
+namespace clockUtils {
+namespace compression {
+namespace algorithm {
+
+	namespace {
+
+		/**
+		 * \brief the last match has to start at least MATCH_START_LIMIT bytes before the end
+		 */
+		const size_t MATCH_START_LIMIT = 12;
+
+		/**
+		 * \brief the last LAST_LITERALS bytes are always stored as literals
+		 */
+		const size_t LAST_LITERALS = 5;
+
+		/**
+		 * \brief maximum distance of a match, has to fit into 2 bytes
+		 */
+		const uint32_t WINDOW = 65535;
+
+		/**
+		 * \brief amount of previous occurrences that are tested for every position
+		 */
+		const uint32_t ATTEMPTS = 8;
+
+		/**
+		 * \brief matches of this length are taken without searching for a longer one
+		 */
+		const uint32_t NICE_LENGTH = 64;
+
+		/**
+		 * \brief after 2^SKIP_TRIGGER positions without match the search starts to skip positions to get over incompressible data faster
+		 */
+		const uint32_t SKIP_TRIGGER = 6;
+
+		/**
+		 * \brief value of a length nibble telling that further length bytes follow
+		 */
+		const size_t RUN_MASK = 15;
+
+		/**
+		 * \brief space behind the decompressed string the copy loops are allowed to overwrite
+		 */
+		const size_t COPY_MARGIN = 32;
+
+		uint8_t * writeLength(uint8_t * out, size_t length) {
+			while (length >= 255) {
+				*out++ = 255;
+				length -= 255;
+			}
+			*out++ = uint8_t(length);
+			return out;
+		}
+
+		uint8_t * writeSequence(uint8_t * out, const uint8_t * literals, size_t literalLength, uint32_t distance, size_t matchLength) {
+			uint8_t * token = out++;
+			if (literalLength >= RUN_MASK) {
+				*token = uint8_t(RUN_MASK << 4);
+				out = writeLength(out, literalLength - RUN_MASK);
+			} else {
+				*token = uint8_t(literalLength << 4);
+			}
+			memcpy(out, literals, literalLength);
+			out += literalLength;
+			if (matchLength == 0) {
+				// last sequence
+				return out;
+			}
+			*out++ = uint8_t(distance);
+			*out++ = uint8_t(distance >> 8);
+			matchLength -= 4;
+			if (matchLength >= RUN_MASK) {
+				*token |= uint8_t(RUN_MASK);
+				out = writeLength(out, matchLength - RUN_MASK);
+			} else {
+				*token |= uint8_t(matchLength);
+			}
+			return out;
+		}
+
+		/**
+		 * \brief reads the additional bytes of a length, returns false if the data ends or length exceeds limit
+		 */
+		bool readLength(const uint8_t *& in, const uint8_t * end, size_t limit, size_t & length) {
+			uint8_t value;
+			do {
+				if (in >= end) {
+					return false;
+				}
+				value = *in++;
+				length += value;
+				if (length > limit) {
+					return false;
+				}
+			} while (value == 255);
+			return true;
+		}
+
+		/**
+		 * \brief copies at least length bytes in blocks of 16 bytes, source and destination must not overlap
+		 */
+		inline void wildCopy16(uint8_t * out, const uint8_t * in, size_t length) {
+			uint8_t * const end = out + length;
+			do {
+				memcpy(out, in, 16);
+				out += 16;
+				in += 16;
+			} while (out < end);
+		}
+
+		/**
+		 * \brief copies a match of length bytes starting distance bytes before out, writes up to 15 bytes behind the match
+		 * the match can overlap with itself if it is longer than the distance, this repeats the last distance bytes
+		 */
+		inline void copyMatch(uint8_t * out, size_t distance, size_t length) {
+			uint8_t * const end = out + length;
+			const uint8_t * match = out - distance;
+			if (distance < 8) {
+				// copy the first 8 bytes one after another and move the source back afterwards, so the distance is at least 8 for the rest of the match
+				static const uint8_t INCREMENT[8] = { 0, 1, 2, 1, 0, 4, 4, 4 };
+				static const int8_t DECREMENT[8] = { 0, 0, 0, -1, -4, 1, 2, 3 };
+				out[0] = match[0];
+				out[1] = match[1];
+				out[2] = match[2];
+				out[3] = match[3];
+				match += INCREMENT[distance];
+				memcpy(out + 4, match, 4);
+				match -= DECREMENT[distance];
+				out += 8;
+			} else if (distance >= 16) {
+				do {
+					memcpy(out, match, 16);
+					out += 16;
+					match += 16;
+				} while (out < end);
+				return;
+			}
+			while (out < end) {
+				memcpy(out, match, 8);
+				out += 8;
+				match += 8;
+			}
+		}
+
+	} /* namespace */
+
+	ClockError LZ77::compress(const std::string & uncompressed, std::string & compressed) {
+		OutputBuffer output(compressed);
+		return compress(reinterpret_cast<const uint8_t *>(uncompressed.data()), uncompressed.length(), output);
+	}
+
+	ClockError LZ77::decompress(const std::string & compressed, std::string & decompressed) {
+		OutputBuffer output(decompressed);
+		return decompress(reinterpret_cast<const uint8_t *>(compressed.data()), compressed.length(), output);
+	}
+
+	ClockError LZ77::compress(const void * uncompressed, size_t length, void * compressed, size_t capacity, size_t & compressedLength) {
+		OutputBuffer output(compressed, capacity);
+		ClockError error = compress(static_cast<const uint8_t *>(uncompressed), length, output);
+		compressedLength = output.size();
+		return error;
+	}
+
+	ClockError LZ77::decompress(const void * compressed, size_t length, void * decompressed, size_t capacity, size_t & decompressedLength) {
+		OutputBuffer output(decompressed, capacity);
+		ClockError error = decompress(static_cast<const uint8_t *>(compressed), length, output);
+		decompressedLength = output.size();
+		return error;
+	}
+
+	size_t LZ77::maxCompressedSize(size_t length) {
+		// worst case: everything is stored as literals
+		return sizeof(len_t) + length + length / 255 + 16;
+	}
+
+	ClockError LZ77::compress(const uint8_t * data, size_t length, OutputBuffer & output) {
+		if (length > std::numeric_limits<len_t>::max()) {
+			// string is too long
+			return ClockError::INVALID_ARGUMENT;
+		}
+		uint8_t * const begin = reinterpret_cast<uint8_t *>(output.allocate(maxCompressedSize(length)));
+		if (!begin) {
+			return ClockError::OUT_OF_MEMORY;
+		}
+		for (size_t i = 0; i < sizeof(len_t); i++) {
+			begin[i] = uint8_t(length >> (8 * (sizeof(len_t) - 1 - i)));
+		}
+		uint8_t * out = begin + sizeof(len_t);
+
+		size_t anchor = 0;
+		if (length > MATCH_START_LIMIT) {
+			try {
+				MatchFinder finder(data, length, WINDOW, ATTEMPTS, NICE_LENGTH);
+				const size_t matchLimit = length - LAST_LITERALS;
+				const size_t lastMatchStart = length - MATCH_START_LIMIT;
+				size_t pos = 0;
+				uint32_t misses = 0;
+				while (pos <= lastMatchStart) {
+					uint32_t distance = 0;
+					size_t matchLength = finder.find(pos, matchLimit, distance);
+					if (matchLength == 0) {
+						const size_t step = 1 + (misses++ >> SKIP_TRIGGER);
+						pos += step;
+						if (step > 1) {
+							finder.skip(pos);
+						}
+						continue;
+					}
+					// the match might start earlier than the hashed position
+					size_t matchPos = pos - distance;
+					while (pos > anchor && matchPos > 0 && data[pos - 1] == data[matchPos - 1]) {
+						pos--;
+						matchPos--;
+						matchLength++;
+					}
+					out = writeSequence(out, data + anchor, pos - anchor, distance, matchLength);
+					pos += matchLength;
+					anchor = pos;
+					misses = 0;
+				}
+			} catch (std::bad_alloc &) {
+				return ClockError::OUT_OF_MEMORY;
+			}
+		}
+		out = writeSequence(out, data + anchor, length - anchor, 0, 0);
+		output.resize(size_t(out - begin));
+
+		return ClockError::SUCCESS;
+	}
+
+	ClockError LZ77::decompress(const uint8_t * data, size_t length, OutputBuffer & output) {
+		if (length < sizeof(len_t) + 1) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+		len_t len = 0;
+		for (size_t i = 0; i < sizeof(len_t); i++) {
+			len *= 0x100; // * 256
+			len += data[i];
+		}
+		// every byte of the compressed string can produce at most 255 bytes
+		if (len / 255 > length) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+		uint8_t * const begin = reinterpret_cast<uint8_t *>(output.allocate(len, COPY_MARGIN));
+		if (!begin) {
+			return ClockError::OUT_OF_MEMORY;
+		}
+
+		const uint8_t * in = data + sizeof(len_t);
+		const uint8_t * const inEnd = data + length;
+		uint8_t * out = begin;
+		uint8_t * const end = begin + len;
+		// the copy loops may write behind end as long as they stay in the output
+		uint8_t * const limit = begin + output.capacity();
+
+		while (true) {
+			if (in >= inEnd) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			const uint8_t token = *in++;
+
+			size_t literalLength = token >> 4;
+			if (literalLength == RUN_MASK && !readLength(in, inEnd, size_t(end - out), literalLength)) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			if (literalLength > size_t(inEnd - in) || literalLength > size_t(end - out)) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			if (literalLength + 16 <= size_t(inEnd - in) && literalLength + 16 <= size_t(limit - out)) {
+				wildCopy16(out, in, literalLength);
+			} else {
+				memcpy(out, in, literalLength);
+			}
+			out += literalLength;
+			in += literalLength;
+			if (in == inEnd) {
+				// the last sequence contains only literals
+				break;
+			}
+
+			if (inEnd - in < 2) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			const size_t distance = size_t(in[0]) | (size_t(in[1]) << 8);
+			in += 2;
+			if (distance == 0 || distance > size_t(out - begin)) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			size_t matchLength = token & RUN_MASK;
+			if (matchLength == RUN_MASK && !readLength(in, inEnd, size_t(end - out), matchLength)) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			matchLength += MIN_MATCH;
+			if (matchLength > size_t(end - out)) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			if (matchLength + 16 <= size_t(limit - out)) {
+				copyMatch(out, distance, matchLength);
+			} else {
+				for (size_t i = 0; i < matchLength; i++) {
+					out[i] = out[i - distance];
+				}
+			}
+			out += matchLength;
+		}
+		if (out != end) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+		output.resize(len);
+
+		return ClockError::SUCCESS;
+	}
+
+} /* namespace algorithm */
+} /* namespace compression */
+} /* namespace clockUtils */
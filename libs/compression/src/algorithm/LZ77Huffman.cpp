@@ -0,0 +1,401 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "clockUtils/compression/algorithm/LZ77Huffman.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "clockUtils/errors.h"
+
+namespace clockUtils {
+namespace compression {
+namespace algorithm {
+
+	namespace {
+
+		/**
+		 * \brief maximum length of a code in bits
+		 */
+		const uint8_t MAX_CODE_LENGTH = 15;
+
+		/**
+		 * \brief longest match that can be encoded
+		 */
+		const size_t MAX_MATCH = 258;
+
+		/**
+		 * \brief the literal/length alphabet contains 256 literals followed by the length codes
+		 */
+		const size_t LENGTH_CODES = 29;
+		const size_t LITERAL_ALPHABET = 256 + LENGTH_CODES;
+		const size_t DISTANCE_ALPHABET = 32;
+
+		const uint16_t LENGTH_BASE[LENGTH_CODES] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+		const uint8_t LENGTH_EXTRA[LENGTH_CODES] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+
+		/**
+		 * \brief the most bits a length or distance symbol including its extra bits can have
+		 */
+		const uint32_t MAX_LENGTH_BITS = MAX_CODE_LENGTH + 5;
+		const uint32_t MAX_DISTANCE_BITS = MAX_CODE_LENGTH + 14;
+
+		/**
+		 * \brief search parameters of an effort level
+		 */
+		struct Level {
+			uint32_t attempts;
+			uint32_t niceLength;
+
+			/**
+			 * \brief a match shorter than this is only taken if the next position doesn't start a longer one, 0 disables lazy matching
+			 */
+			uint32_t lazyLength;
+		};
+
+		const Level LEVELS[] = {
+			{ 2, 8, 0 },
+			{ 4, 16, 0 },
+			{ 8, 32, 0 },
+			{ 8, 32, 8 },
+			{ 16, 64, 16 },
+			{ 32, 128, 32 },
+			{ 64, 128, 64 },
+			{ 256, 258, 128 },
+			{ 1024, 258, 258 }
+		};
+
+		/**
+		 * \brief literal run followed by a match, the last sequence has no match
+		 */
+		struct Sequence {
+			uint32_t literals;
+			uint32_t matchLength;
+			uint32_t distance;
+		};
+
+		uint32_t lengthCode(size_t length) {
+			static const std::vector<uint8_t> codes = []() {
+				std::vector<uint8_t> result(MAX_MATCH + 1, 0);
+				for (size_t code = 0; code < LENGTH_CODES; code++) {
+					const size_t last = (code + 1 < LENGTH_CODES) ? size_t(LENGTH_BASE[code + 1]) : MAX_MATCH + 1;
+					for (size_t l = LENGTH_BASE[code]; l < last; l++) {
+						result[l] = uint8_t(code);
+					}
+				}
+				return result;
+			}();
+			return codes[length];
+		}
+
+		/**
+		 * \brief distance codes 0 - 3 stand for the distances 1 - 4, every further pair of codes doubles the range and adds an extra bit
+		 */
+		uint32_t distanceCode(uint32_t distance) {
+			if (distance <= 4) {
+				return distance - 1;
+			}
+			uint32_t highBit = 0;
+			for (uint32_t value = distance - 1; value > 1; value >>= 1) {
+				highBit++;
+			}
+			return 2 * highBit + (((distance - 1) >> (highBit - 1)) & 1);
+		}
+
+		uint32_t distanceExtra(uint32_t code) {
+			return (code < 4) ? 0 : code / 2 - 1;
+		}
+
+		uint32_t distanceBase(uint32_t code) {
+			return (code < 4) ? code + 1 : ((2 + (code & 1)) << distanceExtra(code)) + 1;
+		}
+
+	} /* namespace */
+
+	const int LZ77Huffman::MIN_LEVEL;
+	const int LZ77Huffman::MAX_LEVEL;
+	const int LZ77Huffman::DEFAULT_LEVEL;
+	const uint32_t LZ77Huffman::DEFAULT_WINDOW;
+
+	ClockError LZ77Huffman::compress(const std::string & uncompressed, std::string & compressed) {
+		return compress(uncompressed, compressed, DEFAULT_LEVEL, DEFAULT_WINDOW);
+	}
+
+	ClockError LZ77Huffman::compress(const std::string & uncompressed, std::string & compressed, int level, uint32_t window) {
+		OutputBuffer output(compressed);
+		return compress(reinterpret_cast<const uint8_t *>(uncompressed.data()), uncompressed.length(), output, level, window);
+	}
+
+	ClockError LZ77Huffman::decompress(const std::string & compressed, std::string & decompressed) {
+		OutputBuffer output(decompressed);
+		return decompress(reinterpret_cast<const uint8_t *>(compressed.data()), compressed.length(), output);
+	}
+
+	size_t LZ77Huffman::maxCompressedSize(size_t length) {
+		if (length == 0) {
+			return sizeof(len_t);
+		}
+		// a literal needs at most MAX_CODE_LENGTH bits and a match of at least MIN_MATCH bytes needs less than MIN_MATCH * MAX_CODE_LENGTH bits
+		const size_t headerSize = sizeof(len_t) + maxLengthsSize(LITERAL_ALPHABET) + maxLengthsSize(DISTANCE_ALPHABET);
+		return headerSize + length / 8 * MAX_CODE_LENGTH + (length % 8 * MAX_CODE_LENGTH) / 8 + 1;
+	}
+
+	ClockError LZ77Huffman::compress(const void * uncompressed, size_t length, void * compressed, size_t capacity, size_t & compressedLength) {
+		return compress(uncompressed, length, compressed, capacity, compressedLength, DEFAULT_LEVEL, DEFAULT_WINDOW);
+	}
+
+	ClockError LZ77Huffman::compress(const void * uncompressed, size_t length, void * compressed, size_t capacity, size_t & compressedLength, int level, uint32_t window) {
+		OutputBuffer output(compressed, capacity);
+		ClockError error = compress(static_cast<const uint8_t *>(uncompressed), length, output, level, window);
+		compressedLength = output.size();
+		return error;
+	}
+
+	ClockError LZ77Huffman::decompress(const void * compressed, size_t length, void * decompressed, size_t capacity, size_t & decompressedLength) {
+		OutputBuffer output(decompressed, capacity);
+		ClockError error = decompress(static_cast<const uint8_t *>(compressed), length, output);
+		decompressedLength = output.size();
+		return error;
+	}
+
+	ClockError LZ77Huffman::compress(const uint8_t * data, size_t length, OutputBuffer & output, int level, uint32_t window) {
+		if (length > std::numeric_limits<len_t>::max() || level < MIN_LEVEL || level > MAX_LEVEL || window == 0 || window > MatchFinder::MAX_WINDOW) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+
+		try {
+			std::string header;
+			for (size_t i = 0; i < sizeof(len_t); i++) {
+				header += char(uint8_t(length >> (8 * (sizeof(len_t) - 1 - i))));
+			}
+			if (length == 0) {
+				char * compressed = output.allocate(header.length());
+				if (!compressed) {
+					return ClockError::OUT_OF_MEMORY;
+				}
+				std::copy(header.begin(), header.end(), compressed);
+				return ClockError::SUCCESS;
+			}
+
+			// find the matches first, the codes depend on their statistics
+			const Level & parameters = LEVELS[level - MIN_LEVEL];
+			std::vector<Sequence> sequences;
+			size_t anchor = 0;
+			if (length >= MIN_MATCH) {
+				MatchFinder finder(data, length, window, parameters.attempts, parameters.niceLength);
+				size_t pos = 0;
+				while (pos + MIN_MATCH <= length) {
+					uint32_t distance = 0;
+					size_t matchLength = finder.find(pos, std::min(length, pos + MAX_MATCH), distance);
+					if (matchLength == 0) {
+						pos++;
+						continue;
+					}
+					// lazy matching: emit a literal instead if the next position starts a longer match
+					while (matchLength < parameters.lazyLength && pos + 1 + MIN_MATCH <= length) {
+						uint32_t nextDistance = 0;
+						const size_t nextLength = finder.find(pos + 1, std::min(length, pos + 1 + MAX_MATCH), nextDistance);
+						if (nextLength <= matchLength) {
+							break;
+						}
+						pos++;
+						matchLength = nextLength;
+						distance = nextDistance;
+					}
+					sequences.push_back(Sequence { uint32_t(pos - anchor), uint32_t(matchLength), distance });
+					pos += matchLength;
+					anchor = pos;
+				}
+			}
+			sequences.push_back(Sequence { uint32_t(length - anchor), 0, 0 });
+
+			std::vector<len_t> literalHistogram(LITERAL_ALPHABET, 0);
+			std::vector<len_t> distanceHistogram(DISTANCE_ALPHABET, 0);
+			uint64_t extraBits = 0;
+			size_t pos = 0;
+			for (const Sequence & sequence : sequences) {
+				for (size_t i = 0; i < sequence.literals; i++) {
+					literalHistogram[data[pos + i]]++;
+				}
+				pos += sequence.literals + sequence.matchLength;
+				if (sequence.matchLength > 0) {
+					const uint32_t lengthSymbol = lengthCode(sequence.matchLength);
+					const uint32_t distanceSymbol = distanceCode(sequence.distance);
+					literalHistogram[256 + lengthSymbol]++;
+					distanceHistogram[distanceSymbol]++;
+					extraBits += LENGTH_EXTRA[lengthSymbol] + distanceExtra(distanceSymbol);
+				}
+			}
+
+			std::vector<uint8_t> literalLengths;
+			buildLengths(literalHistogram, MAX_CODE_LENGTH, literalLengths);
+			std::vector<Code> literalCodes;
+			buildCanonicalCodes(literalLengths, literalCodes);
+			std::vector<uint8_t> distanceLengths;
+			buildLengths(distanceHistogram, MAX_CODE_LENGTH, distanceLengths);
+			std::vector<Code> distanceCodes;
+			buildCanonicalCodes(distanceLengths, distanceCodes);
+			writeLengths(literalLengths, header);
+			writeLengths(distanceLengths, header);
+
+			// bit sequence with at least one byte padding
+			const uint64_t bits = countBits(literalHistogram, literalCodes) + countBits(distanceHistogram, distanceCodes) + extraBits;
+			const size_t size = header.length() + size_t(bits / 8) + 1;
+			char * compressed = output.allocate(size);
+			if (!compressed) {
+				return ClockError::OUT_OF_MEMORY;
+			}
+			std::copy(header.begin(), header.end(), compressed);
+			compressed[size - 1] = 0x0;
+
+			BitWriter writer(compressed + header.length());
+			pos = 0;
+			for (const Sequence & sequence : sequences) {
+				for (const uint8_t * literal = data + pos; literal < data + pos + sequence.literals; literal++) {
+					writer.write(literalCodes[*literal].code, literalCodes[*literal].length);
+				}
+				pos += sequence.literals + sequence.matchLength;
+				if (sequence.matchLength == 0) {
+					continue;
+				}
+				const uint32_t lengthSymbol = lengthCode(sequence.matchLength);
+				writer.write(literalCodes[256 + lengthSymbol].code, literalCodes[256 + lengthSymbol].length);
+				if (LENGTH_EXTRA[lengthSymbol] > 0) {
+					writer.write(sequence.matchLength - LENGTH_BASE[lengthSymbol], LENGTH_EXTRA[lengthSymbol]);
+				}
+				const uint32_t distanceSymbol = distanceCode(sequence.distance);
+				writer.write(distanceCodes[distanceSymbol].code, distanceCodes[distanceSymbol].length);
+				if (distanceExtra(distanceSymbol) > 0) {
+					writer.write(sequence.distance - distanceBase(distanceSymbol), distanceExtra(distanceSymbol));
+				}
+			}
+			writer.flush();
+		} catch (std::bad_alloc &) {
+			return ClockError::OUT_OF_MEMORY;
+		}
+
+		return ClockError::SUCCESS;
+	}
+
+	ClockError LZ77Huffman::decompress(const uint8_t * compressed, size_t length, OutputBuffer & output) {
+		if (length < sizeof(len_t)) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+		len_t len = 0;
+		for (size_t i = 0; i < sizeof(len_t); i++) {
+			len *= 0x100; // * 256
+			len += compressed[i];
+		}
+		if (len == 0) {
+			output.allocate(0);
+			return (length == sizeof(len_t)) ? ClockError::SUCCESS : ClockError::INVALID_ARGUMENT;
+		}
+
+		size_t pos = sizeof(len_t);
+		std::vector<uint8_t> literalLengths;
+		ClockError error = readLengths(compressed, length, pos, LITERAL_ALPHABET, literalLengths);
+		if (error != ClockError::SUCCESS) {
+			return error;
+		}
+		std::vector<uint8_t> distanceLengths;
+		error = readLengths(compressed, length, pos, DISTANCE_ALPHABET, distanceLengths);
+		if (error != ClockError::SUCCESS) {
+			return error;
+		}
+		if (pos >= length) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+		std::vector<Code> codes;
+		buildCanonicalCodes(literalLengths, codes);
+		DecodeTable literalTable;
+		error = buildDecodeTable(codes, literalTable, false);
+		if (error != ClockError::SUCCESS) {
+			return error;
+		}
+		// a string without matches has no distance codes
+		const bool hasDistances = std::find_if(distanceLengths.begin(), distanceLengths.end(), [](uint8_t l) { return l > 0; }) != distanceLengths.end();
+		DecodeTable distanceTable;
+		if (hasDistances) {
+			buildCanonicalCodes(distanceLengths, codes);
+			error = buildDecodeTable(codes, distanceTable, false);
+			if (error != ClockError::SUCCESS) {
+				return error;
+			}
+		}
+
+		const uint8_t * data = compressed + pos;
+		const size_t size = length - pos;
+		// a match needs at least 2 bits and produces at most MAX_MATCH bytes
+		if (len / (MAX_MATCH * 4) > size) {
+			return ClockError::INVALID_ARGUMENT;
+		}
+		char * const begin = output.allocate(len);
+		if (!begin) {
+			return ClockError::OUT_OF_MEMORY;
+		}
+
+		BitReader reader(data, size);
+		char * out = begin;
+		char * const end = begin + len;
+		while (out < end) {
+			if (reader.position() >= uint64_t(size) * 8) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			reader.fill(MAX_LENGTH_BITS);
+			uint32_t symbol;
+			if (!reader.decode(literalTable, symbol)) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			if (symbol < 256) {
+				*out++ = char(symbol);
+				continue;
+			}
+			symbol -= 256;
+			if (symbol >= LENGTH_CODES || !hasDistances) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			const size_t matchLength = LENGTH_BASE[symbol] + reader.read(LENGTH_EXTRA[symbol]);
+
+			reader.fill(MAX_DISTANCE_BITS);
+			if (!reader.decode(distanceTable, symbol)) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			const size_t distance = distanceBase(symbol) + reader.read(distanceExtra(symbol));
+			if (distance > size_t(out - begin) || matchLength > size_t(end - out)) {
+				return ClockError::INVALID_ARGUMENT;
+			}
+			const char * match = out - distance;
+			if (distance >= matchLength) {
+				memcpy(out, match, matchLength);
+				out += matchLength;
+			} else {
+				// the match overlaps with itself and repeats the last distance bytes
+				for (char * matchEnd = out + matchLength; out < matchEnd; out++, match++) {
+					*out = *match;
+				}
+			}
+		}
+
+		return (reader.position() / 8 == size - 1) ? ClockError::SUCCESS : ClockError::INVALID_ARGUMENT;
+	}
+
+} /* namespace algorithm */
+} /* namespace compression */
+} /* namespace clockUtils */
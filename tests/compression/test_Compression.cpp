@@ -17,13 +17,23 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#include <algorithm>
 #include <random>
 
 #include "clockUtils/errors.h"
 
 #include "clockUtils/compression/Compression.h"
+#include "clockUtils/compression/algorithm/FSE.h"
+#include "clockUtils/compression/algorithm/HuffmanCanonical.h"
+#include "clockUtils/compression/algorithm/HuffmanContext.h"
 #include "clockUtils/compression/algorithm/HuffmanFixed.h"
 #include "clockUtils/compression/algorithm/HuffmanGeneric.h"
+#include "clockUtils/compression/algorithm/HuffmanInterleaved.h"
+#include "clockUtils/compression/algorithm/HuffmanPreset.h"
+#include "clockUtils/compression/algorithm/HuffmanTable.h"
+#include "clockUtils/compression/algorithm/HuffmanTrained.h"
+#include "clockUtils/compression/algorithm/LZ77.h"
+#include "clockUtils/compression/algorithm/LZ77Huffman.h"
 
 #include "gtest/gtest.h"
 
@@ -143,6 +153,64 @@ TEST(Compression, HuffmanGeneric) {
 	EXPECT_LT(compressedAllTheSame.length(), beforeAllTheSame.length());
 }
 
+TEST(Compression, HuffmanCanonical) {
+	std::string before("Hallo Welt!");
+	std::string beforeLong("The technique works by creating a binary tree of nodes. These can be stored in a regular array, the size of which depends on the number of symbols, n. A node can be either a leaf node or an internal node. Initially, all nodes are leaf nodes, which contain the symbol itself, the weight (frequency of appearance) of the symbol and optionally, a link to a parent node which makes it easy to read the code (in reverse) starting from a leaf node. Internal nodes contain symbol weight, links to two child nodes and the optional link to a parent node. As a common convention, bit '0' represents following the left child and bit '1' represents following the right child. A finished tree has up to n leaf nodes and n-1 internal nodes. A Huffman tree that omits unused symbols produces the most optimal code lengths.\nThe process essentially begins with the leaf nodes containing the probabilities of the symbol they represent, then a new node whose children are the 2 nodes with smallest probability is created, such that the new node's probability is equal to the sum of the children's probability.With the previous 2 nodes merged into one node(thus not considering them anymore), and with the new node being now considered, the procedure is repeated until only one node remains, the Huffman tree.\nThe simplest construction algorithm uses a priority queue where the node with lowest probability is given highest priority :\nCreate a leaf node for each symbol and add it to the priority queue.\nWhile there is more than one node in the queue :\nRemove the two nodes of highest priority(lowest probability) from the queue\nCreate a new internal node with these two nodes as children and with probability equal to the sum of the two nodes' probabilities.\nAdd the new node to the queue.\nThe remaining node is the root node and the tree is complete.\nSince efficient priority queue data structures require O(log n) time per insertion, and a tree with n leaves has 2n?1 nodes, this algorithm operates in O(n log n) time, where n is the number of symbols.\nIf the symbols are sorted by probability, there is a linear - time(O(n)) method to create a Huffman tree using two queues, the first one containing the initial weights(along with pointers to the associated leaves), and combined weights(along with pointers to the trees) being put in the back of the second queue.This assures that the lowest weight is always kept at the front of one of the two queues :\nStart with as many leaves as there are symbols.\nEnqueue all leaf nodes into the first queue(by probability in increasing order so that the least likely item is in the head of the queue).\nWhile there is more than one node in the queues :\nDequeue the two nodes with the lowest weight by examining the fronts of both queues.\nCreate a new internal node, with the two just - removed nodes as children(either node can be either child) and the sum of their weights as the new weight.\nEnqueue the new node into the rear of the second queue.\nThe remaining node is the root node; the tree has now been generated.\nAlthough linear - time given sorted input, in the general case of arbitrary input, using this algorithm requires pre - sorting.Thus, since sorting takes O(n log n) time in the general case, both methods have the same overall complexity.\nIn many cases, time complexity is not very important in the choice of algorithm here, since n here is the number of symbols in the alphabet, which is typically a very small number(compared to the length of the message to be encoded); whereas complexity analysis concerns the behavior when n grows to be very large.\nIt is generally beneficial to minimize the variance of codeword length.For example, a communication buffer receiving Huffman - encoded data may need to be larger to deal with especially long symbols if the tree is especially unbalanced.To minimize variance, simply break ties between queues by choosing the item in the first queue.This modification will retain the mathematical optimality of the Huffman coding while both minimizing variance and minimizing the length of the longest character code.\nHere's an example of optimized Huffman coding using the French subject string \"j'aime aller sur le bord de l'eau les jeudis ou les jours impairs\". Note that original Huffman coding tree structure would be different from the given example");
+	std::string beforeVeryLong;
+
+	std::vector<unsigned char> allTheSameVec(10000, 'a');
+	std::string beforeAllTheSame(allTheSameVec.begin(), allTheSameVec.end());
+
+	std::default_random_engine generator;
+	std::binomial_distribution<int> distribution(255, 0.5);
+
+	for (unsigned int i = 0; i < 50000; i++) {
+		beforeVeryLong += char(distribution(generator));
+	}
+
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::HuffmanCanonical> compressor;
+
+	std::string compressed;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.compress(before, compressed));
+	std::string compressedLong;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.compress(beforeLong, compressedLong));
+	std::string compressedVeryLong;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.compress(beforeVeryLong, compressedVeryLong));
+	std::string compressedAllTheSame;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.compress(beforeAllTheSame, compressedAllTheSame));
+
+	std::string after;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.decompress(compressed, after));
+	std::string afterLong;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.decompress(compressedLong, afterLong));
+	std::string afterVeryLong;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.decompress(compressedVeryLong, afterVeryLong));
+	std::string afterAllTheSame;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.decompress(compressedAllTheSame, afterAllTheSame));
+
+	EXPECT_NE(before, compressed);
+	EXPECT_NE(compressed, after);
+	EXPECT_EQ(before, after);
+
+	EXPECT_NE(beforeLong, compressedLong);
+	EXPECT_NE(compressedLong, afterLong);
+	EXPECT_EQ(beforeLong, afterLong);
+
+	EXPECT_LT(compressedLong.length(), beforeLong.length());
+
+	EXPECT_NE(beforeVeryLong, compressedVeryLong);
+	EXPECT_NE(compressedVeryLong, afterVeryLong);
+	EXPECT_EQ(beforeVeryLong, afterVeryLong);
+
+	EXPECT_LT(compressedVeryLong.length(), beforeVeryLong.length());
+
+	EXPECT_NE(beforeAllTheSame, compressedAllTheSame);
+	EXPECT_NE(compressedAllTheSame, afterAllTheSame);
+	EXPECT_EQ(beforeAllTheSame, afterAllTheSame);
+
+	EXPECT_LT(compressedAllTheSame.length(), beforeAllTheSame.length());
+}
+
 TEST(Compression, HuffmanComparison) {
 	std::string before("Hallo Welt!");
 	std::string beforeLong("The technique works by creating a binary tree of nodes. These can be stored in a regular array, the size of which depends on the number of symbols, n. A node can be either a leaf node or an internal node. Initially, all nodes are leaf nodes, which contain the symbol itself, the weight (frequency of appearance) of the symbol and optionally, a link to a parent node which makes it easy to read the code (in reverse) starting from a leaf node. Internal nodes contain symbol weight, links to two child nodes and the optional link to a parent node. As a common convention, bit '0' represents following the left child and bit '1' represents following the right child. A finished tree has up to n leaf nodes and n-1 internal nodes. A Huffman tree that omits unused symbols produces the most optimal code lengths.\nThe process essentially begins with the leaf nodes containing the probabilities of the symbol they represent, then a new node whose children are the 2 nodes with smallest probability is created, such that the new node's probability is equal to the sum of the children's probability.With the previous 2 nodes merged into one node(thus not considering them anymore), and with the new node being now considered, the procedure is repeated until only one node remains, the Huffman tree.\nThe simplest construction algorithm uses a priority queue where the node with lowest probability is given highest priority :\nCreate a leaf node for each symbol and add it to the priority queue.\nWhile there is more than one node in the queue :\nRemove the two nodes of highest priority(lowest probability) from the queue\nCreate a new internal node with these two nodes as children and with probability equal to the sum of the two nodes' probabilities.\nAdd the new node to the queue.\nThe remaining node is the root node and the tree is complete.\nSince efficient priority queue data structures require O(log n) time per insertion, and a tree with n leaves has 2n?1 nodes, this algorithm operates in O(n log n) time, where n is the number of symbols.\nIf the symbols are sorted by probability, there is a linear - time(O(n)) method to create a Huffman tree using two queues, the first one containing the initial weights(along with pointers to the associated leaves), and combined weights(along with pointers to the trees) being put in the back of the second queue.This assures that the lowest weight is always kept at the front of one of the two queues :\nStart with as many leaves as there are symbols.\nEnqueue all leaf nodes into the first queue(by probability in increasing order so that the least likely item is in the head of the queue).\nWhile there is more than one node in the queues :\nDequeue the two nodes with the lowest weight by examining the fronts of both queues.\nCreate a new internal node, with the two just - removed nodes as children(either node can be either child) and the sum of their weights as the new weight.\nEnqueue the new node into the rear of the second queue.\nThe remaining node is the root node; the tree has now been generated.\nAlthough linear - time given sorted input, in the general case of arbitrary input, using this algorithm requires pre - sorting.Thus, since sorting takes O(n log n) time in the general case, both methods have the same overall complexity.\nIn many cases, time complexity is not very important in the choice of algorithm here, since n here is the number of symbols in the alphabet, which is typically a very small number(compared to the length of the message to be encoded); whereas complexity analysis concerns the behavior when n grows to be very large.\nIt is generally beneficial to minimize the variance of codeword length.For example, a communication buffer receiving Huffman - encoded data may need to be larger to deal with especially long symbols if the tree is especially unbalanced.To minimize variance, simply break ties between queues by choosing the item in the first queue.This modification will retain the mathematical optimality of the Huffman coding while both minimizing variance and minimizing the length of the longest character code.\nHere's an example of optimized Huffman coding using the French subject string \"j'aime aller sur le bord de l'eau les jeudis ou les jours impairs\". Note that original Huffman coding tree structure would be different from the given example");
@@ -164,6 +232,28 @@ TEST(Compression, HuffmanComparison) {
 	EXPECT_LT(compressedLongFixed.length(), compressedLongGeneric.length());
 }
 
+TEST(Compression, HuffmanCanonicalComparison) {
+	std::string before("Hallo Welt!");
+	std::string beforeLong("The technique works by creating a binary tree of nodes. These can be stored in a regular array, the size of which depends on the number of symbols, n. A node can be either a leaf node or an internal node. Initially, all nodes are leaf nodes, which contain the symbol itself, the weight (frequency of appearance) of the symbol and optionally, a link to a parent node which makes it easy to read the code (in reverse) starting from a leaf node. Internal nodes contain symbol weight, links to two child nodes and the optional link to a parent node. As a common convention, bit '0' represents following the left child and bit '1' represents following the right child. A finished tree has up to n leaf nodes and n-1 internal nodes. A Huffman tree that omits unused symbols produces the most optimal code lengths.\nThe process essentially begins with the leaf nodes containing the probabilities of the symbol they represent, then a new node whose children are the 2 nodes with smallest probability is created, such that the new node's probability is equal to the sum of the children's probability.With the previous 2 nodes merged into one node(thus not considering them anymore), and with the new node being now considered, the procedure is repeated until only one node remains, the Huffman tree.\nThe simplest construction algorithm uses a priority queue where the node with lowest probability is given highest priority :\nCreate a leaf node for each symbol and add it to the priority queue.\nWhile there is more than one node in the queue :\nRemove the two nodes of highest priority(lowest probability) from the queue\nCreate a new internal node with these two nodes as children and with probability equal to the sum of the two nodes' probabilities.\nAdd the new node to the queue.\nThe remaining node is the root node and the tree is complete.\nSince efficient priority queue data structures require O(log n) time per insertion, and a tree with n leaves has 2n?1 nodes, this algorithm operates in O(n log n) time, where n is the number of symbols.\nIf the symbols are sorted by probability, there is a linear - time(O(n)) method to create a Huffman tree using two queues, the first one containing the initial weights(along with pointers to the associated leaves), and combined weights(along with pointers to the trees) being put in the back of the second queue.This assures that the lowest weight is always kept at the front of one of the two queues :\nStart with as many leaves as there are symbols.\nEnqueue all leaf nodes into the first queue(by probability in increasing order so that the least likely item is in the head of the queue).\nWhile there is more than one node in the queues :\nDequeue the two nodes with the lowest weight by examining the fronts of both queues.\nCreate a new internal node, with the two just - removed nodes as children(either node can be either child) and the sum of their weights as the new weight.\nEnqueue the new node into the rear of the second queue.\nThe remaining node is the root node; the tree has now been generated.\nAlthough linear - time given sorted input, in the general case of arbitrary input, using this algorithm requires pre - sorting.Thus, since sorting takes O(n log n) time in the general case, both methods have the same overall complexity.\nIn many cases, time complexity is not very important in the choice of algorithm here, since n here is the number of symbols in the alphabet, which is typically a very small number(compared to the length of the message to be encoded); whereas complexity analysis concerns the behavior when n grows to be very large.\nIt is generally beneficial to minimize the variance of codeword length.For example, a communication buffer receiving Huffman - encoded data may need to be larger to deal with especially long symbols if the tree is especially unbalanced.To minimize variance, simply break ties between queues by choosing the item in the first queue.This modification will retain the mathematical optimality of the Huffman coding while both minimizing variance and minimizing the length of the longest character code.\nHere's an example of optimized Huffman coding using the French subject string \"j'aime aller sur le bord de l'eau les jeudis ou les jours impairs\". Note that original Huffman coding tree structure would be different from the given example");
+
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::HuffmanGeneric> compressorGeneric;
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::HuffmanCanonical> compressorCanonical;
+
+	std::string compressedGeneric;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressorGeneric.compress(before, compressedGeneric));
+	std::string compressedLongGeneric;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressorGeneric.compress(beforeLong, compressedLongGeneric));
+
+	std::string compressedCanonical;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressorCanonical.compress(before, compressedCanonical));
+	std::string compressedLongCanonical;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressorCanonical.compress(beforeLong, compressedLongCanonical));
+
+	// the header of canonical Huffman is much smaller and the codes are built from the exact frequencies
+	EXPECT_LT(compressedCanonical.length(), compressedGeneric.length());
+	EXPECT_LT(compressedLongCanonical.length(), compressedLongGeneric.length());
+}
+
 TEST(Compression, decompressUncompressedString) {
 	std::string before("Hallo Welt!");
 	std::string beforeLong("The technique works by creating a binary tree of nodes. These can be stored in a regular array, the size of which depends on the number of symbols, n. A node can be either a leaf node or an internal node. Initially, all nodes are leaf nodes, which contain the symbol itself, the weight (frequency of appearance) of the symbol and optionally, a link to a parent node which makes it easy to read the code (in reverse) starting from a leaf node. Internal nodes contain symbol weight, links to two child nodes and the optional link to a parent node. As a common convention, bit '0' represents following the left child and bit '1' represents following the right child. A finished tree has up to n leaf nodes and n-1 internal nodes. A Huffman tree that omits unused symbols produces the most optimal code lengths.\nThe process essentially begins with the leaf nodes containing the probabilities of the symbol they represent, then a new node whose children are the 2 nodes with smallest probability is created, such that the new node's probability is equal to the sum of the children's probability.With the previous 2 nodes merged into one node(thus not considering them anymore), and with the new node being now considered, the procedure is repeated until only one node remains, the Huffman tree.\nThe simplest construction algorithm uses a priority queue where the node with lowest probability is given highest priority :\nCreate a leaf node for each symbol and add it to the priority queue.\nWhile there is more than one node in the queue :\nRemove the two nodes of highest priority(lowest probability) from the queue\nCreate a new internal node with these two nodes as children and with probability equal to the sum of the two nodes' probabilities.\nAdd the new node to the queue.\nThe remaining node is the root node and the tree is complete.\nSince efficient priority queue data structures require O(log n) time per insertion, and a tree with n leaves has 2n?1 nodes, this algorithm operates in O(n log n) time, where n is the number of symbols.\nIf the symbols are sorted by probability, there is a linear - time(O(n)) method to create a Huffman tree using two queues, the first one containing the initial weights(along with pointers to the associated leaves), and combined weights(along with pointers to the trees) being put in the back of the second queue.This assures that the lowest weight is always kept at the front of one of the two queues :\nStart with as many leaves as there are symbols.\nEnqueue all leaf nodes into the first queue(by probability in increasing order so that the least likely item is in the head of the queue).\nWhile there is more than one node in the queues :\nDequeue the two nodes with the lowest weight by examining the fronts of both queues.\nCreate a new internal node, with the two just - removed nodes as children(either node can be either child) and the sum of their weights as the new weight.\nEnqueue the new node into the rear of the second queue.\nThe remaining node is the root node; the tree has now been generated.\nAlthough linear - time given sorted input, in the general case of arbitrary input, using this algorithm requires pre - sorting.Thus, since sorting takes O(n log n) time in the general case, both methods have the same overall complexity.\nIn many cases, time complexity is not very important in the choice of algorithm here, since n here is the number of symbols in the alphabet, which is typically a very small number(compared to the length of the message to be encoded); whereas complexity analysis concerns the behavior when n grows to be very large.\nIt is generally beneficial to minimize the variance of codeword length.For example, a communication buffer receiving Huffman - encoded data may need to be larger to deal with especially long symbols if the tree is especially unbalanced.To minimize variance, simply break ties between queues by choosing the item in the first queue.This modification will retain the mathematical optimality of the Huffman coding while both minimizing variance and minimizing the length of the longest character code.\nHere's an example of optimized Huffman coding using the French subject string \"j'aime aller sur le bord de l'eau les jeudis ou les jours impairs\". Note that original Huffman coding tree structure would be different from the given example"); beforeLong[256] = 0x0;
@@ -279,3 +369,761 @@ TEST(Compression, decompressUncompressedStringWithMaxLength) {
 	error = compressorFixed.decompress(uncompressed, decompressed);
 	EXPECT_TRUE(clockUtils::ClockError::INVALID_ARGUMENT == error || clockUtils::ClockError::OUT_OF_MEMORY == error);
 }
+
+TEST(Compression, HuffmanLongCodes) {
+	// geometric distribution leads to codes longer than the first level of the decoding table
+	std::default_random_engine generator;
+	std::geometric_distribution<int> distribution(0.3);
+	std::string before;
+	for (unsigned int i = 0; i < 100000; i++) {
+		before += char(std::min(distribution(generator), 255));
+	}
+	for (int c = 0; c < 256; c++) {
+		before += char(c);
+	}
+
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::HuffmanGeneric> generic;
+	std::string compressed;
+	std::string after;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, generic.compress(before, compressed));
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, generic.decompress(compressed, after));
+	EXPECT_EQ(before, after);
+
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::HuffmanFixed> fixed;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, fixed.compress(before, compressed));
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, fixed.decompress(compressed, after));
+	EXPECT_EQ(before, after);
+
+	// canonical codes are limited in length
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::HuffmanCanonical> canonical;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, canonical.compress(before, compressed));
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, canonical.decompress(compressed, after));
+	EXPECT_EQ(before, after);
+}
+
+TEST(Compression, HuffmanAllLengths) {
+	// every length ends at another position in the last bytes of the bit sequence
+	const std::string text("Hallo Welt! The quick brown fox jumps over the lazy dog. 0123456789 {\"key\": [1, 2, 3]}");
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::HuffmanGeneric> generic;
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::HuffmanFixed> fixed;
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::HuffmanCanonical> canonical;
+	for (size_t i = 1; i < text.length(); i++) {
+		const std::string before = text.substr(0, i);
+		std::string compressed;
+		std::string after;
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, generic.compress(before, compressed));
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, generic.decompress(compressed, after));
+		EXPECT_EQ(before, after);
+		// missing or additional bytes are detected
+		EXPECT_NE(clockUtils::ClockError::SUCCESS, generic.decompress(compressed + char(0), after));
+		EXPECT_NE(clockUtils::ClockError::SUCCESS, generic.decompress(compressed.substr(0, compressed.length() - 1), after));
+
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, fixed.compress(before, compressed));
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, fixed.decompress(compressed, after));
+		EXPECT_EQ(before, after);
+		EXPECT_NE(clockUtils::ClockError::SUCCESS, fixed.decompress(compressed + char(0), after));
+		EXPECT_NE(clockUtils::ClockError::SUCCESS, fixed.decompress(compressed.substr(0, compressed.length() - 1), after));
+
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, canonical.compress(before, compressed));
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, canonical.decompress(compressed, after));
+		EXPECT_EQ(before, after);
+		EXPECT_NE(clockUtils::ClockError::SUCCESS, canonical.decompress(compressed + char(0), after));
+		EXPECT_NE(clockUtils::ClockError::SUCCESS, canonical.decompress(compressed.substr(0, compressed.length() - 1), after));
+	}
+}
+
+TEST(Compression, HuffmanCanonicalEmptyAndGarbage) {
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::HuffmanCanonical> canonical;
+	std::string compressed;
+	std::string after("foo");
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, canonical.compress("", compressed));
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, canonical.decompress(compressed, after));
+	EXPECT_TRUE(after.empty());
+
+	// random headers and bit sequences must not crash
+	std::default_random_engine generator;
+	std::uniform_int_distribution<int> distribution(0, 255);
+	for (int i = 0; i < 1000; i++) {
+		std::string garbage("\0\0\0\x10\0", 5);
+		for (int j = 0; j < 40; j++) {
+			garbage += char(distribution(generator));
+		}
+		canonical.decompress(garbage, after);
+	}
+}
+
+namespace {
+
+	/**
+	 * \brief makes the histogram of HuffmanBase accessible
+	 */
+	class HistogramTester : public clockUtils::compression::algorithm::HuffmanBase {
+	public:
+		using HuffmanBase::HistogramMerge;
+		using HuffmanBase::calcHistogram;
+		using HuffmanBase::setHistogramMerge;
+	};
+
+	std::vector<uint32_t> countBytes(const std::string & text) {
+		std::vector<uint32_t> histogram(256, 0);
+		for (char c : text) {
+			histogram[uint8_t(c)]++;
+		}
+		return histogram;
+	}
+
+} /* namespace */
+
+TEST(Compression, Histogram) {
+	std::default_random_engine generator;
+	std::uniform_int_distribution<int> distribution(0, 255);
+	std::string random;
+	for (int i = 0; i < 40; i++) {
+		random += char(distribution(generator));
+	}
+	std::vector<std::string> inputs;
+	// all lengths of the 16 byte loop and the remaining bytes
+	for (size_t length = 0; length <= random.length(); length++) {
+		inputs.push_back(random.substr(0, length));
+	}
+	// long runs of one byte are counted in all tables
+	inputs.push_back(std::string(1000003, 'a'));
+	inputs.push_back(std::string(100000, '\0') + std::string(100001, '\xFF') + random);
+	std::string runs;
+	while (runs.length() < 100000) {
+		runs += std::string(size_t(1 + distribution(generator)), char(distribution(generator)));
+	}
+	inputs.push_back(runs);
+
+	// every merge the cpu supports has to give the same result, Auto is last to restore the default
+	for (HistogramTester::HistogramMerge merge : { HistogramTester::HistogramMerge::Scalar, HistogramTester::HistogramMerge::SSE2, HistogramTester::HistogramMerge::AVX2, HistogramTester::HistogramMerge::Auto }) {
+		if (!HistogramTester::setHistogramMerge(merge)) {
+			EXPECT_NE(HistogramTester::HistogramMerge::Scalar, merge);
+			EXPECT_NE(HistogramTester::HistogramMerge::Auto, merge);
+			continue;
+		}
+		for (const std::string & input : inputs) {
+			std::vector<uint32_t> histogram;
+			HistogramTester::calcHistogram(input, histogram);
+			EXPECT_EQ(countBytes(input), histogram);
+		}
+	}
+}
+
+TEST(Compression, HuffmanContext) {
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::HuffmanContext> context;
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::HuffmanCanonical> canonical;
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::HuffmanGeneric> generic;
+
+	// every byte only has a few possible successors, so the previous byte predicts the next one well
+	std::default_random_engine generator;
+	std::uniform_int_distribution<int> distribution(0, 255);
+	const char * words[] = { "the ", "quick ", "brown ", "fox ", "jumps ", "over ", "lazy ", "dog ", "compression ", "library " };
+	std::string text;
+	while (text.length() < 100000) {
+		text += words[distribution(generator) % 10];
+	}
+	std::string random;
+	for (int i = 0; i < 20000; i++) {
+		random += char(distribution(generator));
+	}
+
+	for (const std::string & before : { std::string(), std::string("a"), std::string("Hallo Welt!"), std::string(10000, 'a'), text, random, text.substr(0, 3000) + random.substr(0, 3000) }) {
+		std::string compressed;
+		std::string after;
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, context.compress(before, compressed));
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, context.decompress(compressed, after));
+		EXPECT_EQ(before, after);
+	}
+
+	std::string compressedContext;
+	std::string compressedCanonical;
+	std::string compressedGeneric;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, context.compress(text, compressedContext));
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, canonical.compress(text, compressedCanonical));
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, generic.compress(text, compressedGeneric));
+	EXPECT_LT(compressedContext.length() * 3, compressedGeneric.length() * 2);
+	EXPECT_LT(compressedContext.length(), compressedCanonical.length());
+
+	// every second byte is used, so every class needs the largest header for its code lengths, the output still fits into maxCompressedSize
+	std::string odd;
+	for (int b = 1; b < 256; b += 2) {
+		odd += char(b);
+	}
+	std::string alternating;
+	for (size_t i = 0; i < 64; i++) {
+		std::shuffle(odd.begin(), odd.end(), generator);
+		alternating += odd;
+		for (const std::string & before : { odd, alternating, alternating + text.substr(0, alternating.length()) }) {
+			std::vector<char> compressed(context.maxCompressedSize(before.length()));
+			size_t compressedLength = 0;
+			ASSERT_EQ(clockUtils::ClockError::SUCCESS, context.compress(before.data(), before.length(), compressed.data(), compressed.size(), compressedLength));
+			std::string after;
+			EXPECT_EQ(clockUtils::ClockError::SUCCESS, context.decompress(std::string(compressed.data(), compressedLength), after));
+			EXPECT_EQ(before, after);
+		}
+	}
+
+	// truncated and random input must not crash
+	std::string after;
+	EXPECT_NE(clockUtils::ClockError::SUCCESS, context.decompress(compressedContext.substr(0, compressedContext.length() - 1), after));
+	EXPECT_NE(clockUtils::ClockError::SUCCESS, context.decompress(compressedContext.substr(0, 40), after));
+	for (int i = 0; i < 1000; i++) {
+		std::string garbage("\0\0\0\x10", 4);
+		garbage += char(1 + distribution(generator) % 4);
+		for (int j = 0; j < 80; j++) {
+			garbage += char(distribution(generator));
+		}
+		context.decompress(garbage, after);
+	}
+}
+
+TEST(Compression, HuffmanEmptyString) {
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::HuffmanGeneric> generic;
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::HuffmanFixed> fixed;
+	std::string compressed;
+	std::string after("foo");
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, generic.compress("", compressed));
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, generic.decompress(compressed, after));
+	EXPECT_TRUE(after.empty());
+	after = "foo";
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, fixed.compress("", compressed));
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, fixed.decompress(compressed, after));
+	EXPECT_TRUE(after.empty());
+}
+
+TEST(Compression, LZ77) {
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::LZ77> compressor;
+
+	std::string json;
+	for (int i = 0; i < 1000; i++) {
+		json += "{\"id\":" + std::to_string(i) + ",\"name\":\"entry" + std::to_string(i % 17) + "\",\"tags\":[\"network\",\"payload\"],\"valid\":" + ((i % 3) ? "true" : "false") + "}\n";
+	}
+	std::default_random_engine generator;
+	std::uniform_int_distribution<int> distribution(0, 255);
+	std::string random;
+	for (int i = 0; i < 50000; i++) {
+		random += char(distribution(generator));
+	}
+
+	for (const std::string & before : { std::string(), std::string("a"), std::string("Hallo Welt!"), std::string("Hallo Welt! Hallo Welt! Hallo Welt!"), std::string(10000, 'a'), json, random, json + random + json }) {
+		std::string compressed;
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.compress(before, compressed));
+		std::string after("foo");
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.decompress(compressed, after));
+		EXPECT_EQ(before, after);
+		// incompressible data may grow only a little
+		EXPECT_LE(compressed.length(), before.length() + before.length() / 255 + 16);
+	}
+
+	std::string compressed;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.compress(json, compressed));
+	EXPECT_LT(compressed.length(), json.length() / 4);
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.compress(std::string(10000, 'a'), compressed));
+	EXPECT_LT(compressed.length(), 100u);
+}
+
+TEST(Compression, LZ77Overlaps) {
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::LZ77> compressor;
+	std::default_random_engine generator;
+	std::uniform_int_distribution<int> distribution(0, 255);
+
+	// repeated patterns of every short length test the copies of matches overlapping themselves
+	for (size_t period = 1; period <= 40; period++) {
+		std::string pattern;
+		for (size_t i = 0; i < period; i++) {
+			pattern += char(distribution(generator));
+		}
+		for (size_t length : { 13, 20, 100, 1000 }) {
+			std::string before;
+			while (before.length() < length) {
+				before += pattern;
+			}
+			before += "end of the string";
+			std::string compressed;
+			EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.compress(before, compressed));
+			std::string after;
+			EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.decompress(compressed, after));
+			EXPECT_EQ(before, after);
+		}
+	}
+}
+
+TEST(Compression, LZ77InvalidInput) {
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::LZ77> compressor;
+	std::string before;
+	for (int i = 0; i < 200; i++) {
+		before += "repeated text " + std::to_string(i % 10);
+	}
+	std::string compressed;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.compress(before, compressed));
+
+	std::string after;
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compressor.decompress("", after));
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compressor.decompress(compressed.substr(0, 4), after));
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compressor.decompress(compressed.substr(0, compressed.length() - 1), after));
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compressor.decompress(compressed + "a", after));
+	// distance pointing in front of the string
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compressor.decompress(std::string("\0\0\0\x08\x10" "a\x02\0\0", 9), after));
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compressor.decompress(std::string("\0\0\0\x08\x10" "a\0\0\0", 9), after));
+
+	// random modifications must not crash
+	std::default_random_engine generator;
+	std::uniform_int_distribution<size_t> position(0, compressed.length() - 1);
+	std::uniform_int_distribution<int> value(0, 255);
+	for (int i = 0; i < 1000; i++) {
+		std::string garbage = compressed;
+		for (int j = 0; j < 3; j++) {
+			garbage[position(generator)] = char(value(generator));
+		}
+		compressor.decompress(garbage, after);
+	}
+}
+
+TEST(Compression, LZ77Huffman) {
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::LZ77Huffman> compressor;
+
+	std::string json;
+	for (int i = 0; i < 1000; i++) {
+		json += "{\"id\":" + std::to_string(i) + ",\"name\":\"entry" + std::to_string(i % 17) + "\",\"tags\":[\"network\",\"payload\"],\"valid\":" + ((i % 3) ? "true" : "false") + "}\n";
+	}
+	std::default_random_engine generator;
+	std::uniform_int_distribution<int> distribution(0, 255);
+	std::string random;
+	for (int i = 0; i < 50000; i++) {
+		random += char(distribution(generator));
+	}
+
+	for (const std::string & before : { std::string(), std::string("a"), std::string("Hallo Welt!"), std::string("Hallo Welt! Hallo Welt! Hallo Welt!"), std::string(100000, 'a'), json, random, json + random + json }) {
+		for (int level = clockUtils::compression::algorithm::LZ77Huffman::MIN_LEVEL; level <= clockUtils::compression::algorithm::LZ77Huffman::MAX_LEVEL; level++) {
+			std::string compressed;
+			EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.compress(before, compressed, level));
+			std::string after("foo");
+			EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.decompress(compressed, after));
+			EXPECT_EQ(before, after);
+		}
+	}
+
+	// entropy coding makes it better than both parts alone
+	std::string compressed;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.compress(json, compressed));
+	std::string compressedLZ77;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, clockUtils::compression::algorithm::LZ77::compress(json, compressedLZ77));
+	std::string compressedHuffman;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, clockUtils::compression::algorithm::HuffmanCanonical::compress(json, compressedHuffman));
+	EXPECT_LT(compressed.length(), compressedLZ77.length());
+	EXPECT_LT(compressed.length(), compressedHuffman.length());
+
+	// higher levels don't compress worse
+	std::string compressedFast;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.compress(json, compressedFast, clockUtils::compression::algorithm::LZ77Huffman::MIN_LEVEL));
+	std::string compressedBest;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.compress(json, compressedBest, clockUtils::compression::algorithm::LZ77Huffman::MAX_LEVEL));
+	EXPECT_LE(compressedBest.length(), compressed.length());
+	EXPECT_LE(compressed.length(), compressedFast.length());
+}
+
+TEST(Compression, LZ77HuffmanWindow) {
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::LZ77Huffman> compressor;
+	std::default_random_engine generator;
+	std::uniform_int_distribution<int> distribution(0, 255);
+	std::string block;
+	for (int i = 0; i < 40000; i++) {
+		block += char(distribution(generator));
+	}
+	// the repetition is only found if the window reaches back to the first block
+	const std::string before = block + block;
+	std::string compressedSmall;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.compress(before, compressedSmall, 6, 32768u));
+	std::string compressedLarge;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.compress(before, compressedLarge, 6, 65535u));
+	EXPECT_GT(compressedSmall.length(), before.length() * 9 / 10);
+	EXPECT_LT(compressedLarge.length(), before.length() * 6 / 10);
+	std::string after;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.decompress(compressedSmall, after));
+	EXPECT_EQ(before, after);
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.decompress(compressedLarge, after));
+	EXPECT_EQ(before, after);
+
+	for (uint32_t window : { 1u, 4u, 100u }) {
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.compress(before.substr(0, 1000) + before.substr(0, 1000), compressedSmall, 6, window));
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.decompress(compressedSmall, after));
+		EXPECT_EQ(before.substr(0, 1000) + before.substr(0, 1000), after);
+	}
+
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compressor.compress(before, compressedSmall, 0));
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compressor.compress(before, compressedSmall, 10));
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compressor.compress(before, compressedSmall, 6, 0u));
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compressor.compress(before, compressedSmall, 6, 65536u));
+}
+
+TEST(Compression, LZ77HuffmanInvalidInput) {
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::LZ77Huffman> compressor;
+	std::string before;
+	for (int i = 0; i < 200; i++) {
+		before += "repeated text " + std::to_string(i % 10);
+	}
+	std::string compressed;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.compress(before, compressed));
+
+	std::string after;
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compressor.decompress("", after));
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compressor.decompress(compressed.substr(0, 4), after));
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compressor.decompress(compressed.substr(0, compressed.length() - 1), after));
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compressor.decompress(compressed + "a", after));
+
+	// random modifications must not crash
+	std::default_random_engine generator;
+	std::uniform_int_distribution<size_t> position(0, compressed.length() - 1);
+	std::uniform_int_distribution<int> value(0, 255);
+	for (int i = 0; i < 1000; i++) {
+		std::string garbage = compressed;
+		for (int j = 0; j < 3; j++) {
+			garbage[position(generator)] = char(value(generator));
+		}
+		compressor.decompress(garbage, after);
+	}
+}
+
+TEST(Compression, HuffmanInterleaved) {
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::HuffmanInterleaved> interleaved;
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::HuffmanGeneric> generic;
+
+	std::default_random_engine generator;
+	std::binomial_distribution<int> distribution(255, 0.5);
+	std::string veryLong;
+	for (unsigned int i = 0; i < 50000; i++) {
+		veryLong += char(distribution(generator));
+	}
+	std::string text;
+	for (int i = 0; i < 1000; i++) {
+		text += "The technique works by creating a binary tree of nodes. " + std::to_string(i);
+	}
+
+	// all lengths up to some codes per stream test the transition to the rest of every stream
+	std::vector<std::string> strings = { std::string(), std::string(10000, 'a'), veryLong, text };
+	for (size_t i = 1; i < 100; i++) {
+		strings.push_back(text.substr(0, i));
+	}
+	for (const std::string & before : strings) {
+		std::string compressed;
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, interleaved.compress(before, compressed));
+		std::string after("foo");
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, interleaved.decompress(compressed, after));
+		EXPECT_EQ(before, after);
+
+		// same codes as HuffmanGeneric, only the jump table and the padding of the additional streams are added
+		std::string compressedGeneric;
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, generic.compress(before, compressedGeneric));
+		EXPECT_LE(compressed.length(), compressedGeneric.length() + 12 + 3);
+		EXPECT_EQ(compressedGeneric.substr(0, 260), compressed.substr(0, 260));
+
+		if (!before.empty()) {
+			EXPECT_NE(clockUtils::ClockError::SUCCESS, interleaved.decompress(compressed.substr(0, compressed.length() - 1), after));
+			EXPECT_NE(clockUtils::ClockError::SUCCESS, interleaved.decompress(compressed + char(0), after));
+		}
+	}
+
+	// random jump tables must not crash
+	std::string compressed;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, interleaved.compress(text, compressed));
+	std::uniform_int_distribution<int> value(0, 255);
+	std::string after;
+	for (int i = 0; i < 1000; i++) {
+		std::string garbage = compressed;
+		garbage[260 + size_t(value(generator)) % 12] = char(value(generator));
+		interleaved.decompress(garbage, after);
+	}
+}
+
+TEST(Compression, FSE) {
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::FSE> compressor;
+
+	std::default_random_engine generator;
+	std::uniform_int_distribution<int> distribution(0, 255);
+	std::string random;
+	for (int i = 0; i < 50000; i++) {
+		random += char(distribution(generator));
+	}
+	std::string all;
+	for (int i = 0; i < 256; i++) {
+		all += char(i);
+	}
+	std::string text;
+	for (int i = 0; i < 1000; i++) {
+		text += "The technique works by creating a binary tree of nodes. " + std::to_string(i);
+	}
+
+	// short strings test the transitions between both states and the padding of short bit sequences
+	std::vector<std::string> strings = { std::string(), std::string(1, '\0'), std::string(10000, 'a'), std::string(10000, char(255)), all, random, text };
+	for (size_t i = 1; i < 40; i++) {
+		strings.push_back(text.substr(0, i));
+	}
+	for (const std::string & before : strings) {
+		std::string compressed;
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.compress(before, compressed));
+		std::string after("foo");
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.decompress(compressed, after));
+		EXPECT_EQ(before, after);
+	}
+
+	// a single byte doesn't need any bits besides the header and the states
+	std::string compressed;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.compress(std::string(10000, 'a'), compressed));
+	EXPECT_LT(compressed.length(), 20u);
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.compress(random, compressed));
+	EXPECT_LT(compressed.length(), random.length() + 600);
+}
+
+TEST(Compression, FSESkewed) {
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::FSE> fse;
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::HuffmanCanonical> canonical;
+
+	// Huffman codes need at least one bit per byte, FSE gets close to the entropy
+	std::default_random_engine generator;
+	for (double p : { 0.5, 0.8, 0.95 }) {
+		std::geometric_distribution<int> distribution(p);
+		std::string before;
+		for (int i = 0; i < 100000; i++) {
+			before += char(std::min(distribution(generator), 255));
+		}
+		std::string compressed;
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, fse.compress(before, compressed));
+		std::string after;
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, fse.decompress(compressed, after));
+		EXPECT_EQ(before, after);
+
+		std::string compressedCanonical;
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, canonical.compress(before, compressedCanonical));
+		EXPECT_LT(compressed.length(), compressedCanonical.length());
+	}
+}
+
+TEST(Compression, FSEInvalidInput) {
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::FSE> compressor;
+	std::string before;
+	for (int i = 0; i < 200; i++) {
+		before += "skewed text " + std::to_string(i % 10);
+	}
+	std::string compressed;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.compress(before, compressed));
+
+	std::string after;
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compressor.decompress("", after));
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compressor.decompress(std::string("\0\0\0\0a", 5), after));
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compressor.decompress(compressed.substr(0, 6), after));
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compressor.decompress(compressed.substr(0, compressed.length() - 1), after));
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compressor.decompress(compressed + "a", after));
+	// table log out of range
+	std::string garbage = compressed;
+	garbage[4] = char(13);
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compressor.decompress(garbage, after));
+
+	// random modifications must not crash
+	std::default_random_engine generator;
+	std::uniform_int_distribution<size_t> position(0, compressed.length() - 1);
+	std::uniform_int_distribution<int> value(0, 255);
+	for (int i = 0; i < 1000; i++) {
+		garbage = compressed;
+		for (int j = 0; j < 3; j++) {
+			garbage[position(generator)] = char(value(generator));
+		}
+		compressor.decompress(garbage, after);
+	}
+}
+
+TEST(Compression, HuffmanTrained) {
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::HuffmanTrained> trained;
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::HuffmanFixed> fixed;
+
+	auto message = [](int i) {
+		return "{\"id\":" + std::to_string(i) + ",\"name\":\"entry" + std::to_string(i % 17) + "\",\"valid\":" + ((i % 3) ? "true" : "false") + "}";
+	};
+	clockUtils::compression::algorithm::HuffmanTable table;
+	for (int i = 0; i < 1000; i++) {
+		table.addSample(message(i));
+	}
+	table.train();
+	EXPECT_LT(table.encodedSampleSize(), table.sampleSize() * 8 * 3 / 4);
+
+	// a loaded table produces the same output as the trained one
+	clockUtils::compression::algorithm::HuffmanTable loaded;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, loaded.deserialize(table.serialize()));
+	EXPECT_EQ(table.serialize(), loaded.serialize());
+
+	std::string all;
+	for (int i = 0; i < 256; i++) {
+		all += char(i);
+	}
+	// bytes that didn't occur in the samples can be compressed as well
+	for (const std::string & before : { std::string(), message(1234), message(99999), all, std::string(10000, char(200)) }) {
+		std::string compressed;
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, trained.compress(before, compressed, table));
+		std::string compressedLoaded;
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, trained.compress(before, compressedLoaded, loaded));
+		EXPECT_EQ(compressed, compressedLoaded);
+		std::string after("foo");
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, trained.decompress(compressed, after, loaded));
+		EXPECT_EQ(before, after);
+	}
+
+	// no header like HuffmanFixed, but the codes match the data
+	std::string compressed;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, trained.compress(message(1234), compressed, table));
+	std::string compressedFixed;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, fixed.compress(message(1234), compressedFixed));
+	EXPECT_LT(compressed.length(), compressedFixed.length());
+
+	// a default table uses 8 bits for every byte
+	clockUtils::compression::algorithm::HuffmanTable defaultTable;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, trained.compress(message(1234), compressed, defaultTable));
+	EXPECT_EQ(message(1234).length() + 4 + 1, compressed.length());
+
+	std::string after;
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, trained.decompress("", after, table));
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, trained.decompress(std::string("\0\0\x10\0a", 5), after, table));
+
+	// invalid tables are rejected and don't modify the table
+	const std::string serialized = table.serialize();
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, loaded.deserialize(""));
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, loaded.deserialize(serialized.substr(0, serialized.length() - 1)));
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, loaded.deserialize(serialized + "a"));
+	// not every byte has a code
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, loaded.deserialize(std::string("\0\x02\x11", 3)));
+	// more codes than possible
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, loaded.deserialize(std::string("\x01\0", 2) + std::string(128, char(0x11))));
+	EXPECT_EQ(serialized, loaded.serialize());
+}
+
+TEST(Compression, HuffmanPreset) {
+	typedef clockUtils::compression::algorithm::HuffmanPreset::Preset Preset;
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::HuffmanPreset> preset;
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::HuffmanFixed> fixed;
+
+	std::string binary;
+	std::mt19937 gen(42);
+	for (int i = 0; i < 4096; i++) {
+		binary += char((gen() % 4 == 0) ? 0 : gen() % 256);
+	}
+	std::string random;
+	for (int i = 0; i < 4096; i++) {
+		random += char(gen() % 256);
+	}
+	const std::vector<std::pair<std::string, Preset>> samples = {
+		{ "The quick brown fox jumps over the lazy dog, then it runs back into the forest.", Preset::ENGLISH },
+		{ "{\n    \"id\": 1234,\n    \"name\": \"entry\",\n    \"valid\": true\n}", Preset::MARKUP },
+		{ binary, Preset::BINARY },
+		{ "12.5,-3.75,1000;42\t0.001\n17,18,19,20\n", Preset::NUMERIC },
+		{ random, Preset::STORED },
+		{ "", Preset::STORED }
+	};
+	for (const auto & p : samples) {
+		std::string compressed;
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, preset.compress(p.first, compressed));
+		ASSERT_FALSE(compressed.empty());
+		EXPECT_EQ(uint8_t(p.second), uint8_t(compressed[0]));
+		// storing costs only the id
+		EXPECT_LE(compressed.length(), p.first.length() + 1);
+		std::string after("foo");
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, preset.decompress(compressed, after));
+		EXPECT_EQ(p.first, after);
+	}
+
+	// the english preset uses the dictionary of HuffmanFixed and only costs the id more, for other data the fitting preset is better
+	for (size_t i = 0; i < 4; i++) {
+		std::string compressed;
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, preset.compress(samples[i].first, compressed));
+		std::string compressedFixed;
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, fixed.compress(samples[i].first, compressedFixed));
+		if (samples[i].second == Preset::ENGLISH) {
+			EXPECT_LE(compressed.length(), compressedFixed.length() + 1);
+		} else {
+			EXPECT_LT(compressed.length(), compressedFixed.length());
+		}
+	}
+
+	std::string after;
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, preset.decompress("", after));
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, preset.decompress(std::string(1, char(Preset::COUNT)), after));
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, preset.decompress(std::string("\x01\0\0", 3), after));
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, preset.decompress(std::string("\x02\0\0\x10\0a", 6), after));
+}
+
+namespace {
+
+	template<typename Algorithm, typename... Args>
+	void testBuffers(const std::string & before, Args... args) {
+		clockUtils::compression::Compression<Algorithm> c;
+		std::string compressedString;
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, c.compress(before, compressedString, args...));
+
+		// the buffer interface produces the same result without any string
+		std::vector<char> compressed(c.maxCompressedSize(before.length()));
+		size_t compressedLength = 0;
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, c.compress(before.data(), before.length(), compressed.data(), compressed.size(), compressedLength, args...));
+		ASSERT_EQ(compressedString.length(), compressedLength);
+		EXPECT_EQ(compressedString, std::string(compressed.data(), compressedLength));
+
+		// the decompressed bytes fit exactly into the buffer, there is no space to write behind them
+		std::vector<char> decompressed(before.length() + 1, 'x');
+		size_t decompressedLength = 0;
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, c.decompress(compressed.data(), compressedLength, decompressed.data(), before.length(), decompressedLength, args...));
+		ASSERT_EQ(before.length(), decompressedLength);
+		EXPECT_EQ(before, std::string(decompressed.data(), decompressedLength));
+		EXPECT_EQ('x', decompressed.back());
+
+		if (!before.empty()) {
+			// too small buffers return the required size
+			EXPECT_EQ(clockUtils::ClockError::OUT_OF_MEMORY, c.decompress(compressed.data(), compressedLength, decompressed.data(), before.length() - 1, decompressedLength, args...));
+			EXPECT_EQ(before.length(), decompressedLength);
+			EXPECT_EQ(clockUtils::ClockError::OUT_OF_MEMORY, c.compress(before.data(), before.length(), compressed.data(), compressedLength - 1, compressedLength, args...));
+			EXPECT_GT(compressedLength, compressedString.length() - 1);
+			EXPECT_LE(compressedLength, c.maxCompressedSize(before.length()));
+		}
+	}
+
+	template<typename Algorithm, typename... Args>
+	void testBuffers(Args... args) {
+		std::mt19937 gen(7);
+		std::string random;
+		for (int i = 0; i < 5000; i++) {
+			random += char(gen() % 256);
+		}
+		std::string text;
+		for (int i = 0; i < 5000; i++) {
+			text += "etaoin shrdlu"[gen() % 13];
+		}
+		for (const std::string & before : { std::string(), std::string("a"), std::string(1000, 'b'), text, random, text + random + text }) {
+			testBuffers<Algorithm>(before, args...);
+		}
+	}
+
+} /* namespace */
+
+TEST(Compression, BufferInterface) {
+	testBuffers<clockUtils::compression::algorithm::FSE>();
+	testBuffers<clockUtils::compression::algorithm::HuffmanCanonical>();
+	testBuffers<clockUtils::compression::algorithm::HuffmanContext>();
+	testBuffers<clockUtils::compression::algorithm::HuffmanFixed>();
+	testBuffers<clockUtils::compression::algorithm::HuffmanGeneric>();
+	testBuffers<clockUtils::compression::algorithm::HuffmanInterleaved>();
+	testBuffers<clockUtils::compression::algorithm::HuffmanPreset>();
+	testBuffers<clockUtils::compression::algorithm::LZ77>();
+	testBuffers<clockUtils::compression::algorithm::LZ77Huffman>();
+
+	clockUtils::compression::algorithm::HuffmanTable table;
+	table.addSample("etaoin shrdlu");
+	table.train();
+	testBuffers<clockUtils::compression::algorithm::HuffmanTrained>(std::cref(table));
+
+	// additional parameters of compress
+	clockUtils::compression::Compression<clockUtils::compression::algorithm::LZ77Huffman> c;
+	const std::string before = "blafoo blafoo blafoo";
+	std::string compressedString;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, c.compress(before, compressedString, 1));
+	std::vector<char> compressed(c.maxCompressedSize(before.length()));
+	size_t compressedLength = 0;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, c.compress(before.data(), before.length(), compressed.data(), compressed.size(), compressedLength, 1));
+	EXPECT_EQ(compressedString, std::string(compressed.data(), compressedLength));
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, c.compress(before.data(), before.length(), compressed.data(), compressed.size(), compressedLength, 0));
+}
@@ -0,0 +1,220 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <sstream>
+
+#include "clockUtils/errors.h"
+
+#include "clockUtils/compression/FileCompression.h"
+#include "clockUtils/compression/StreamCompression.h"
+#include "clockUtils/compression/algorithm/HuffmanCanonical.h"
+#include "clockUtils/compression/algorithm/HuffmanTable.h"
+#include "clockUtils/compression/algorithm/HuffmanTrained.h"
+#include "clockUtils/compression/algorithm/LZ77.h"
+#include "clockUtils/compression/algorithm/LZ77Huffman.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+	const std::string INPUT_FILE = "FileCompressionTest.in";
+	const std::string COMPRESSED_FILE = "FileCompressionTest.compressed";
+	const std::string OUTPUT_FILE = "FileCompressionTest.out";
+
+	std::string createText(size_t length) {
+		std::default_random_engine generator;
+		std::uniform_int_distribution<int> distribution(0, 999);
+		std::string text;
+		while (text.length() < length) {
+			text += "line " + std::to_string(distribution(generator)) + " of " + std::to_string(distribution(generator) % 10) + "\n";
+		}
+		text.resize(length);
+		return text;
+	}
+
+	void writeFile(const std::string & file, const std::string & content) {
+		std::ofstream out(file, std::ios::binary);
+		out.write(content.c_str(), std::streamsize(content.length()));
+	}
+
+	std::string readFile(const std::string & file) {
+		std::ifstream in(file, std::ios::binary);
+		std::stringstream ss;
+		ss << in.rdbuf();
+		return ss.str();
+	}
+
+	bool exists(const std::string & file) {
+		return std::ifstream(file).good();
+	}
+
+	template<typename Algorithm, typename... Args>
+	void testRoundTrip(const std::string & before, size_t blockSize, const Args &... args) {
+		writeFile(INPUT_FILE, before);
+
+		// the file has the same format as a stream
+		std::string stream;
+		clockUtils::compression::StreamCompressor<Algorithm> compressor([&stream](const char * data, size_t length) {
+			stream.append(data, length);
+		}, blockSize, args...);
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.write(before));
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.finish());
+
+		for (size_t threads : { 1, 3 }) {
+			clockUtils::compression::FileCompression<Algorithm> compression(threads, blockSize);
+			EXPECT_EQ(clockUtils::ClockError::SUCCESS, compression.compress(INPUT_FILE, COMPRESSED_FILE, args...));
+			EXPECT_EQ(stream, readFile(COMPRESSED_FILE));
+			EXPECT_EQ(clockUtils::ClockError::SUCCESS, compression.decompress(COMPRESSED_FILE, OUTPUT_FILE));
+			EXPECT_EQ(before, readFile(OUTPUT_FILE));
+		}
+		std::remove(INPUT_FILE.c_str());
+		std::remove(COMPRESSED_FILE.c_str());
+		std::remove(OUTPUT_FILE.c_str());
+	}
+
+	/**
+	 * \brief HuffmanCanonical behind a header of HEADER_SIZE bytes, so a frame is a lot larger than its block
+	 */
+	struct LargeHeader {
+		static const size_t HEADER_SIZE = 4096;
+
+		static size_t maxCompressedSize(size_t length) {
+			return HEADER_SIZE + clockUtils::compression::algorithm::HuffmanCanonical::maxCompressedSize(length);
+		}
+
+		static clockUtils::ClockError compress(const std::string & uncompressed, std::string & compressed) {
+			clockUtils::ClockError error = clockUtils::compression::algorithm::HuffmanCanonical::compress(uncompressed, compressed);
+			compressed.insert(0, HEADER_SIZE, 'h');
+			return error;
+		}
+
+		static clockUtils::ClockError decompress(const std::string & compressed, std::string & decompressed) {
+			if (compressed.length() < HEADER_SIZE) {
+				return clockUtils::ClockError::INVALID_ARGUMENT;
+			}
+			return clockUtils::compression::algorithm::HuffmanCanonical::decompress(compressed.substr(HEADER_SIZE), decompressed);
+		}
+
+		static clockUtils::ClockError compress(const void * uncompressed, size_t length, void * compressed, size_t capacity, size_t & compressedLength) {
+			if (capacity < HEADER_SIZE) {
+				compressedLength = maxCompressedSize(length);
+				return clockUtils::ClockError::OUT_OF_MEMORY;
+			}
+			memset(compressed, 'h', HEADER_SIZE);
+			clockUtils::ClockError error = clockUtils::compression::algorithm::HuffmanCanonical::compress(uncompressed, length, static_cast<char *>(compressed) + HEADER_SIZE, capacity - HEADER_SIZE, compressedLength);
+			compressedLength += HEADER_SIZE;
+			return error;
+		}
+
+		static clockUtils::ClockError decompress(const void * compressed, size_t length, void * decompressed, size_t capacity, size_t & decompressedLength) {
+			if (length < HEADER_SIZE) {
+				return clockUtils::ClockError::INVALID_ARGUMENT;
+			}
+			return clockUtils::compression::algorithm::HuffmanCanonical::decompress(static_cast<const char *>(compressed) + HEADER_SIZE, length - HEADER_SIZE, decompressed, capacity, decompressedLength);
+		}
+	};
+
+} /* namespace */
+
+TEST(FileCompression, RoundTrip) {
+	const std::string text = createText(200000);
+	for (size_t blockSize : { 1000, 65536, 1024 * 1024 }) {
+		testRoundTrip<clockUtils::compression::algorithm::HuffmanCanonical>(text, blockSize);
+		testRoundTrip<clockUtils::compression::algorithm::LZ77>(text, blockSize);
+		testRoundTrip<clockUtils::compression::algorithm::LZ77Huffman>(text, blockSize);
+	}
+	testRoundTrip<clockUtils::compression::algorithm::LZ77>(text.substr(0, 5000), 1000);
+	testRoundTrip<clockUtils::compression::algorithm::LZ77>("", 1000);
+	testRoundTrip<clockUtils::compression::algorithm::LZ77>("a", 1000);
+}
+
+TEST(FileCompression, Parameters) {
+	const std::string text = createText(50000);
+	testRoundTrip<clockUtils::compression::algorithm::LZ77Huffman>(text, 4096, clockUtils::compression::algorithm::LZ77Huffman::MAX_LEVEL);
+
+	clockUtils::compression::algorithm::HuffmanTable table;
+	table.addSample(text);
+	table.train();
+	writeFile(INPUT_FILE, text);
+	clockUtils::compression::FileCompression<clockUtils::compression::algorithm::HuffmanTrained> compression(2, 4096);
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compression.compress(INPUT_FILE, COMPRESSED_FILE, std::cref(table)));
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compression.decompress(COMPRESSED_FILE, OUTPUT_FILE, std::cref(table)));
+	EXPECT_EQ(text, readFile(OUTPUT_FILE));
+	std::remove(INPUT_FILE.c_str());
+	std::remove(COMPRESSED_FILE.c_str());
+	std::remove(OUTPUT_FILE.c_str());
+}
+
+TEST(FileCompression, LargeFrames) {
+	// the frames are limited by maxCompressedSize of the algorithm and not by the block size alone
+	const std::string text = createText(1000);
+	testRoundTrip<LargeHeader>(text, 16);
+
+	std::string stream;
+	clockUtils::compression::StreamCompressor<LargeHeader> compressor([&stream](const char * data, size_t length) {
+		stream.append(data, length);
+	}, 16);
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.write(text));
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.finish());
+	std::string after;
+	clockUtils::compression::StreamDecompressor<LargeHeader> decompressor([&after](const char * data, size_t length) {
+		after.append(data, length);
+	});
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, decompressor.write(stream));
+	EXPECT_TRUE(decompressor.finished());
+	EXPECT_EQ(text, after);
+}
+
+TEST(FileCompression, InvalidInput) {
+	clockUtils::compression::FileCompression<clockUtils::compression::algorithm::LZ77> compression(2, 1000);
+	EXPECT_EQ(clockUtils::ClockError::FILENOTFOUND, compression.compress("FileCompressionTest.missing", OUTPUT_FILE));
+	EXPECT_FALSE(exists(OUTPUT_FILE));
+
+	const std::string text = createText(10000);
+	writeFile(INPUT_FILE, text);
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compression.compress(INPUT_FILE, INPUT_FILE));
+	// another path to the input must not truncate it either
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compression.compress(INPUT_FILE, "./" + INPUT_FILE));
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compression.decompress(INPUT_FILE, "./" + INPUT_FILE));
+	EXPECT_EQ(text, readFile(INPUT_FILE));
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compression.compress(INPUT_FILE, COMPRESSED_FILE));
+	const std::string compressed = readFile(COMPRESSED_FILE);
+
+	// broken files are rejected and the output is removed again
+	for (const std::string & broken : { compressed.substr(0, 3), compressed.substr(0, compressed.length() - 1), compressed.substr(0, compressed.length() / 2), compressed + "a", std::string("\0\0\0\0", 4) }) {
+		writeFile(COMPRESSED_FILE, broken);
+		EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compression.decompress(COMPRESSED_FILE, OUTPUT_FILE));
+		EXPECT_FALSE(exists(OUTPUT_FILE));
+	}
+
+	// a stream with a smaller block size than its blocks
+	std::string smallBlocks = compressed;
+	smallBlocks[2] = 0;
+	smallBlocks[3] = 100;
+	writeFile(COMPRESSED_FILE, smallBlocks);
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compression.decompress(COMPRESSED_FILE, OUTPUT_FILE));
+
+	std::remove(INPUT_FILE.c_str());
+	std::remove(COMPRESSED_FILE.c_str());
+}
@@ -0,0 +1,127 @@
+/*
+ * clockUtils
+ * Copyright (2015) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <random>
+
+#include "clockUtils/errors.h"
+
+#include "clockUtils/compression/ParallelCompression.h"
+#include "clockUtils/compression/algorithm/HuffmanCanonical.h"
+#include "clockUtils/compression/algorithm/HuffmanFixed.h"
+#include "clockUtils/compression/algorithm/HuffmanGeneric.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+	std::string createText(size_t length) {
+		std::default_random_engine generator;
+		std::discrete_distribution<int> distribution({ 30, 20, 10, 10, 5, 5, 2, 1 });
+		const char letters[] = "etaoin s";
+		std::string text;
+		for (size_t i = 0; i < length; i++) {
+			text += letters[distribution(generator)];
+		}
+		return text;
+	}
+
+	template<typename Algorithm>
+	void testRoundTrip(const std::string & before, size_t blockSize) {
+		clockUtils::compression::ParallelCompression<Algorithm> single(1, blockSize);
+		std::string compressedSingle;
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, single.compress(before, compressedSingle));
+
+		for (size_t threads : { 2, 4, 7 }) {
+			clockUtils::compression::ParallelCompression<Algorithm> parallel(threads, blockSize);
+			std::string compressed;
+			EXPECT_EQ(clockUtils::ClockError::SUCCESS, parallel.compress(before, compressed));
+			// the output must not depend on the amount of threads
+			EXPECT_EQ(compressedSingle, compressed);
+			std::string after;
+			EXPECT_EQ(clockUtils::ClockError::SUCCESS, parallel.decompress(compressed, after));
+			EXPECT_EQ(before, after);
+		}
+		std::string after;
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, single.decompress(compressedSingle, after));
+		EXPECT_EQ(before, after);
+	}
+
+} /* namespace */
+
+TEST(ParallelCompression, RoundTrip) {
+	const std::string text = createText(300000);
+	for (size_t blockSize : { 1000, 65536, 100000, 1024 * 1024 }) {
+		testRoundTrip<clockUtils::compression::algorithm::HuffmanCanonical>(text, blockSize);
+		testRoundTrip<clockUtils::compression::algorithm::HuffmanFixed>(text, blockSize);
+		testRoundTrip<clockUtils::compression::algorithm::HuffmanGeneric>(text, blockSize);
+	}
+	testRoundTrip<clockUtils::compression::algorithm::HuffmanGeneric>("", 1000);
+	testRoundTrip<clockUtils::compression::algorithm::HuffmanGeneric>("a", 1000);
+}
+
+TEST(ParallelCompression, BlockIndex) {
+	const std::string text = createText(2500);
+	clockUtils::compression::ParallelCompression<clockUtils::compression::algorithm::HuffmanCanonical> compression(2, 1000);
+	std::string compressed;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compression.compress(text, compressed));
+
+	// block size, length and one index entry per block
+	EXPECT_EQ(std::string("\0\0\x03\xE8\0\0\0\0\0\0\x09\xC4", 12), compressed.substr(0, 12));
+	size_t offset = 24;
+	for (size_t i = 0; i < 3; i++) {
+		const size_t size = (uint8_t(compressed[12 + 4 * i]) << 24) | (uint8_t(compressed[13 + 4 * i]) << 16) | (uint8_t(compressed[14 + 4 * i]) << 8) | uint8_t(compressed[15 + 4 * i]);
+		std::string block;
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, clockUtils::compression::algorithm::HuffmanCanonical::decompress(compressed.substr(offset, size), block));
+		EXPECT_EQ(text.substr(i * 1000, 1000), block);
+		offset += size;
+	}
+	EXPECT_EQ(compressed.length(), offset);
+}
+
+TEST(ParallelCompression, InvalidInput) {
+	const std::string text = createText(5000);
+	clockUtils::compression::ParallelCompression<clockUtils::compression::algorithm::HuffmanGeneric> compression(4, 1000);
+	std::string compressed;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compression.compress(text, compressed));
+
+	std::string after;
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compression.decompress(compressed.substr(0, 11), after));
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compression.decompress(compressed.substr(0, compressed.length() - 1), after));
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compression.decompress(compressed + "a", after));
+
+	// length too large for the index
+	std::string wrongLength = compressed;
+	wrongLength[4] = 0x7F;
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compression.decompress(wrongLength, after));
+
+	// a block of another algorithm
+	clockUtils::compression::ParallelCompression<clockUtils::compression::algorithm::HuffmanCanonical> canonical(4, 1000);
+	EXPECT_NE(clockUtils::ClockError::SUCCESS, canonical.decompress(compressed, after));
+
+	// random data must not crash
+	std::default_random_engine generator;
+	std::uniform_int_distribution<int> distribution(0, 255);
+	for (int i = 0; i < 1000; i++) {
+		std::string garbage = compressed.substr(0, 12 + 20);
+		for (int j = 0; j < 40; j++) {
+			garbage[12 + (distribution(generator) % 20)] = char(distribution(generator));
+		}
+		compression.decompress(garbage, after);
+	}
+}
@@ -0,0 +1,186 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <functional>
+#include <random>
+
+#include "clockUtils/errors.h"
+
+#include "clockUtils/compression/SeekableCompression.h"
+#include "clockUtils/compression/algorithm/FSE.h"
+#include "clockUtils/compression/algorithm/HuffmanCanonical.h"
+#include "clockUtils/compression/algorithm/HuffmanFixed.h"
+#include "clockUtils/compression/algorithm/HuffmanGeneric.h"
+#include "clockUtils/compression/algorithm/HuffmanInterleaved.h"
+#include "clockUtils/compression/algorithm/HuffmanPreset.h"
+#include "clockUtils/compression/algorithm/HuffmanTable.h"
+#include "clockUtils/compression/algorithm/HuffmanTrained.h"
+#include "clockUtils/compression/algorithm/LZ77.h"
+#include "clockUtils/compression/algorithm/LZ77Huffman.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+	std::string createLog(size_t length) {
+		std::default_random_engine generator;
+		std::uniform_int_distribution<int> distribution(0, 999);
+		const char * levels[] = { "INFO", "WARN", "ERROR" };
+		std::string text;
+		while (text.length() < length) {
+			text += std::string(levels[distribution(generator) % 3]) + " request " + std::to_string(distribution(generator)) + " took " + std::to_string(distribution(generator)) + "ms\n";
+		}
+		text.resize(length);
+		return text;
+	}
+
+	template<typename Algorithm, typename... Args>
+	void testRanges(const std::string & before, size_t blockSize, const Args &... args) {
+		clockUtils::compression::SeekableCompression<Algorithm> compression(blockSize);
+		std::string compressed;
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, compression.compress(before, compressed, args...));
+
+		uint64_t length = 0;
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, compression.uncompressedLength(compressed, length));
+		EXPECT_EQ(before.length(), length);
+
+		std::string after;
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, compression.decompress(compressed, after, args...));
+		EXPECT_EQ(before, after);
+
+		std::default_random_engine generator;
+		for (int i = 0; i < 50; i++) {
+			const size_t offset = before.empty() ? 0 : generator() % before.length();
+			const size_t rangeLength = before.empty() ? 0 : generator() % (before.length() - offset + 1);
+			std::string range;
+			EXPECT_EQ(clockUtils::ClockError::SUCCESS, compression.decompressRange(compressed, offset, rangeLength, range, args...));
+			EXPECT_EQ(before.substr(offset, rangeLength), range);
+		}
+	}
+
+} /* namespace */
+
+TEST(SeekableCompression, Ranges) {
+	const std::string text = createLog(50000);
+	for (size_t blockSize : { 1000, 4096, 65536 }) {
+		testRanges<clockUtils::compression::algorithm::FSE>(text, blockSize);
+		testRanges<clockUtils::compression::algorithm::HuffmanCanonical>(text, blockSize);
+		testRanges<clockUtils::compression::algorithm::HuffmanFixed>(text, blockSize);
+		testRanges<clockUtils::compression::algorithm::HuffmanGeneric>(text, blockSize);
+		testRanges<clockUtils::compression::algorithm::HuffmanInterleaved>(text, blockSize);
+		testRanges<clockUtils::compression::algorithm::HuffmanPreset>(text, blockSize);
+		testRanges<clockUtils::compression::algorithm::LZ77>(text, blockSize);
+		testRanges<clockUtils::compression::algorithm::LZ77Huffman>(text, blockSize);
+	}
+	clockUtils::compression::algorithm::HuffmanTable table;
+	table.addSample(text);
+	table.train();
+	testRanges<clockUtils::compression::algorithm::HuffmanTrained>(text, 1000, std::cref(table));
+	testRanges<clockUtils::compression::algorithm::LZ77>("", 1000);
+	testRanges<clockUtils::compression::algorithm::LZ77>("a", 1000);
+}
+
+TEST(SeekableCompression, Parameters) {
+	const std::string text = createLog(20000);
+	clockUtils::compression::SeekableCompression<clockUtils::compression::algorithm::LZ77Huffman> compression(4096);
+	std::string fast;
+	std::string best;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compression.compress(text, fast, clockUtils::compression::algorithm::LZ77Huffman::MIN_LEVEL));
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compression.compress(text, best, clockUtils::compression::algorithm::LZ77Huffman::MAX_LEVEL));
+	EXPECT_LE(best.length(), fast.length());
+	std::string range;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compression.decompressRange(fast, 5000, 3000, range));
+	EXPECT_EQ(text.substr(5000, 3000), range);
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compression.decompressRange(best, 5000, 3000, range));
+	EXPECT_EQ(text.substr(5000, 3000), range);
+}
+
+TEST(SeekableCompression, BlockIndex) {
+	const std::string text = createLog(2500);
+	clockUtils::compression::SeekableCompression<clockUtils::compression::algorithm::HuffmanCanonical> compression(1000);
+	std::string compressed;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compression.compress(text, compressed));
+
+	// number of blocks and length at the end, preceded by one index entry per block
+	EXPECT_EQ(std::string("\0\0\0\x03\0\0\0\0\0\0\x09\xC4", 12), compressed.substr(compressed.length() - 12));
+	const size_t index = compressed.length() - 12 - 3 * 20;
+	size_t offset = 0;
+	for (size_t i = 0; i < 3; i++) {
+		const std::string entry = compressed.substr(index + 20 * i, 20);
+		EXPECT_EQ(std::string("\0\0\0\0\0\0", 6), entry.substr(0, 6));
+		EXPECT_EQ(i * 1000, (uint8_t(entry[6]) << 8) | uint8_t(entry[7]));
+		EXPECT_EQ(std::string(6, '\0'), entry.substr(8, 6));
+		EXPECT_EQ(offset, (uint8_t(entry[14]) << 8) | uint8_t(entry[15]));
+		const size_t size = (uint8_t(entry[16]) << 24) | (uint8_t(entry[17]) << 16) | (uint8_t(entry[18]) << 8) | uint8_t(entry[19]);
+		std::string block;
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, clockUtils::compression::algorithm::HuffmanCanonical::decompress(compressed.substr(offset, size), block));
+		EXPECT_EQ(text.substr(i * 1000, 1000), block);
+		offset += size;
+	}
+	EXPECT_EQ(index, offset);
+
+	// only the needed blocks are decoded, so a broken first block doesn't matter for a range in the last one
+	std::string broken = compressed;
+	broken[0] = char(0xFF);
+	std::string range;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compression.decompressRange(broken, 2100, 300, range));
+	EXPECT_EQ(text.substr(2100, 300), range);
+	EXPECT_NE(clockUtils::ClockError::SUCCESS, compression.decompressRange(broken, 900, 300, range));
+}
+
+TEST(SeekableCompression, InvalidInput) {
+	const std::string text = createLog(5000);
+	clockUtils::compression::SeekableCompression<clockUtils::compression::algorithm::HuffmanGeneric> compression(1000);
+	std::string compressed;
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compression.compress(text, compressed));
+
+	std::string after;
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compression.decompress(compressed.substr(0, 11), after));
+	EXPECT_NE(clockUtils::ClockError::SUCCESS, compression.decompress(compressed.substr(1), after));
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compression.decompress(compressed + "a", after));
+
+	// ranges exceeding the string
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compression.decompressRange(compressed, 4000, 1001, after));
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compression.decompressRange(compressed, 5001, 0, after));
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compression.decompressRange(compressed, 1, UINT64_MAX, after));
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compression.decompressRange(compressed, 5000, 0, after));
+	EXPECT_TRUE(after.empty());
+
+	// more blocks than fit into the string
+	std::string wrongBlocks = compressed;
+	wrongBlocks[wrongBlocks.length() - 10] = 0x7F;
+	EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compression.decompress(wrongBlocks, after));
+
+	// a block of another algorithm
+	clockUtils::compression::SeekableCompression<clockUtils::compression::algorithm::HuffmanCanonical> canonical(1000);
+	EXPECT_NE(clockUtils::ClockError::SUCCESS, canonical.decompress(compressed, after));
+
+	// random indices must not crash
+	std::default_random_engine generator;
+	std::uniform_int_distribution<int> distribution(0, 255);
+	const size_t index = compressed.length() - 12 - 5 * 20;
+	for (int i = 0; i < 1000; i++) {
+		std::string garbage = compressed;
+		for (int j = 0; j < 4; j++) {
+			garbage[index + (size_t(distribution(generator)) % 100)] = char(distribution(generator));
+		}
+		compression.decompress(garbage, after);
+		compression.decompressRange(garbage, 1500, 2000, after);
+	}
+}
@@ -0,0 +1,244 @@
+/*
+ * clockUtils
+ * Copyright (2015) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <functional>
+#include <random>
+
+#include "clockUtils/errors.h"
+
+#include "clockUtils/compression/StreamCompression.h"
+#include "clockUtils/compression/algorithm/FSE.h"
+#include "clockUtils/compression/algorithm/HuffmanCanonical.h"
+#include "clockUtils/compression/algorithm/HuffmanFixed.h"
+#include "clockUtils/compression/algorithm/HuffmanGeneric.h"
+#include "clockUtils/compression/algorithm/HuffmanTable.h"
+#include "clockUtils/compression/algorithm/HuffmanTrained.h"
+#include "clockUtils/compression/algorithm/LZ77Huffman.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+	std::string createText(size_t length) {
+		std::default_random_engine generator;
+		std::discrete_distribution<int> distribution({ 30, 20, 10, 10, 5, 5, 2, 1 });
+		const char letters[] = "etaoin s";
+		std::string text;
+		for (size_t i = 0; i < length; i++) {
+			text += letters[distribution(generator)];
+		}
+		return text;
+	}
+
+	template<typename Algorithm>
+	void testRoundTrip(const std::string & before, size_t blockSize, size_t chunkSize) {
+		std::string compressed;
+		clockUtils::compression::StreamCompressor<Algorithm> compressor([&compressed](const char * data, size_t length) {
+			compressed.append(data, length);
+		}, blockSize);
+		for (size_t i = 0; i < before.length(); i += chunkSize) {
+			EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.write(before.c_str() + i, std::min(chunkSize, before.length() - i)));
+		}
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.finish());
+		EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compressor.write("a", 1));
+		EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, compressor.finish());
+
+		std::string after;
+		size_t largestOutput = 0;
+		clockUtils::compression::StreamDecompressor<Algorithm> decompressor([&after, &largestOutput](const char * data, size_t length) {
+			after.append(data, length);
+			largestOutput = std::max(largestOutput, length);
+		});
+		for (size_t i = 0; i < compressed.length(); i += chunkSize) {
+			EXPECT_FALSE(decompressor.finished());
+			EXPECT_EQ(clockUtils::ClockError::SUCCESS, decompressor.write(compressed.c_str() + i, std::min(chunkSize, compressed.length() - i)));
+		}
+		EXPECT_TRUE(decompressor.finished());
+		EXPECT_EQ(before, after);
+		EXPECT_LE(largestOutput, blockSize);
+	}
+
+} /* namespace */
+
+TEST(StreamCompression, RoundTrip) {
+	const std::string text = createText(100000);
+	for (size_t blockSize : { 1000, 65536, 200000 }) {
+		for (size_t chunkSize : { 1, 3, 4096, 100000 }) {
+			testRoundTrip<clockUtils::compression::algorithm::HuffmanCanonical>(text, blockSize, chunkSize);
+			testRoundTrip<clockUtils::compression::algorithm::HuffmanFixed>(text, blockSize, chunkSize);
+			testRoundTrip<clockUtils::compression::algorithm::HuffmanGeneric>(text, blockSize, chunkSize);
+		}
+	}
+	// tiny blocks
+	const std::string shortText = text.substr(0, 1000);
+	for (size_t blockSize : { 1, 7 }) {
+		for (size_t chunkSize : { 1, 3, 1000 }) {
+			testRoundTrip<clockUtils::compression::algorithm::HuffmanCanonical>(shortText, blockSize, chunkSize);
+			testRoundTrip<clockUtils::compression::algorithm::HuffmanFixed>(shortText, blockSize, chunkSize);
+			testRoundTrip<clockUtils::compression::algorithm::HuffmanGeneric>(shortText, blockSize, chunkSize);
+		}
+	}
+}
+
+TEST(StreamCompression, EmptyStream) {
+	testRoundTrip<clockUtils::compression::algorithm::HuffmanCanonical>("", 1000, 1);
+	testRoundTrip<clockUtils::compression::algorithm::HuffmanFixed>("", 1000, 1);
+	testRoundTrip<clockUtils::compression::algorithm::HuffmanGeneric>("", 1000, 1);
+
+	// block size and end frame
+	std::string compressed;
+	clockUtils::compression::StreamCompressor<clockUtils::compression::algorithm::HuffmanCanonical> compressor([&compressed](const char * data, size_t length) {
+		compressed.append(data, length);
+	}, 1000);
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.finish());
+	EXPECT_EQ(std::string("\0\0\x03\xE8\0\0\0\0", 8), compressed);
+}
+
+TEST(StreamCompression, ProgressiveOutput) {
+	const std::string text = createText(10000);
+	std::string compressed;
+	clockUtils::compression::StreamCompressor<clockUtils::compression::algorithm::HuffmanCanonical> compressor([&compressed](const char * data, size_t length) {
+		compressed.append(data, length);
+	}, 1000);
+
+	// nothing but the header is written before the first block is full
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.write(text.substr(0, 999)));
+	EXPECT_EQ(4u, compressed.length());
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.write(text.substr(999, 1)));
+	EXPECT_LT(4u, compressed.length());
+	const size_t firstFrame = compressed.length();
+
+	// the first block can be decoded before the stream is finished
+	std::string after;
+	clockUtils::compression::StreamDecompressor<clockUtils::compression::algorithm::HuffmanCanonical> decompressor([&after](const char * data, size_t length) {
+		after.append(data, length);
+	});
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, decompressor.write(compressed.substr(0, firstFrame - 1)));
+	EXPECT_TRUE(after.empty());
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, decompressor.write(compressed.substr(firstFrame - 1)));
+	EXPECT_EQ(text.substr(0, 1000), after);
+	EXPECT_FALSE(decompressor.finished());
+}
+
+TEST(StreamCompression, InvalidStreams) {
+	const std::string text = createText(5000);
+	std::string compressed;
+	clockUtils::compression::StreamCompressor<clockUtils::compression::algorithm::HuffmanGeneric> compressor([&compressed](const char * data, size_t length) {
+		compressed.append(data, length);
+	}, 1000);
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.write(text));
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.finish());
+
+	std::string after;
+	auto sink = [&after](const char * data, size_t length) {
+		after.append(data, length);
+	};
+
+	{
+		// data after the end of the stream
+		clockUtils::compression::StreamDecompressor<clockUtils::compression::algorithm::HuffmanGeneric> decompressor(sink);
+		EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, decompressor.write(compressed + "a"));
+		EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, decompressor.write("a"));
+	}
+	{
+		// block size above the limit of the decompressor
+		clockUtils::compression::StreamDecompressor<clockUtils::compression::algorithm::HuffmanGeneric> decompressor(sink, 999);
+		EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, decompressor.write(compressed));
+	}
+	{
+		// frame larger than possible for the block size
+		clockUtils::compression::StreamDecompressor<clockUtils::compression::algorithm::HuffmanGeneric> decompressor(sink);
+		EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, decompressor.write(std::string("\0\0\0\x10\x7F\0\0\0", 8)));
+	}
+	{
+		// block decompressing to more than the block size
+		std::string big;
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, clockUtils::compression::algorithm::HuffmanGeneric::compress(text.substr(0, 1001), big));
+		std::string stream("\0\0\x03\xE8", 4);
+		char size[4];
+		clockUtils::compression::stream::writeSize(uint32_t(big.length()), size);
+		stream.append(size, 4);
+		stream += big;
+		clockUtils::compression::StreamDecompressor<clockUtils::compression::algorithm::HuffmanGeneric> decompressor(sink);
+		EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, decompressor.write(stream));
+	}
+	{
+		// a tiny frame declaring a huge block is rejected before the block is decoded
+		std::string huge;
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, clockUtils::compression::algorithm::FSE::compress(std::string(10 * 1024 * 1024, 'a'), huge));
+		std::string stream("\0\0\0\x10", 4);
+		char size[4];
+		clockUtils::compression::stream::writeSize(uint32_t(huge.length()), size);
+		stream.append(size, 4);
+		stream += huge;
+		after.clear();
+		clockUtils::compression::StreamDecompressor<clockUtils::compression::algorithm::FSE> decompressor(sink);
+		EXPECT_EQ(clockUtils::ClockError::INVALID_ARGUMENT, decompressor.write(stream));
+		EXPECT_TRUE(after.empty());
+	}
+	{
+		// stream compressed with a different algorithm
+		clockUtils::compression::StreamDecompressor<clockUtils::compression::algorithm::HuffmanCanonical> decompressor(sink);
+		EXPECT_NE(clockUtils::ClockError::SUCCESS, decompressor.write(compressed));
+	}
+}
+
+TEST(StreamCompression, Parameters) {
+	const std::string text = createText(20000);
+	clockUtils::compression::algorithm::HuffmanTable table;
+	table.addSample(text);
+	table.train();
+
+	std::string compressed;
+	clockUtils::compression::StreamCompressor<clockUtils::compression::algorithm::HuffmanTrained> compressor([&compressed](const char * data, size_t length) {
+		compressed.append(data, length);
+	}, 1000, std::cref(table));
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.write(text));
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, compressor.finish());
+	std::string after;
+	clockUtils::compression::StreamDecompressor<clockUtils::compression::algorithm::HuffmanTrained> decompressor([&after](const char * data, size_t length) {
+		after.append(data, length);
+	}, clockUtils::compression::StreamCompressor<clockUtils::compression::algorithm::HuffmanTrained>::MAX_BLOCK_SIZE, std::cref(table));
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, decompressor.write(compressed));
+	EXPECT_TRUE(decompressor.finished());
+	EXPECT_EQ(text, after);
+
+	// the level is used for every block
+	std::string fast;
+	std::string best;
+	clockUtils::compression::StreamCompressor<clockUtils::compression::algorithm::LZ77Huffman> fastCompressor([&fast](const char * data, size_t length) {
+		fast.append(data, length);
+	}, 4096, clockUtils::compression::algorithm::LZ77Huffman::MIN_LEVEL);
+	clockUtils::compression::StreamCompressor<clockUtils::compression::algorithm::LZ77Huffman> bestCompressor([&best](const char * data, size_t length) {
+		best.append(data, length);
+	}, 4096, clockUtils::compression::algorithm::LZ77Huffman::MAX_LEVEL);
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, fastCompressor.write(text));
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, fastCompressor.finish());
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, bestCompressor.write(text));
+	EXPECT_EQ(clockUtils::ClockError::SUCCESS, bestCompressor.finish());
+	EXPECT_NE(fast, best);
+	for (const std::string & stream : { fast, best }) {
+		after.clear();
+		clockUtils::compression::StreamDecompressor<clockUtils::compression::algorithm::LZ77Huffman> lzDecompressor([&after](const char * data, size_t length) {
+			after.append(data, length);
+		});
+		EXPECT_EQ(clockUtils::ClockError::SUCCESS, lzDecompressor.write(stream));
+		EXPECT_EQ(text, after);
+	}
+}
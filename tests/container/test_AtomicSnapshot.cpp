@@ -0,0 +1,137 @@
+/*
+ * clockUtils
+ * Copyright (2015) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "clockUtils/container/AtomicSnapshot.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using clockUtils::ClockError;
+using clockUtils::container::AtomicSnapshot;
+
+namespace {
+
+	std::atomic<int> instances(0);
+
+	struct Table {
+		Table() : values(16, 0) {
+			instances++;
+		}
+		explicit Table(int v) : values(16, v) {
+			instances++;
+		}
+		Table(const Table & other) : values(other.values) {
+			instances++;
+		}
+		~Table() {
+			instances--;
+		}
+		std::vector<int> values;
+	};
+
+} /* namespace */
+
+TEST(AtomicSnapshot, Simple) {
+	AtomicSnapshot<int> s(5);
+	size_t id = 0;
+	EXPECT_EQ(ClockError::SUCCESS, s.registerReader(id));
+	EXPECT_EQ(5, *s.get());
+	s.update(7);
+	EXPECT_EQ(7, *s.get());
+	s.unregisterReader(id);
+}
+
+TEST(AtomicSnapshot, MaxReaders) {
+	AtomicSnapshot<int, 2> s;
+	size_t a = 0, b = 0, c = 0;
+	EXPECT_EQ(ClockError::SUCCESS, s.registerReader(a));
+	EXPECT_EQ(ClockError::SUCCESS, s.registerReader(b));
+	EXPECT_NE(a, b);
+	EXPECT_EQ(ClockError::NO_SPACE_AVAILABLE, s.registerReader(c));
+	s.unregisterReader(a);
+	EXPECT_EQ(ClockError::SUCCESS, s.registerReader(c));
+	EXPECT_EQ(a, c);
+}
+
+TEST(AtomicSnapshot, Reclaim) {
+	{
+		AtomicSnapshot<Table> s;
+		EXPECT_EQ(1, instances);
+		size_t id = 0;
+		EXPECT_EQ(ClockError::SUCCESS, s.registerReader(id));
+		const Table * t = s.get();
+		s.update(Table(1));
+		// reader may still use t
+		EXPECT_EQ(2, instances);
+		EXPECT_EQ(0, t->values[0]);
+		EXPECT_EQ(1, s.reclaim());
+		s.quiescent(id);
+		EXPECT_EQ(0, s.reclaim());
+		EXPECT_EQ(1, instances);
+		EXPECT_EQ(1, s.get()->values[0]);
+		s.unregisterReader(id);
+		// no readers at all, old snapshot is deleted immediately
+		s.update(Table(2));
+		EXPECT_EQ(1, instances);
+	}
+	EXPECT_EQ(0, instances);
+}
+
+TEST(AtomicSnapshot, StressTest) {
+	const int READERS = 4;
+	const int UPDATES = 2000;
+
+	{
+		AtomicSnapshot<Table> s;
+		std::atomic<bool> running(true);
+		std::atomic<int> inconsistent(0);
+		std::vector<std::thread> readers;
+		for (int i = 0; i < READERS; ++i) {
+			readers.push_back(std::thread([&]() {
+				size_t id = 0;
+				EXPECT_EQ(ClockError::SUCCESS, s.registerReader(id));
+				while (running) {
+					const Table * t = s.get();
+					for (int v : t->values) {
+						if (v != t->values[0]) {
+							inconsistent++;
+						}
+					}
+					s.quiescent(id);
+				}
+				s.unregisterReader(id);
+			}));
+		}
+		for (int i = 1; i <= UPDATES; ++i) {
+			s.update(Table(i));
+		}
+		s.synchronize();
+		EXPECT_EQ(1, instances);
+		running = false;
+		for (std::thread & t : readers) {
+			t.join();
+		}
+		EXPECT_EQ(0, inconsistent);
+		EXPECT_EQ(UPDATES, s.get()->values[0]);
+	}
+	EXPECT_EQ(0, instances);
+}
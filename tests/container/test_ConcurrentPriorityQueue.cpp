@@ -0,0 +1,140 @@
+/*
+ * clockUtils
+ * Copyright (2015) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "clockUtils/container/ConcurrentPriorityQueue.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using clockUtils::ClockError;
+using clockUtils::container::ConcurrentPriorityQueue;
+
+TEST(ConcurrentPriorityQueue, Simple) {
+	ConcurrentPriorityQueue<int> q;
+	EXPECT_TRUE(q.empty());
+	EXPECT_EQ(0, q.size());
+	int value;
+	EXPECT_EQ(ClockError::NO_ELEMENT, q.tryPopMin(value));
+}
+
+TEST(ConcurrentPriorityQueue, ExactOrder) {
+	// a single heap gives an exact priority queue
+	ConcurrentPriorityQueue<int> q(1, 1);
+	const int values[] = { 5, 3, 9, 1, 7, 3, 0, 8 };
+	for (int v : values) {
+		q.push(v);
+	}
+	EXPECT_EQ(8, q.size());
+	std::vector<int> sorted(std::begin(values), std::end(values));
+	std::sort(sorted.begin(), sorted.end());
+	for (int expected : sorted) {
+		int value;
+		EXPECT_EQ(ClockError::SUCCESS, q.tryPopMin(value));
+		EXPECT_EQ(expected, value);
+	}
+	EXPECT_TRUE(q.empty());
+}
+
+TEST(ConcurrentPriorityQueue, Compare) {
+	ConcurrentPriorityQueue<int, std::greater<int>> q(1, 1);
+	for (int i = 0; i < 10; ++i) {
+		q.push(i);
+	}
+	int value;
+	EXPECT_EQ(ClockError::SUCCESS, q.tryPopMin(value));
+	EXPECT_EQ(9, value);
+	q.clear();
+	EXPECT_TRUE(q.empty());
+}
+
+TEST(ConcurrentPriorityQueue, Relaxed) {
+	ConcurrentPriorityQueue<int> q(2, 4);
+	const int AMOUNT = 1000;
+	for (int i = 0; i < AMOUNT; ++i) {
+		q.push(AMOUNT - 1 - i);
+	}
+	// every element is returned exactly once and the first elements are among the smallest ones
+	std::vector<int> popped;
+	int value;
+	while (q.tryPopMin(value) == ClockError::SUCCESS) {
+		popped.push_back(value);
+	}
+	ASSERT_EQ(AMOUNT, popped.size());
+	EXPECT_LT(popped[0], AMOUNT / 4);
+	std::sort(popped.begin(), popped.end());
+	for (int i = 0; i < AMOUNT; ++i) {
+		EXPECT_EQ(i, popped[size_t(i)]);
+	}
+}
+
+TEST(ConcurrentPriorityQueue, BulkPop) {
+	ConcurrentPriorityQueue<int> q(2, 2);
+	for (int i = 0; i < 100; ++i) {
+		q.push(i);
+	}
+	std::vector<int> values;
+	EXPECT_EQ(10, q.tryPopMin(values, 10));
+	EXPECT_EQ(10, values.size());
+	EXPECT_EQ(90, q.size());
+	EXPECT_EQ(90, q.tryPopMin(values, 1000));
+	EXPECT_TRUE(q.empty());
+	std::sort(values.begin(), values.end());
+	for (int i = 0; i < 100; ++i) {
+		EXPECT_EQ(i, values[size_t(i)]);
+	}
+}
+
+TEST(ConcurrentPriorityQueue, StressTest) {
+	const int THREADS = 8;
+	const int AMOUNT = 10000;
+
+	ConcurrentPriorityQueue<int> q;
+	std::vector<std::thread> v;
+	std::vector<std::vector<int>> results(THREADS);
+	for (int i = 0; i < THREADS; ++i) {
+		v.push_back(std::thread([&q, &results, i]() {
+			for (int j = 0; j < AMOUNT; ++j) {
+				q.push(i * AMOUNT + j);
+				int value;
+				if (q.tryPopMin(value) == ClockError::SUCCESS) {
+					results[size_t(i)].push_back(value);
+				}
+			}
+		}));
+	}
+	for (std::thread & t : v) {
+		t.join();
+	}
+	std::vector<int> all;
+	for (std::vector<int> & r : results) {
+		all.insert(all.end(), r.begin(), r.end());
+	}
+	int value;
+	while (q.tryPopMin(value) == ClockError::SUCCESS) {
+		all.push_back(value);
+	}
+	ASSERT_EQ(THREADS * AMOUNT, all.size());
+	std::sort(all.begin(), all.end());
+	for (int i = 0; i < THREADS * AMOUNT; ++i) {
+		EXPECT_EQ(i, all[size_t(i)]);
+	}
+}
@@ -18,6 +18,7 @@
  */
 
 #include "clockUtils/container/DoubleBufferQueue.h"
+#include "clockUtils/container/Locks.h"
 
 #include <thread>
 
@@ -203,3 +204,69 @@ TEST(DoubleBufferQueue, StressTest2) {
 	EXPECT_TRUE(q1.empty());
 	EXPECT_TRUE(q2.empty());
 }
+
+template<typename Lock>
+void lockPusher(DoubleBufferQueue<int, true, true, Lock> * q, int amount, int value) {
+	for (int i = 0; i < amount; ++i) {
+		q->push(value);
+	}
+}
+
+template<typename Lock>
+void lockPopper(DoubleBufferQueue<int, true, true, Lock> * qFrom, DoubleBufferQueue<int, true, false, Lock> * qTo, int amount) {
+	for (int i = 0; i < amount; ++i) {
+		int a;
+		if (qFrom->poll(a) == ClockError::SUCCESS) {
+			qTo->push(a);
+		} else {
+			i--;
+		}
+	}
+}
+
+template<typename Lock>
+void lockStressTest() {
+	const int PUSH_THREADS = 4;
+	const int AMOUNT = 20000;
+
+	DoubleBufferQueue<int, true, true, Lock> q1;
+	DoubleBufferQueue<int, true, false, Lock> q2;
+	std::vector<std::thread *> v;
+	for (int i = 0; i < PUSH_THREADS; ++i) {
+		v.push_back(new std::thread(std::bind(lockPusher<Lock>, &q1, AMOUNT, i)));
+	}
+	for (int i = 0; i < PUSH_THREADS * 2; ++i) {
+		v.push_back(new std::thread(std::bind(lockPopper<Lock>, &q1, &q2, AMOUNT / 2)));
+	}
+	std::vector<int> counts(PUSH_THREADS);
+	for (unsigned int i = 0; i < v.size(); ++i) {
+		v[i]->join();
+		delete v[i];
+	}
+	for (int i = 0; i < PUSH_THREADS * AMOUNT; ++i) {
+		int a = 0;
+		EXPECT_EQ(ClockError::SUCCESS, q2.poll(a));
+		counts[size_t(a)]++;
+	}
+	for (int i = 0; i < PUSH_THREADS; ++i) {
+		EXPECT_EQ(AMOUNT, counts[i]);
+	}
+	EXPECT_TRUE(q1.empty());
+	EXPECT_TRUE(q2.empty());
+}
+
+TEST(DoubleBufferQueue, StressTestSpinLock) {
+	lockStressTest<clockUtils::container::SpinLock>();
+}
+
+TEST(DoubleBufferQueue, StressTestTicketLock) {
+	lockStressTest<clockUtils::container::TicketLock>();
+}
+
+TEST(DoubleBufferQueue, StressTestMCSLock) {
+	lockStressTest<clockUtils::container::MCSLock>();
+}
+
+TEST(DoubleBufferQueue, StressTestAdaptiveLock) {
+	lockStressTest<clockUtils::container::AdaptiveLock<>>();
+}
@@ -0,0 +1,122 @@
+/*
+ * clockUtils
+ * Copyright (2015) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "clockUtils/container/FlatHashMap.h"
+
+#include <random>
+#include <string>
+#include <unordered_map>
+
+#include "gtest/gtest.h"
+
+using clockUtils::container::FlatHashMap;
+
+TEST(FlatHashMap, InsertFindErase) {
+	FlatHashMap<int, int> m;
+	EXPECT_TRUE(m.empty());
+	EXPECT_TRUE(m.find(1) == m.end());
+	for (int i = 0; i < 1000; i++) {
+		EXPECT_TRUE(m.insert(std::make_pair(i, i * 2)).second);
+	}
+	EXPECT_FALSE(m.insert(std::make_pair(5, 0)).second);
+	EXPECT_EQ(1000, m.size());
+	for (int i = 0; i < 1000; i++) {
+		auto it = m.find(i);
+		ASSERT_TRUE(it != m.end());
+		EXPECT_EQ(i * 2, it->second);
+	}
+	EXPECT_TRUE(m.find(1000) == m.end());
+	for (int i = 0; i < 1000; i += 2) {
+		EXPECT_EQ(1, m.erase(i));
+	}
+	EXPECT_EQ(0, m.erase(0));
+	EXPECT_EQ(500, m.size());
+	for (int i = 0; i < 1000; i++) {
+		EXPECT_EQ(size_t(i % 2), m.count(i));
+	}
+	size_t counter = 0;
+	for (auto & p : m) {
+		EXPECT_EQ(1, p.first % 2);
+		counter++;
+	}
+	EXPECT_EQ(500, counter);
+	m.clear();
+	EXPECT_TRUE(m.empty());
+	EXPECT_TRUE(m.begin() == m.end());
+}
+
+TEST(FlatHashMap, Reserve) {
+	FlatHashMap<int, int> m;
+	m.reserve(1000);
+	const size_t capacity = m.capacity();
+	EXPECT_GE(capacity * 7 / 8, 1000);
+	for (int i = 0; i < 1000; i++) {
+		m[i] = i;
+	}
+	EXPECT_EQ(capacity, m.capacity());
+}
+
+TEST(FlatHashMap, StringKeys) {
+	FlatHashMap<std::string, int, clockUtils::container::StringHash, clockUtils::container::StringEqual> m = { { "one", 1 }, { "two", 2 } };
+	m.emplace("three", 3);
+	EXPECT_EQ(3, m.size());
+	const char * key = "two";
+	EXPECT_EQ(2, m.find(key)->second);
+	EXPECT_EQ(3, m.find(std::string("three"))->second);
+	EXPECT_EQ(0, m.count("four"));
+	m["one"] = 11;
+	EXPECT_EQ(11, m.find("one")->second);
+}
+
+TEST(FlatHashMap, CopyAndMove) {
+	FlatHashMap<int, std::string> m;
+	for (int i = 0; i < 100; i++) {
+		m[i] = std::to_string(i);
+	}
+	FlatHashMap<int, std::string> copy(m);
+	EXPECT_EQ(100, copy.size());
+	EXPECT_EQ("42", copy.find(42)->second);
+	FlatHashMap<int, std::string> moved(std::move(m));
+	EXPECT_EQ(100, moved.size());
+	EXPECT_TRUE(m.empty());
+	m = copy;
+	EXPECT_EQ("99", m.find(99)->second);
+}
+
+TEST(FlatHashMap, CompareWithUnorderedMap) {
+	std::mt19937 gen(42);
+	std::uniform_int_distribution<int> dist(0, 9999);
+	FlatHashMap<int, int> m;
+	std::unordered_map<int, int> reference;
+	for (int i = 0; i < 100000; i++) {
+		const int key = dist(gen);
+		if (i % 3 == 0) {
+			EXPECT_EQ(reference.erase(key), m.erase(key));
+		} else {
+			m[key] = i;
+			reference[key] = i;
+		}
+	}
+	ASSERT_EQ(reference.size(), m.size());
+	for (const auto & p : reference) {
+		auto it = m.find(p.first);
+		ASSERT_TRUE(it != m.end());
+		EXPECT_EQ(p.second, it->second);
+	}
+}
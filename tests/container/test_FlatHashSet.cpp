@@ -0,0 +1,57 @@
+/*
+ * clockUtils
+ * Copyright (2015) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "clockUtils/container/FlatHashSet.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+using clockUtils::container::FlatHashSet;
+
+TEST(FlatHashSet, InsertFindErase) {
+	FlatHashSet<std::string> s = { "a", "b", "c" };
+	EXPECT_EQ(3, s.size());
+	EXPECT_FALSE(s.insert("a").second);
+	EXPECT_TRUE(s.insert("d").second);
+	EXPECT_EQ(1, s.count("d"));
+	EXPECT_EQ(1, s.erase("a"));
+	EXPECT_EQ(0, s.count("a"));
+	size_t counter = 0;
+	for (const std::string & value : s) {
+		EXPECT_EQ(1, value.size());
+		counter++;
+	}
+	EXPECT_EQ(3, counter);
+}
+
+TEST(FlatHashSet, ManyDeletes) {
+	FlatHashSet<int> s;
+	// repeated inserts and erases fill the table with deleted slots which have to be cleaned up
+	for (int round = 0; round < 100; round++) {
+		for (int i = 0; i < 100; i++) {
+			EXPECT_TRUE(s.insert(round * 100 + i).second);
+		}
+		for (int i = 0; i < 100; i++) {
+			EXPECT_EQ(1, s.erase(round * 100 + i));
+		}
+	}
+	EXPECT_TRUE(s.empty());
+	EXPECT_LE(s.capacity(), 512);
+}
@@ -0,0 +1,120 @@
+/*
+ * clockUtils
+ * Copyright (2015) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "clockUtils/container/FlatMap.h"
+
+#include <cstring>
+#include <map>
+#include <random>
+#include <string>
+
+#include "gtest/gtest.h"
+
+using clockUtils::container::FlatMap;
+
+namespace {
+
+	struct StringLess {
+		typedef void is_transparent;
+
+		bool operator()(const std::string & a, const std::string & b) const {
+			return a < b;
+		}
+		bool operator()(const std::string & a, const char * b) const {
+			return strcmp(a.c_str(), b) < 0;
+		}
+		bool operator()(const char * a, const std::string & b) const {
+			return strcmp(a, b.c_str()) < 0;
+		}
+	};
+
+} /* namespace */
+
+TEST(FlatMap, InsertFind) {
+	FlatMap<int, int> m;
+	EXPECT_TRUE(m.empty());
+	EXPECT_TRUE(m.insert(std::make_pair(3, 30)).second);
+	EXPECT_TRUE(m.insert(std::make_pair(1, 10)).second);
+	EXPECT_TRUE(m.insert(std::make_pair(2, 20)).second);
+	EXPECT_FALSE(m.insert(std::make_pair(2, 21)).second);
+	EXPECT_EQ(3, m.size());
+	EXPECT_EQ(20, m.find(2)->second);
+	EXPECT_TRUE(m.find(4) == m.end());
+	EXPECT_EQ(1, m.count(1));
+	EXPECT_EQ(0, m.count(0));
+
+	int expected = 1;
+	for (const auto & p : m) {
+		EXPECT_EQ(expected, p.first);
+		EXPECT_EQ(expected * 10, p.second);
+		expected++;
+	}
+
+	m[5] = 50;
+	EXPECT_EQ(0, m[4]);
+	EXPECT_EQ(5, m.size());
+	EXPECT_EQ(4, m.lower_bound(4)->first);
+	EXPECT_EQ(5, m.upper_bound(4)->first);
+
+	EXPECT_EQ(1, m.erase(4));
+	EXPECT_EQ(0, m.erase(4));
+	EXPECT_EQ(4, m.size());
+	m.clear();
+	EXPECT_TRUE(m.empty());
+}
+
+TEST(FlatMap, BulkConstruction) {
+	FlatMap<int, int> m({ { 5, 1 }, { 2, 2 }, { 5, 3 }, { 1, 4 } });
+	ASSERT_EQ(3, m.size());
+	EXPECT_EQ(1, m.begin()->first);
+	EXPECT_EQ(1, m[5]);
+}
+
+TEST(FlatMap, HeterogeneousLookup) {
+	FlatMap<std::string, int, StringLess> m;
+	m["alpha"] = 1;
+	m["beta"] = 2;
+	const char * key = "beta";
+	EXPECT_EQ(2, m.find(key)->second);
+	EXPECT_EQ(0, m.count("gamma"));
+	EXPECT_EQ("beta", m.lower_bound("b")->first);
+}
+
+TEST(FlatMap, CompareWithStdMap) {
+	std::mt19937 gen(42);
+	std::uniform_int_distribution<int> dist(0, 999);
+	FlatMap<int, int> m;
+	std::map<int, int> reference;
+	for (int i = 0; i < 10000; i++) {
+		const int key = dist(gen);
+		if (i % 3 == 0) {
+			EXPECT_EQ(reference.erase(key), m.erase(key));
+		} else {
+			m[key] = i;
+			reference[key] = i;
+		}
+	}
+	ASSERT_EQ(reference.size(), m.size());
+	auto it = m.begin();
+	for (const auto & p : reference) {
+		EXPECT_EQ(p.first, it->first);
+		EXPECT_EQ(p.second, it->second);
+		++it;
+	}
+}
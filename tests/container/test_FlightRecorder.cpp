@@ -0,0 +1,123 @@
+/*
+ * clockUtils
+ * Copyright (2015) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "clockUtils/container/FlightRecorder.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using clockUtils::container::FlightRecorder;
+
+namespace {
+
+	struct Event {
+		uint32_t thread;
+		uint32_t counter;
+		uint64_t check;
+	};
+
+} /* namespace */
+
+TEST(FlightRecorder, Simple) {
+	FlightRecorder<int, 8> recorder;
+	std::vector<FlightRecorder<int, 8>::Entry> entries;
+	EXPECT_EQ(0, recorder.snapshot(entries));
+	EXPECT_TRUE(entries.empty());
+
+	for (int i = 0; i < 5; i++) {
+		recorder.record(i);
+	}
+	EXPECT_EQ(0, recorder.snapshot(entries));
+	ASSERT_EQ(5, entries.size());
+	for (int i = 0; i < 5; i++) {
+		EXPECT_EQ(uint64_t(i), entries[i].sequence);
+		EXPECT_EQ(i, entries[i].value);
+	}
+	EXPECT_EQ(0, recorder.dropped());
+}
+
+TEST(FlightRecorder, Overwrite) {
+	FlightRecorder<int, 8> recorder;
+	for (int i = 0; i < 21; i++) {
+		recorder.record(i);
+	}
+	EXPECT_EQ(21, recorder.recorded());
+	std::vector<FlightRecorder<int, 8>::Entry> entries;
+	EXPECT_EQ(0, recorder.snapshot(entries));
+	ASSERT_EQ(8, entries.size());
+	for (int i = 0; i < 8; i++) {
+		EXPECT_EQ(uint64_t(13 + i), entries[i].sequence);
+		EXPECT_EQ(13 + i, entries[i].value);
+	}
+	// overwritten entries aren't dropped
+	EXPECT_EQ(0, recorder.dropped());
+}
+
+TEST(FlightRecorder, ConcurrentWritersAndReader) {
+	const uint32_t THREADS = 4;
+	const uint32_t EVENTS = 100000;
+	FlightRecorder<Event, 64> recorder;
+	std::atomic<bool> running(true);
+
+	std::thread reader([&]() {
+		std::vector<FlightRecorder<Event, 64>::Entry> entries;
+		while (running) {
+			recorder.snapshot(entries);
+			uint64_t lastSequence = 0;
+			for (size_t i = 0; i < entries.size(); i++) {
+				// entries are never mixed
+				EXPECT_EQ(~((uint64_t(entries[i].value.thread) << 32) | entries[i].value.counter), entries[i].value.check);
+				if (i > 0) {
+					EXPECT_LT(lastSequence, entries[i].sequence);
+				}
+				lastSequence = entries[i].sequence;
+			}
+		}
+	});
+
+	std::vector<std::thread> writers;
+	for (uint32_t t = 0; t < THREADS; t++) {
+		writers.push_back(std::thread([&recorder, t]() {
+			for (uint32_t i = 0; i < EVENTS; i++) {
+				Event e = { t, i, ~((uint64_t(t) << 32) | i) };
+				recorder.record(e);
+			}
+		}));
+	}
+	for (std::thread & t : writers) {
+		t.join();
+	}
+	running = false;
+	reader.join();
+
+	EXPECT_EQ(THREADS * EVENTS, recorder.recorded());
+	std::vector<FlightRecorder<Event, 64>::Entry> entries;
+	const size_t skipped = recorder.snapshot(entries);
+	EXPECT_EQ(64, entries.size() + skipped);
+	EXPECT_LT(skipped, 64);
+	// without active writers only torn slots are skipped and every torn slot lost at least one entry
+	EXPECT_LE(skipped, recorder.dropped());
+	// the last event of every thread is among the newest entries unless it was dropped
+	for (const FlightRecorder<Event, 64>::Entry & entry : entries) {
+		EXPECT_GE(entry.sequence, THREADS * EVENTS - 64);
+	}
+}
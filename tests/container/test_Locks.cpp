@@ -0,0 +1,105 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "clockUtils/container/Locks.h"
+
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using clockUtils::container::AdaptiveLock;
+using clockUtils::container::MCSLock;
+using clockUtils::container::SpinLock;
+using clockUtils::container::TicketLock;
+
+template<typename Lock>
+void incrementer(Lock * lock, uint64_t * counter, int amount) {
+	for (int i = 0; i < amount; ++i) {
+		std::lock_guard<Lock> lg(*lock);
+		(*counter)++;
+	}
+}
+
+template<typename Lock>
+void mutualExclusion() {
+	const int THREADS = 8;
+	const int AMOUNT = 20000;
+
+	Lock lock;
+	uint64_t counter = 0;
+	std::vector<std::thread *> v;
+	for (int i = 0; i < THREADS; ++i) {
+		v.push_back(new std::thread(std::bind(incrementer<Lock>, &lock, &counter, AMOUNT)));
+	}
+	for (unsigned int i = 0; i < v.size(); ++i) {
+		v[i]->join();
+		delete v[i];
+	}
+	EXPECT_EQ(uint64_t(THREADS * AMOUNT), counter);
+}
+
+template<typename Lock>
+void tryLock() {
+	Lock lock;
+	EXPECT_TRUE(lock.try_lock());
+	EXPECT_FALSE(lock.try_lock());
+	lock.unlock();
+	EXPECT_TRUE(lock.try_lock());
+	lock.unlock();
+	lock.lock();
+	EXPECT_FALSE(lock.try_lock());
+	lock.unlock();
+}
+
+TEST(Locks, SpinLock) {
+	tryLock<SpinLock>();
+	mutualExclusion<SpinLock>();
+}
+
+TEST(Locks, TicketLock) {
+	tryLock<TicketLock>();
+	mutualExclusion<TicketLock>();
+}
+
+TEST(Locks, MCSLock) {
+	tryLock<MCSLock>();
+	mutualExclusion<MCSLock>();
+}
+
+TEST(Locks, MCSLockNested) {
+	MCSLock a;
+	MCSLock b;
+	for (int i = 0; i < 100; ++i) {
+		std::lock_guard<MCSLock> lgA(a);
+		std::lock_guard<MCSLock> lgB(b);
+		EXPECT_FALSE(a.try_lock());
+		EXPECT_FALSE(b.try_lock());
+	}
+	EXPECT_TRUE(a.try_lock());
+	a.unlock();
+}
+
+TEST(Locks, AdaptiveLock) {
+	tryLock<AdaptiveLock<>>();
+	mutualExclusion<AdaptiveLock<>>();
+	// no spinning at all, every contended lock parks the thread
+	mutualExclusion<AdaptiveLock<0>>();
+}
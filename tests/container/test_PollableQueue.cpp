@@ -0,0 +1,142 @@
+/*
+ * clockUtils
+ * Copyright (2015) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "clockUtils/container/PollableQueue.h"
+
+#if CLOCKUTILS_PLATFORM == CLOCKUTILS_PLATFORM_LINUX
+
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+
+#include "gtest/gtest.h"
+
+using clockUtils::ClockError;
+using clockUtils::container::PollableQueue;
+
+namespace {
+
+	bool readable(int fd, int timeout) {
+		pollfd pfd;
+		pfd.fd = fd;
+		pfd.events = POLLIN;
+		pfd.revents = 0;
+		return ::poll(&pfd, 1, timeout) == 1 && (pfd.revents & POLLIN);
+	}
+
+} /* namespace */
+
+TEST(PollableQueue, Simple) {
+	PollableQueue<int, 10> q;
+	EXPECT_NE(-1, q.getFileDescriptor());
+	EXPECT_TRUE(q.empty());
+	EXPECT_EQ(0, q.size());
+	EXPECT_FALSE(readable(q.getFileDescriptor(), 0));
+}
+
+TEST(PollableQueue, Signaling) {
+	PollableQueue<int, 10> q;
+	int value;
+	for (int i = 0; i < 5; ++i) {
+		EXPECT_FALSE(readable(q.getFileDescriptor(), 0));
+		EXPECT_EQ(ClockError::SUCCESS, q.push(1));
+		EXPECT_EQ(ClockError::SUCCESS, q.push(2));
+		EXPECT_TRUE(readable(q.getFileDescriptor(), 0));
+		EXPECT_EQ(ClockError::SUCCESS, q.front(value));
+		EXPECT_EQ(1, value);
+		EXPECT_EQ(ClockError::SUCCESS, q.poll(value));
+		EXPECT_EQ(1, value);
+		// not re-armed until the queue was found empty
+		EXPECT_TRUE(readable(q.getFileDescriptor(), 0));
+		EXPECT_EQ(ClockError::SUCCESS, q.pop());
+		EXPECT_EQ(ClockError::NO_ELEMENT, q.poll(value));
+	}
+	EXPECT_FALSE(readable(q.getFileDescriptor(), 0));
+}
+
+TEST(PollableQueue, ProducerConsumer) {
+	const int PUSH_THREADS = 4;
+	const int AMOUNT = 10000;
+
+	PollableQueue<int, 1024> q;
+	std::vector<std::thread> v;
+	for (int i = 0; i < PUSH_THREADS; ++i) {
+		v.push_back(std::thread([&q, i]() {
+			for (int j = 0; j < AMOUNT; ++j) {
+				while (q.push(i) != ClockError::SUCCESS) {
+					std::this_thread::yield();
+				}
+			}
+		}));
+	}
+	std::vector<int> counts(PUSH_THREADS);
+	int received = 0;
+	while (received < PUSH_THREADS * AMOUNT) {
+		// a lost wakeup would block here until the timeout
+		ASSERT_TRUE(readable(q.getFileDescriptor(), 5000));
+		int value;
+		while (q.poll(value) == ClockError::SUCCESS) {
+			counts[size_t(value)]++;
+			received++;
+		}
+	}
+	for (std::thread & t : v) {
+		t.join();
+	}
+	for (int i = 0; i < PUSH_THREADS; ++i) {
+		EXPECT_EQ(AMOUNT, counts[i]);
+	}
+	EXPECT_TRUE(q.empty());
+}
+
+TEST(PollableQueue, NoReadableWhenEmpty) {
+	const int AMOUNT = 200000;
+
+	PollableQueue<int, 1024> q;
+	std::thread producer([&q]() {
+		for (int j = 0; j < AMOUNT; ++j) {
+			while (q.push(j) != ClockError::SUCCESS) {
+				std::this_thread::yield();
+			}
+		}
+	});
+	int received = 0;
+	int stuck = 0;
+	int value;
+	while (received < AMOUNT) {
+		readable(q.getFileDescriptor(), 0);
+		while (q.poll(value) == ClockError::SUCCESS) {
+			received++;
+		}
+		// the first empty poll may leave a late write of a producer behind, after the second one every signal belongs to an element still in the queue
+		if (q.poll(value) == ClockError::SUCCESS) {
+			received++;
+		} else if (readable(q.getFileDescriptor(), 0) && q.empty()) {
+			stuck++;
+		}
+	}
+	producer.join();
+	EXPECT_EQ(0, stuck);
+	EXPECT_EQ(ClockError::NO_ELEMENT, q.poll(value));
+	EXPECT_TRUE(q.empty());
+	EXPECT_FALSE(readable(q.getFileDescriptor(), 0));
+}
+
+#endif /* CLOCKUTILS_PLATFORM == CLOCKUTILS_PLATFORM_LINUX */
@@ -0,0 +1,177 @@
+/*
+ * clockUtils
+ * Copyright (2015) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "clockUtils/container/QueueSet.h"
+
+#include <thread>
+#include <vector>
+
+#include "clockUtils/container/DoubleBufferQueue.h"
+#include "clockUtils/container/LockFreeQueue.h"
+
+#include "gtest/gtest.h"
+
+using clockUtils::ClockError;
+using clockUtils::container::DoubleBufferQueue;
+using clockUtils::container::LockFreeQueue;
+using clockUtils::container::QueueSet;
+using clockUtils::container::QueueSetPolicy;
+
+TEST(QueueSet, Simple) {
+	QueueSet<int> s;
+	LockFreeQueue<int, 10> q1;
+	DoubleBufferQueue<int, true, true> q2;
+	EXPECT_EQ(0, s.addQueue(q1));
+	EXPECT_EQ(1, s.addQueue(q2));
+	EXPECT_EQ(2, s.queueCount());
+	EXPECT_TRUE(s.empty());
+	int value;
+	size_t index;
+	EXPECT_EQ(ClockError::NO_ELEMENT, s.poll(value, index));
+	EXPECT_EQ(ClockError::INVALID_ARGUMENT, s.push(2, 1));
+	EXPECT_EQ(ClockError::SUCCESS, s.push(1, 5));
+	EXPECT_FALSE(s.empty());
+	EXPECT_EQ(1, q2.size());
+	EXPECT_EQ(ClockError::SUCCESS, s.poll(value, index));
+	EXPECT_EQ(5, value);
+	EXPECT_EQ(1, index);
+	EXPECT_TRUE(s.empty());
+}
+
+TEST(QueueSet, Priority) {
+	QueueSet<int, QueueSetPolicy::PRIORITY> s;
+	LockFreeQueue<int, 10> high;
+	DoubleBufferQueue<int, true, true> low;
+	s.addQueue(high);
+	s.addQueue(low);
+	for (int i = 0; i < 3; ++i) {
+		low.push(10 + i);
+		EXPECT_EQ(ClockError::SUCCESS, high.push(i));
+	}
+	int value;
+	size_t index;
+	for (int i = 0; i < 3; ++i) {
+		EXPECT_EQ(ClockError::SUCCESS, s.poll(value, index));
+		EXPECT_EQ(0, index);
+		EXPECT_EQ(i, value);
+	}
+	for (int i = 0; i < 3; ++i) {
+		EXPECT_EQ(ClockError::SUCCESS, s.poll(value, index));
+		EXPECT_EQ(1, index);
+		EXPECT_EQ(10 + i, value);
+	}
+	EXPECT_EQ(ClockError::NO_ELEMENT, s.poll(value, index));
+}
+
+TEST(QueueSet, WeightedRoundRobin) {
+	QueueSet<int, QueueSetPolicy::WEIGHTED_ROUND_ROBIN> s;
+	LockFreeQueue<int, 10> a;
+	LockFreeQueue<int, 10> b;
+	s.addQueue(a, 2);
+	s.addQueue(b, 1);
+	for (int i = 0; i < 4; ++i) {
+		EXPECT_EQ(ClockError::SUCCESS, a.push(i));
+		EXPECT_EQ(ClockError::SUCCESS, b.push(10 + i));
+	}
+	const size_t expectedIndex[] = { 0, 0, 1, 0, 0, 1, 1, 1 };
+	int value;
+	size_t index;
+	for (size_t expected : expectedIndex) {
+		EXPECT_EQ(ClockError::SUCCESS, s.poll(value, index));
+		EXPECT_EQ(expected, index);
+	}
+	EXPECT_EQ(ClockError::NO_ELEMENT, s.poll(value, index));
+}
+
+TEST(QueueSet, Timeout) {
+	QueueSet<int> s;
+	LockFreeQueue<int, 10> q;
+	s.addQueue(q);
+	int value;
+	size_t index;
+	EXPECT_EQ(ClockError::TIMEOUT, s.selectPoll(value, index, std::chrono::milliseconds(10)));
+	EXPECT_EQ(ClockError::SUCCESS, s.push(0, 3));
+	EXPECT_EQ(ClockError::SUCCESS, s.selectPoll(value, index, std::chrono::milliseconds(10)));
+	EXPECT_EQ(3, value);
+}
+
+TEST(QueueSet, Blocking) {
+	QueueSet<int> s;
+	LockFreeQueue<int, 10> q1;
+	DoubleBufferQueue<int, true, true> q2;
+	s.addQueue(q1);
+	s.addQueue(q2);
+	std::thread t([&s, &q2]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		q2.push(42);
+		s.notify();
+	});
+	int value = 0;
+	size_t index = 0;
+	EXPECT_EQ(ClockError::SUCCESS, s.selectPoll(value, index));
+	EXPECT_EQ(42, value);
+	EXPECT_EQ(1, index);
+	t.join();
+}
+
+TEST(QueueSet, StressTest) {
+	const int PUSH_THREADS = 4;
+	const int POLL_THREADS = 4;
+	const int AMOUNT = 10000;
+
+	QueueSet<int, QueueSetPolicy::WEIGHTED_ROUND_ROBIN> s;
+	LockFreeQueue<int, 256> q1;
+	DoubleBufferQueue<int, true, true> q2;
+	s.addQueue(q1, 3);
+	s.addQueue(q2, 1);
+	DoubleBufferQueue<int, true, true> results;
+	std::vector<std::thread> v;
+	for (int i = 0; i < PUSH_THREADS; ++i) {
+		v.push_back(std::thread([&s, i]() {
+			for (int j = 0; j < AMOUNT; ++j) {
+				while (s.push(size_t(i % 2), i) != ClockError::SUCCESS) {
+					std::this_thread::yield();
+				}
+			}
+		}));
+	}
+	for (int i = 0; i < POLL_THREADS; ++i) {
+		v.push_back(std::thread([&s, &results]() {
+			for (int j = 0; j < AMOUNT; ++j) {
+				int value;
+				size_t index;
+				EXPECT_EQ(ClockError::SUCCESS, s.selectPoll(value, index));
+				EXPECT_EQ(size_t(value % 2), index);
+				results.push(value);
+			}
+		}));
+	}
+	for (std::thread & t : v) {
+		t.join();
+	}
+	std::vector<int> counts(PUSH_THREADS);
+	int value;
+	while (results.poll(value) == ClockError::SUCCESS) {
+		counts[size_t(value)]++;
+	}
+	for (int i = 0; i < PUSH_THREADS; ++i) {
+		EXPECT_EQ(AMOUNT, counts[i]);
+	}
+	EXPECT_TRUE(s.empty());
+}
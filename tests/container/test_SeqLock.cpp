@@ -0,0 +1,122 @@
+/*
+ * clockUtils
+ * Copyright (2015) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "clockUtils/container/SeqLock.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using clockUtils::container::SeqLock;
+
+namespace {
+
+	struct Triple {
+		uint64_t a;
+		uint64_t b;
+		uint32_t c;
+	};
+
+	/**
+	 * \brief trivially copyable, but without default constructor
+	 */
+	struct Point {
+		Point(int32_t px, int32_t py) : x(px), y(py) {
+		}
+
+		int32_t x;
+		int32_t y;
+	};
+
+} /* namespace */
+
+TEST(SeqLock, Simple) {
+	SeqLock<int> s;
+	EXPECT_EQ(0, s.load());
+	EXPECT_EQ(0, s.version());
+	s.store(42);
+	EXPECT_EQ(42, s.load());
+	EXPECT_EQ(1, s.version());
+	int value = 0;
+	EXPECT_TRUE(s.tryLoad(value));
+	EXPECT_EQ(42, value);
+}
+
+TEST(SeqLock, Struct) {
+	Triple t = { 1, 2, 3 };
+	SeqLock<Triple> s(t);
+	Triple r = s.load();
+	EXPECT_EQ(1, r.a);
+	EXPECT_EQ(2, r.b);
+	EXPECT_EQ(3, r.c);
+}
+
+TEST(SeqLock, NotDefaultConstructible) {
+	SeqLock<Point> s(Point(1, 2));
+	Point p = s.load();
+	EXPECT_EQ(1, p.x);
+	EXPECT_EQ(2, p.y);
+	s.store(Point(3, 4));
+	p = s.load();
+	EXPECT_EQ(3, p.x);
+	EXPECT_EQ(4, p.y);
+	EXPECT_TRUE(s.tryLoad(p));
+	EXPECT_EQ(3, p.x);
+}
+
+TEST(SeqLock, StressTest) {
+	const int WRITERS = 2;
+	const int READERS = 4;
+	const uint32_t AMOUNT = 20000;
+
+	SeqLock<Triple> s;
+	std::atomic<bool> running(true);
+	std::atomic<int> torn(0);
+	std::vector<std::thread> writers;
+	std::vector<std::thread> readers;
+	for (int i = 0; i < READERS; ++i) {
+		readers.push_back(std::thread([&]() {
+			while (running) {
+				Triple t = s.load();
+				if (t.a != t.b || t.a != t.c) {
+					torn++;
+				}
+			}
+		}));
+	}
+	for (int i = 0; i < WRITERS; ++i) {
+		writers.push_back(std::thread([&]() {
+			for (uint32_t j = 0; j < AMOUNT; ++j) {
+				Triple t = { j, j, j };
+				s.store(t);
+			}
+		}));
+	}
+	for (std::thread & t : writers) {
+		t.join();
+	}
+	running = false;
+	for (std::thread & t : readers) {
+		t.join();
+	}
+	EXPECT_EQ(0, torn);
+	EXPECT_EQ(WRITERS * AMOUNT, s.version());
+}
@@ -0,0 +1,127 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * compresses or decompresses a file with FileCompression
+ * usage: clockUtils_compress [--decompress] [--algorithm name] [--level level] [--threads count] [--blockSize bytes] input output
+ * the algorithm isn't stored in the file, so the same one has to be used for decompression
+ */
+
+#include <iostream>
+#include <string>
+
+#include "clockUtils/errors.h"
+#include "clockUtils/argParser/ArgumentParser.h"
+#include "clockUtils/compression/FileCompression.h"
+#include "clockUtils/compression/algorithm/FSE.h"
+#include "clockUtils/compression/algorithm/HuffmanCanonical.h"
+#include "clockUtils/compression/algorithm/HuffmanContext.h"
+#include "clockUtils/compression/algorithm/HuffmanFixed.h"
+#include "clockUtils/compression/algorithm/HuffmanGeneric.h"
+#include "clockUtils/compression/algorithm/HuffmanInterleaved.h"
+#include "clockUtils/compression/algorithm/HuffmanPreset.h"
+#include "clockUtils/compression/algorithm/LZ77.h"
+#include "clockUtils/compression/algorithm/LZ77Huffman.h"
+
+namespace {
+
+	template<typename Algorithm, typename... Args>
+	clockUtils::ClockError run(bool decompress, const std::string & input, const std::string & output, size_t threads, size_t blockSize, const Args &... args) {
+		clockUtils::compression::FileCompression<Algorithm> compression(threads, blockSize);
+		return decompress ? compression.decompress(input, output) : compression.compress(input, output, args...);
+	}
+
+	const char * errorText(clockUtils::ClockError error) {
+		switch (error) {
+		case clockUtils::ClockError::FILENOTFOUND: {
+			return "can't open input or output file";
+		}
+		case clockUtils::ClockError::INVALID_ARGUMENT: {
+			return "invalid input or the output file is the input file";
+		}
+		case clockUtils::ClockError::OUT_OF_MEMORY: {
+			return "out of memory";
+		}
+		default: {
+			return "writing output failed";
+		}
+		}
+	}
+
+} /* namespace */
+
+int main(int argc, char ** argv) {
+	REGISTER_VARIABLE(bool, decompress, d, false, "decompresses input instead of compressing it");
+	REGISTER_VARIABLE(std::string, algorithm, a, "lz77huffman", "algorithm to use: fse, huffmanCanonical, huffmanContext, huffmanFixed, huffmanGeneric, huffmanInterleaved, huffmanPreset, lz77 or lz77huffman");
+	REGISTER_VARIABLE(int, level, l, 6, "effort level of lz77huffman between 1 and 9");
+	REGISTER_VARIABLE(int, threads, t, 1, "amount of threads, 0 uses one thread per core");
+	REGISTER_VARIABLE(int, blockSize, b, 262144, "size of the independently compressed blocks");
+	REGISTER_VARIABLE_ARGUMENTS(files);
+
+	if (PARSE_COMMANDLINE() != clockUtils::ClockError::SUCCESS) {
+		std::cerr << GETLASTPARSERERROR() << std::endl;
+		return 1;
+	}
+	if (HELPSET()) {
+		std::cout << "usage: clockUtils_compress [options] input output" << std::endl << GETHELPTEXT() << std::endl;
+		return 0;
+	}
+	if (files.size() != 2) {
+		std::cerr << "expected an input and an output file" << std::endl;
+		return 1;
+	}
+	if (threads < 0 || blockSize <= 0) {
+		std::cerr << "threads must not be negative and blockSize has to be positive" << std::endl;
+		return 1;
+	}
+
+	const bool d = decompress;
+	const std::string name = algorithm;
+	const size_t t = size_t(int(threads));
+	const size_t b = size_t(int(blockSize));
+	clockUtils::ClockError error;
+	if (name == "fse") {
+		error = run<clockUtils::compression::algorithm::FSE>(d, files[0], files[1], t, b);
+	} else if (name == "huffmanCanonical") {
+		error = run<clockUtils::compression::algorithm::HuffmanCanonical>(d, files[0], files[1], t, b);
+	} else if (name == "huffmanContext") {
+		error = run<clockUtils::compression::algorithm::HuffmanContext>(d, files[0], files[1], t, b);
+	} else if (name == "huffmanFixed") {
+		error = run<clockUtils::compression::algorithm::HuffmanFixed>(d, files[0], files[1], t, b);
+	} else if (name == "huffmanGeneric") {
+		error = run<clockUtils::compression::algorithm::HuffmanGeneric>(d, files[0], files[1], t, b);
+	} else if (name == "huffmanInterleaved") {
+		error = run<clockUtils::compression::algorithm::HuffmanInterleaved>(d, files[0], files[1], t, b);
+	} else if (name == "huffmanPreset") {
+		error = run<clockUtils::compression::algorithm::HuffmanPreset>(d, files[0], files[1], t, b);
+	} else if (name == "lz77") {
+		error = run<clockUtils::compression::algorithm::LZ77>(d, files[0], files[1], t, b);
+	} else if (name == "lz77huffman") {
+		error = run<clockUtils::compression::algorithm::LZ77Huffman>(d, files[0], files[1], t, b, int(level));
+	} else {
+		std::cerr << "unknown algorithm " << name << std::endl;
+		return 1;
+	}
+
+	if (error != clockUtils::ClockError::SUCCESS) {
+		std::cerr << errorText(error) << std::endl;
+		return 1;
+	}
+	return 0;
+}
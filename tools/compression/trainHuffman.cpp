@@ -0,0 +1,118 @@
+/*
+ * clockUtils
+ * Copyright (2016) Michael Baer, Daniel Bonrath, All rights reserved.
+ *
+ * This file is part of clockUtils; clockUtils is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * trains a HuffmanTable from sample files
+ * usage: clockUtils_trainHuffman [--output file] [--header name] samples...
+ * the table is written as binary file that can be loaded with HuffmanTable::deserialize or as C++ header containing it as byte array
+ */
+
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "clockUtils/errors.h"
+#include "clockUtils/argParser/ArgumentParser.h"
+#include "clockUtils/compression/algorithm/HuffmanTable.h"
+
+namespace {
+
+	/**
+	 * \brief size of the chunks the samples are read in, so large files don't need to fit into memory
+	 */
+	const size_t CHUNK_SIZE = 1024 * 1024;
+
+	bool addFile(const std::string & file, clockUtils::compression::algorithm::HuffmanTable & table) {
+		std::ifstream in(file, std::ios::binary);
+		if (!in.good()) {
+			return false;
+		}
+		std::string chunk(CHUNK_SIZE, '\0');
+		while (in.read(&chunk[0], std::streamsize(chunk.size())) || in.gcount() > 0) {
+			table.addSample(chunk.substr(0, size_t(in.gcount())));
+		}
+		return true;
+	}
+
+	std::string createHeader(const std::string & name, const std::string & serialized, uint64_t sampleSize) {
+		std::stringstream ss;
+		ss << "// HuffmanTable trained by clockUtils_trainHuffman from " << sampleSize << " Bytes" << std::endl;
+		ss << "// load it with table.deserialize(std::string(reinterpret_cast<const char *>(" << name << "), sizeof(" << name << ")))" << std::endl;
+		ss << "static const unsigned char " << name << "[] = {";
+		for (size_t i = 0; i < serialized.length(); i++) {
+			ss << ((i % 16 == 0) ? "\n\t" : " ") << "0x" << std::hex << std::setw(2) << std::setfill('0') << int(uint8_t(serialized[i])) << ((i + 1 < serialized.length()) ? "," : "");
+		}
+		ss << std::endl << "};" << std::endl;
+		return ss.str();
+	}
+
+} /* namespace */
+
+int main(int argc, char ** argv) {
+	REGISTER_VARIABLE(std::string, output, o, "table.huff", "file the trained table is written to");
+	REGISTER_VARIABLE(std::string, header, H, "", "writes a C++ header defining the table as byte array with this name instead of the binary table");
+	REGISTER_VARIABLE_ARGUMENTS(samples);
+
+	if (PARSE_COMMANDLINE() != clockUtils::ClockError::SUCCESS) {
+		std::cerr << GETLASTPARSERERROR() << std::endl;
+		return 1;
+	}
+	if (HELPSET()) {
+		std::cout << "usage: clockUtils_trainHuffman [options] samples..." << std::endl << GETHELPTEXT() << std::endl;
+		return 0;
+	}
+	if (samples.empty()) {
+		std::cerr << "no sample files given" << std::endl;
+		return 1;
+	}
+
+	clockUtils::compression::algorithm::HuffmanTable table;
+	for (const std::string & file : samples) {
+		if (!addFile(file, table)) {
+			std::cerr << "can't read " << file << std::endl;
+			return 1;
+		}
+	}
+	table.train();
+
+	const std::string serialized = table.serialize();
+	const std::string headerName = header;
+	std::ofstream out(output, std::ios::binary);
+	if (headerName.empty()) {
+		out.write(serialized.c_str(), std::streamsize(serialized.length()));
+	} else {
+		out << createHeader(headerName, serialized, table.sampleSize());
+	}
+	if (!out.good()) {
+		std::cerr << "can't write " << std::string(output) << std::endl;
+		return 1;
+	}
+
+	const uint64_t sampleSize = table.sampleSize();
+	std::cout << "trained table from " << sampleSize << " Bytes in " << samples.size() << " files";
+	if (sampleSize > 0) {
+		std::cout << ", samples compress to " << std::fixed << std::setprecision(1) << 100.0 * double(table.encodedSampleSize()) / double(sampleSize * 8) << "%";
+	}
+	std::cout << std::endl;
+
+	return 0;
+}